@@ -0,0 +1,1319 @@
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_audio_formats/juce_audio_formats.h>
+#include <juce_core/juce_core.h>
+#include "AppState.h"
+#include "AudioController.h"
+#include "PianoSound.h"
+#include "PianoVoice.h"
+#include "EarxSynthesiser.h"
+#include "OscillatorBank.h"
+#include "AdditiveSound.h"
+#include "AdditiveVoice.h"
+#include "StringModelSound.h"
+#include "StringModelVoice.h"
+#include "RoomConvolution.h"
+#include "FdnReverb.h"
+#include "InstrumentPack.h"
+#include "CompressedSample.h"
+#include "TruePeakLimiter.h"
+#include "OutputResampler.h"
+#include "WavetableSound.h"
+#include "WavetableVoice.h"
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+/**
+ * earx_bench - 音频引擎微基准测试
+ *
+ * 用法：
+ *   earx_bench [--quick] [--filter=<名称>] [--sfz=<文件>] [--out=<文件>]
+ *
+ * 结果以 JSON 输出（默认 stdout），便于在版本之间比较回归。
+ * 每个测量项重复多次，报告中位数，减少调度抖动的影响。
+ */
+
+namespace
+{
+    constexpr double kSampleRate = 48000.0;
+
+    struct BenchConfig
+    {
+        bool quick = false;
+        juce::String filter;
+        juce::File sfzFile;
+        int repeats = 5;
+    };
+
+    // juce::Time 的高精度计时在部分平台只有微秒精度，单次 noteOn 等测量需要纳秒级时钟
+    double nowSeconds()
+    {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    double median(std::vector<double> values)
+    {
+        if (values.empty())
+            return 0.0;
+        std::sort(values.begin(), values.end());
+        return values[values.size() / 2];
+    }
+
+    juce::File getDefaultSFZFile()
+    {
+       #ifdef EARX_SOURCE_DIR
+        juce::File sourceDir(EARX_SOURCE_DIR);
+       #else
+        juce::File sourceDir = juce::File::getCurrentWorkingDirectory();
+       #endif
+        return sourceDir.getChildFile("Source")
+                        .getChildFile("AccurateSalamanderGrandPianoV6.0_48khz16bit")
+                        .getChildFile("sfz")
+                        .getChildFile("Accurate-SalamanderGrandPiano_flat.Recommended_vel9_dry_flac_48_84.sfz");
+    }
+
+    // 构造钢琴合成器，与 AudioController::setupSynthesiser 的结构一致（正弦音色由 OscillatorBank 发声）
+    void setupPianoSynth(juce::Synthesiser& synth, int numVoices, PianoSound* sharedPiano)
+    {
+        synth.clearVoices();
+        synth.clearSounds();
+        synth.setCurrentPlaybackSampleRate(kSampleRate);
+        synth.addSound(sharedPiano);
+        for (int i = 0; i < numVoices; ++i)
+            synth.addVoice(new PianoVoice());
+    }
+
+    template <typename VoiceType>
+    void setupSharedSoundSynth(juce::Synthesiser& synth, int numVoices, juce::SynthesiserSound* sharedSound)
+    {
+        synth.clearVoices();
+        synth.clearSounds();
+        synth.setCurrentPlaybackSampleRate(kSampleRate);
+        synth.addSound(sharedSound);
+        for (int i = 0; i < numVoices; ++i)
+            synth.addVoice(new VoiceType());
+    }
+
+    //==============================================================================
+    class Benchmarks
+    {
+    public:
+        explicit Benchmarks(const BenchConfig& c) : config(c) {}
+
+        juce::var run()
+        {
+            auto* root = new juce::DynamicObject();
+            root->setProperty("tool", "earx_bench");
+            root->setProperty("version", JUCE_APPLICATION_VERSION_STRING);
+            root->setProperty("timestamp", juce::Time::getCurrentTime().toISO8601(true));
+            root->setProperty("os", juce::SystemStats::getOperatingSystemName());
+            root->setProperty("cpu", juce::SystemStats::getCpuModel());
+            root->setProperty("numCpus", juce::SystemStats::getNumCpus());
+            root->setProperty("sampleRate", kSampleRate);
+            root->setProperty("quick", config.quick);
+           #if JUCE_DEBUG
+            root->setProperty("buildType", "Debug");
+           #else
+            root->setProperty("buildType", "Release");
+           #endif
+
+            auto* results = new juce::DynamicObject();
+
+            if (shouldRun("sfz_parse"))        results->setProperty("sfz_parse", benchSFZParse());
+            if (shouldRun("flac_decode"))      results->setProperty("flac_decode", benchFlacDecode());
+            if (shouldRun("progressive_load")) results->setProperty("progressive_load", benchProgressiveLoad());
+            if (shouldRun("instrument_pack"))  results->setProperty("instrument_pack", benchInstrumentPack());
+
+            // 其余测试需要已加载的钢琴样本
+            piano = new PianoSound();
+            juce::SynthesiserSound::Ptr pianoHolder(piano);
+            pianoLoaded = piano->loadSFZ(config.sfzFile);
+            root->setProperty("pianoSamplesLoaded", pianoLoaded);
+
+            if (shouldRun("sample_onsets"))    results->setProperty("sample_onsets", benchSampleOnsets());
+            if (shouldRun("voice_render"))     results->setProperty("voice_render", benchVoiceRender());
+            if (shouldRun("sine_oscillator"))  results->setProperty("sine_oscillator", benchSineOscillator());
+            if (shouldRun("synth_dispatch"))   results->setProperty("synth_dispatch", benchSynthDispatch());
+            if (shouldRun("note_on_latency"))  results->setProperty("note_on_latency", benchNoteOnLatency());
+            if (shouldRun("timbre_switch"))    results->setProperty("timbre_switch", benchTimbreSwitch());
+            if (shouldRun("string_vs_piano"))  results->setProperty("string_vs_piano", benchStringVsPiano());
+            if (shouldRun("idle_block"))       results->setProperty("idle_block", benchIdleBlock());
+            if (shouldRun("room_convolution")) results->setProperty("room_convolution", benchRoomConvolution());
+            if (shouldRun("fdn_reverb"))       results->setProperty("fdn_reverb", benchFdnReverb());
+            if (shouldRun("true_peak_limiter")) results->setProperty("true_peak_limiter", benchTruePeakLimiter());
+            if (shouldRun("voice_culling"))    results->setProperty("voice_culling", benchVoiceCulling());
+            if (shouldRun("output_resampler")) results->setProperty("output_resampler", benchOutputResampler());
+            if (shouldRun("compressed_samples")) results->setProperty("compressed_samples", benchCompressedSamples());
+
+            root->setProperty("results", juce::var(results));
+            return juce::var(root);
+        }
+
+    private:
+        BenchConfig config;
+        PianoSound* piano = nullptr;
+        bool pianoLoaded = false;
+
+        bool shouldRun(const juce::String& name) const
+        {
+            return config.filter.isEmpty() || name.contains(config.filter);
+        }
+
+        //==============================================================================
+        // SFZ 解析吞吐：只解析文本，不解码音频
+        juce::var benchSFZParse()
+        {
+            const int iterations = config.quick ? 20 : 200;
+            std::vector<double> times;
+            int regionCount = 0;
+
+            for (int r = 0; r < config.repeats; ++r)
+            {
+                auto start = nowSeconds();
+                for (int i = 0; i < iterations; ++i)
+                    regionCount = PianoSound::parseSFZRegions(config.sfzFile).size();
+                times.push_back((nowSeconds() - start) / iterations);
+            }
+
+            auto seconds = median(times);
+            auto* o = new juce::DynamicObject();
+            o->setProperty("regions", regionCount);
+            o->setProperty("fileBytes", (juce::int64) config.sfzFile.getSize());
+            o->setProperty("usPerParse", seconds * 1.0e6);
+            o->setProperty("regionsPerSecond", seconds > 0.0 ? regionCount / seconds : 0.0);
+            return juce::var(o);
+        }
+
+        // FLAC 解码吞吐：每轮清空全局缓存，测量冷解码
+        juce::var benchFlacDecode()
+        {
+            auto regions = PianoSound::parseSFZRegions(config.sfzFile);
+            const int repeats = config.quick ? 1 : juce::jmax(1, config.repeats / 2);
+            std::vector<double> times;
+            juce::int64 totalFrames = 0;
+            juce::int64 totalBytes = 0;
+
+            for (int r = 0; r < repeats; ++r)
+            {
+                PianoSound::clearSampleCache();
+                totalFrames = 0;
+                totalBytes = 0;
+
+                auto start = nowSeconds();
+                for (const auto& region : regions)
+                {
+                    double sr = 0.0;
+                    if (auto buffer = PianoSound::loadSampleFile(region.sampleFile, sr))
+                    {
+                        totalFrames += buffer->getNumSamples();
+                        totalBytes += region.sampleFile.getSize();
+                    }
+                }
+                times.push_back((nowSeconds() - start));
+            }
+
+            auto seconds = median(times);
+            auto* o = new juce::DynamicObject();
+            o->setProperty("files", regions.size());
+            o->setProperty("decodedFrames", totalFrames);
+            o->setProperty("compressedBytes", totalBytes);
+            o->setProperty("seconds", seconds);
+            o->setProperty("framesPerSecond", seconds > 0.0 ? totalFrames / seconds : 0.0);
+            o->setProperty("compressedMBPerSecond", seconds > 0.0 ? totalBytes / seconds / (1024.0 * 1024.0) : 0.0);
+            return juce::var(o);
+        }
+
+        // 渐进加载：冷缓存下从开始异步加载到第一个练习键可以发声、练习音域（八度 4-6）全部可用、
+        // 全部 region 加载完成的时间；与不给优先级（按文件顺序）的加载对比
+        juce::var benchProgressiveLoad()
+        {
+            juce::Array<int> priorityKeys;
+            for (int key = 48; key < 84; ++key)
+                priorityKeys.add(key);
+            const int firstKey = 60;
+            priorityKeys.removeFirstMatchingValue(firstKey);
+            priorityKeys.insert(0, firstKey);
+
+            auto measure = [this, &priorityKeys, firstKey](bool prioritised)
+            {
+                PianoSound::clearSampleCache();
+                juce::SynthesiserSound::Ptr sound(new PianoSound());
+                auto* loading = static_cast<PianoSound*>(sound.get());
+                juce::WaitableEvent finished;
+                double firstNoteSeconds = -1.0, rangeSeconds = -1.0, totalSeconds = -1.0;
+
+                const auto start = nowSeconds();
+                loading->loadSFZAsync(config.sfzFile, [&](bool completed, int, int)
+                {
+                    const double now = nowSeconds() - start;
+                    if (firstNoteSeconds < 0.0 && loading->isNoteLoaded(firstKey))
+                        firstNoteSeconds = now;
+                    if (rangeSeconds < 0.0 && std::all_of(priorityKeys.begin(), priorityKeys.end(),
+                                                          [loading](int key) { return loading->isNoteLoaded(key); }))
+                        rangeSeconds = now;
+                    if (completed)
+                    {
+                        totalSeconds = now;
+                        finished.signal();
+                    }
+                }, prioritised ? priorityKeys : juce::Array<int>());
+                finished.wait(120000);
+
+                auto* o = new juce::DynamicObject();
+                o->setProperty("prioritised", prioritised);
+                o->setProperty("regions", loading->getNumLoadedRegions());
+                o->setProperty("msToFirstNote", firstNoteSeconds * 1000.0);
+                o->setProperty("msToOctaves4to6", rangeSeconds * 1000.0);
+                o->setProperty("msToFullLoad", totalSeconds * 1000.0);
+                return juce::var(o);
+            };
+
+            juce::Array<juce::var> runs;
+            runs.add(measure(false));
+            runs.add(measure(true));
+            PianoSound::clearSampleCache();
+            return runs;
+        }
+
+        // 打包乐器文件：冷缓存下同步加载全部 region 的时间与文件大小，SFZ + 样本目录与两种载荷编码对比
+        juce::var benchInstrumentPack()
+        {
+            juce::TemporaryFile encodedPack(InstrumentPack::FILE_EXTENSION), rawPack(InstrumentPack::FILE_EXTENSION);
+            juce::String error;
+            if (!InstrumentPack::write(config.sfzFile, encodedPack.getFile(), InstrumentPack::encodingFile, error)
+                || !InstrumentPack::write(config.sfzFile, rawPack.getFile(), InstrumentPack::encodingFloat32, error))
+            {
+                auto* o = new juce::DynamicObject();
+                o->setProperty("error", error);
+                return juce::var(o);
+            }
+
+            juce::int64 sfzBytes = config.sfzFile.getSize();
+            juce::Array<juce::File> sampleFiles;
+            for (const auto& region : PianoSound::parseSFZRegions(config.sfzFile))
+                if (sampleFiles.addIfNotAlreadyThere(region.sampleFile))
+                    sfzBytes += region.sampleFile.getSize();
+
+            auto measure = [this](const juce::String& name, const juce::File& file, juce::int64 bytes, int filesOpened)
+            {
+                std::vector<double> times;
+                for (int r = 0; r < (config.quick ? 1 : config.repeats); ++r)
+                {
+                    PianoSound::clearSampleCache();
+                    juce::SynthesiserSound::Ptr sound(new PianoSound());
+                    const auto start = nowSeconds();
+                    static_cast<PianoSound*>(sound.get())->loadSFZ(file);
+                    times.push_back(nowSeconds() - start);
+                }
+
+                auto* o = new juce::DynamicObject();
+                o->setProperty("source", name);
+                o->setProperty("filesOpened", filesOpened);
+                o->setProperty("bytes", bytes);
+                o->setProperty("msToLoad", median(times) * 1000.0);
+                return juce::var(o);
+            };
+
+            juce::Array<juce::var> runs;
+            runs.add(measure("sfz", config.sfzFile, sfzBytes, sampleFiles.size() + 1));
+            runs.add(measure("pack_encoded", encodedPack.getFile(), encodedPack.getFile().getSize(), 1));
+            runs.add(measure("pack_float32", rawPack.getFile(), rawPack.getFile().getSize(), 1));
+            PianoSound::clearSampleCache();
+            return runs;
+        }
+
+        // 加载时的样本分析：各键从样本开头到起音的时长（裁切前的起音延迟）与从播放起点到起音的时长，
+        // 以及尾部裁切节省的内存
+        juce::var benchSampleOnsets()
+        {
+            auto* o = new juce::DynamicObject();
+            if (!pianoLoaded)
+                return juce::var(o);
+
+            std::vector<double> fileOnsetMs, latencyMs;
+            for (int note = 21; note <= 108; ++note)
+            {
+                if (piano->getSampleForNote(note) == nullptr)
+                    continue;
+                const double sampleRate = piano->getSampleRateForMidiNote(note);
+                fileOnsetMs.push_back(piano->getOnsetForMidiNote(note) * 1000.0 / sampleRate);
+                latencyMs.push_back(piano->getOnsetLatencyMsForMidiNote(note));
+            }
+
+            juce::int64 untrimmedBytes = 0;
+            juce::StringArray files;
+            juce::AudioFormatManager formatManager;
+            formatManager.registerBasicFormats();
+            for (const auto& region : PianoSound::parseSFZRegions(config.sfzFile))
+            {
+                if (!files.addIfNotAlreadyThere(region.sampleFile.getFullPathName()))
+                    continue;
+                if (std::unique_ptr<juce::AudioFormatReader> reader { formatManager.createReaderFor(region.sampleFile) })
+                    untrimmedBytes += reader->lengthInSamples * (juce::int64) reader->numChannels * (juce::int64) sizeof(float);
+            }
+
+            auto range = [](const std::vector<double>& values)
+            {
+                return values.empty() ? 0.0 : *std::max_element(values.begin(), values.end()) - *std::min_element(values.begin(), values.end());
+            };
+            o->setProperty("keys", (int) latencyMs.size());
+            o->setProperty("fileOnsetMedianMs", median(fileOnsetMs));
+            o->setProperty("fileOnsetSpreadMs", range(fileOnsetMs));
+            o->setProperty("onsetLatencyMedianMs", median(latencyMs));
+            o->setProperty("onsetLatencySpreadMs", range(latencyMs));
+            o->setProperty("untrimmedBytes", untrimmedBytes);
+            o->setProperty("trimmedBytes", (juce::int64) piano->getSampleMemoryBytes());
+            return juce::var(o);
+        }
+
+        //==============================================================================
+        // 单次渲染测量：numVoices 个同时发声的音符，按 blockSize 分块渲染 audioSeconds 秒
+        double measureRender(juce::Synthesiser& synth, int numVoices, int blockSize, double audioSeconds)
+        {
+            synth.allNotesOff(0, false);
+            for (int v = 0; v < numVoices; ++v)
+                synth.noteOn(1, 40 + v, 0.8f);
+
+            juce::AudioBuffer<float> buffer(2, blockSize);
+            juce::MidiBuffer midi;
+            const int numBlocks = juce::jmax(1, (int) (audioSeconds * kSampleRate / blockSize));
+
+            auto start = nowSeconds();
+            for (int b = 0; b < numBlocks; ++b)
+            {
+                buffer.clear();
+                synth.renderNextBlock(buffer, midi, 0, blockSize);
+            }
+            auto seconds = (nowSeconds() - start);
+
+            return seconds / ((double) numBlocks * blockSize); // 每个输出样本的耗时
+        }
+
+        double measureBankRender(OscillatorBank& bank, int numVoices, int blockSize, double audioSeconds)
+        {
+            bank.reset();
+            for (int v = 0; v < numVoices; ++v)
+                bank.noteOn(40 + v, 0.8f);
+
+            juce::AudioBuffer<float> buffer(2, blockSize);
+            juce::MidiBuffer midi;
+            const int numBlocks = juce::jmax(1, (int) (audioSeconds * kSampleRate / blockSize));
+
+            auto start = nowSeconds();
+            for (int b = 0; b < numBlocks; ++b)
+            {
+                buffer.clear();
+                bank.renderNextBlock(buffer, midi, 0, blockSize);
+            }
+            auto seconds = (nowSeconds() - start);
+
+            return seconds / ((double) numBlocks * blockSize);
+        }
+
+        // PianoVoice / WavetableVoice / AdditiveVoice / StringModelVoice / OscillatorBank 渲染开销：音色 × 复音数 × 块大小
+        juce::var benchVoiceRender()
+        {
+            const int voiceCounts[] = { 1, 4, 8, 16, 32 };
+            const int blockSizes[]  = { 64, 256, 512, 1024 };
+            const double audioSeconds = config.quick ? 0.25 : 1.0;
+            juce::Array<juce::var> rows;
+
+            // 波表音色以锯齿波为代表（各波形渲染开销相同）；加法合成使用默认的 12 分音表
+            juce::SynthesiserSound::Ptr wavetable(new WavetableSound());
+            juce::SynthesiserSound::Ptr additive(new AdditiveSound());
+            juce::SynthesiserSound::Ptr stringModel(new StringModelSound());
+
+            for (auto timbre : { AppState::timbreSine, AppState::timbrePiano, AppState::timbreSaw, AppState::timbreAdditive,
+                                 AppState::timbreString })
+            {
+                if (timbre == AppState::timbrePiano && !pianoLoaded)
+                    continue;
+
+                const char* timbreName = timbre == AppState::timbrePiano ? "piano"
+                                       : timbre == AppState::timbreSaw ? "saw"
+                                       : timbre == AppState::timbreAdditive ? "additive"
+                                       : timbre == AppState::timbreString ? "string" : "sine";
+
+                for (int numVoices : voiceCounts)
+                {
+                    EarxSynthesiser synth;
+                    auto bank = std::make_unique<OscillatorBank>();
+                    if (timbre == AppState::timbrePiano)
+                    {
+                        setupPianoSynth(synth, numVoices, piano);
+                    }
+                    else if (timbre == AppState::timbreSaw)
+                    {
+                        setupSharedSoundSynth<WavetableVoice>(synth, numVoices, wavetable.get());
+                    }
+                    else if (timbre == AppState::timbreAdditive)
+                    {
+                        setupSharedSoundSynth<AdditiveVoice>(synth, numVoices, additive.get());
+                    }
+                    else if (timbre == AppState::timbreString)
+                    {
+                        setupSharedSoundSynth<StringModelVoice>(synth, numVoices, stringModel.get());
+                    }
+                    else
+                    {
+                        bank->prepare(kSampleRate);
+                        bank->setPolyphony(numVoices);
+                    }
+
+                    for (int blockSize : blockSizes)
+                    {
+                        std::vector<double> times;
+                        for (int r = 0; r < config.repeats; ++r)
+                            times.push_back(timbre == AppState::timbreSine ? measureBankRender(*bank, numVoices, blockSize, audioSeconds)
+                                                                           : measureRender(synth, numVoices, blockSize, audioSeconds));
+
+                        auto perSample = median(times);
+                        auto* o = new juce::DynamicObject();
+                        o->setProperty("timbre", timbreName);
+                        o->setProperty("voices", numVoices);
+                        o->setProperty("blockSize", blockSize);
+                        o->setProperty("nsPerSample", perSample * 1.0e9);
+                        o->setProperty("nsPerVoiceSample", perSample * 1.0e9 / numVoices);
+                        // 占用一个块实时预算的百分比
+                        o->setProperty("cpuPercentOfRealtime", perSample * kSampleRate * 100.0);
+                        rows.add(juce::var(o));
+                    }
+
+                    // 避免 synth 析构时删除共享的 Sound
+                    synth.clearSounds();
+                }
+            }
+
+            return rows;
+        }
+
+        // 原 SineVoice 内核的标量参考：每 Voice 每样本一次 std::sin，逐声道 addSample
+        double measureScalarSineReference(int numVoices, int blockSize, double audioSeconds)
+        {
+            std::vector<double> angles((size_t) numVoices, 0.0), deltas((size_t) numVoices);
+            for (int v = 0; v < numVoices; ++v)
+                deltas[(size_t) v] = juce::MathConstants<double>::twoPi * juce::MidiMessage::getMidiNoteInHertz(40 + v) / kSampleRate;
+
+            juce::AudioBuffer<float> buffer(2, blockSize);
+            const int numBlocks = juce::jmax(1, (int) (audioSeconds * kSampleRate / blockSize));
+            const float localLevel = 0.8f * 0.11f;
+
+            auto start = nowSeconds();
+            for (int b = 0; b < numBlocks; ++b)
+            {
+                buffer.clear();
+                for (int v = 0; v < numVoices; ++v)
+                {
+                    auto& angle = angles[(size_t) v];
+                    for (int i = 0; i < blockSize; ++i)
+                    {
+                        const float sample = (float) std::sin(angle) * localLevel;
+                        for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+                            buffer.addSample(ch, i, sample);
+                        angle += deltas[(size_t) v];
+                    }
+                }
+            }
+            auto seconds = (nowSeconds() - start);
+
+            return seconds / ((double) numBlocks * blockSize);
+        }
+
+        // 正弦振荡器：OscillatorBank（定点相位 + SIMD 正交旋转）与标量参考的每 Voice 开销对比
+        juce::var benchSineOscillator()
+        {
+            // 目标：每 Voice 开销低于标量参考的 1/10；练习中常见的是 1 - 4 个同时发声的音符，单独汇总
+            const int voiceCounts[] = { 1, 2, 3, 4, 8, 32, 64 };
+            const int typicalMaxVoices = 4;
+            const double targetSpeedup = 10.0;
+            const int blockSize = 256;
+            const double audioSeconds = config.quick ? 0.25 : 1.0;
+            juce::Array<juce::var> rows;
+            double typicalMin = 0.0, typicalLogSum = 0.0;
+            int typicalCount = 0;
+
+            for (int numVoices : voiceCounts)
+            {
+                auto bank = std::make_unique<OscillatorBank>();
+                bank->prepare(kSampleRate);
+                bank->setPolyphony(numVoices);
+
+                std::vector<double> bankTimes, referenceTimes;
+                for (int r = 0; r < config.repeats; ++r)
+                {
+                    bankTimes.push_back(measureBankRender(*bank, numVoices, blockSize, audioSeconds));
+                    referenceTimes.push_back(measureScalarSineReference(numVoices, blockSize, audioSeconds));
+                }
+
+                const double bankNs = median(bankTimes) * 1.0e9 / numVoices;
+                const double referenceNs = median(referenceTimes) * 1.0e9 / numVoices;
+                const double speedup = bankNs > 0.0 ? referenceNs / bankNs : 0.0;
+                auto* o = new juce::DynamicObject();
+                o->setProperty("voices", numVoices);
+                o->setProperty("blockSize", blockSize);
+                o->setProperty("bankNsPerVoiceSample", bankNs);
+                o->setProperty("scalarReferenceNsPerVoiceSample", referenceNs);
+                o->setProperty("speedup", speedup);
+                rows.add(juce::var(o));
+
+                if (numVoices <= typicalMaxVoices)
+                {
+                    typicalMin = typicalCount == 0 ? speedup : juce::jmin(typicalMin, speedup);
+                    typicalLogSum += std::log(juce::jmax(speedup, 1.0e-9));
+                    ++typicalCount;
+                }
+            }
+
+            auto* typical = new juce::DynamicObject();
+            typical->setProperty("voices", "1-" + juce::String(typicalMaxVoices));
+            typical->setProperty("targetSpeedup", targetSpeedup);
+            typical->setProperty("minSpeedup", typicalMin);
+            typical->setProperty("geomeanSpeedup", typicalCount > 0 ? std::exp(typicalLogSum / typicalCount) : 0.0);
+            typical->setProperty("meetsTarget", typicalCount > 0 && typicalMin >= targetSpeedup);
+
+            auto* result = new juce::DynamicObject();
+            result->setProperty("typical", juce::var(typical));
+            result->setProperty("rows", rows);
+            return juce::var(result);
+        }
+
+        // 调度开销：空闲 voice 遍历与 noteOn/noteOff 分发（钢琴合成器 vs 正弦 OscillatorBank）
+        juce::var benchSynthDispatch()
+        {
+            const int voiceCounts[] = { 8, 16, 32, 64 };
+            const int blockSize = 256;
+            const int numBlocks = config.quick ? 500 : 5000;
+            const int numEvents = config.quick ? 2000 : 20000;
+            juce::Array<juce::var> rows;
+
+            for (bool isBank : { false, true })
+            {
+                for (int numVoices : voiceCounts)
+                {
+                    EarxSynthesiser synth;
+                    auto bank = std::make_unique<OscillatorBank>();
+                    if (isBank)
+                    {
+                        bank->prepare(kSampleRate);
+                        bank->setPolyphony(numVoices);
+                    }
+                    else
+                    {
+                        setupPianoSynth(synth, numVoices, piano);
+                    }
+
+                    juce::AudioBuffer<float> buffer(2, blockSize);
+                    juce::MidiBuffer midi;
+                    std::vector<double> idleTimes, eventTimes;
+
+                    for (int r = 0; r < config.repeats; ++r)
+                    {
+                        // 所有 voice 空闲时的每块开销
+                        auto start = nowSeconds();
+                        for (int b = 0; b < numBlocks; ++b)
+                        {
+                            if (isBank)
+                                bank->renderNextBlock(buffer, midi, 0, blockSize);
+                            else
+                                synth.renderNextBlock(buffer, midi, 0, blockSize);
+                        }
+                        idleTimes.push_back((nowSeconds() - start) / numBlocks);
+
+                        // noteOn + noteOff（不渲染）的分发开销
+                        start = nowSeconds();
+                        for (int e = 0; e < numEvents; ++e)
+                        {
+                            const int note = 40 + (e % 32);
+                            if (isBank)
+                            {
+                                bank->noteOn(note, 0.8f);
+                                bank->allNotesOff(false);
+                            }
+                            else
+                            {
+                                synth.noteOn(1, note, 0.8f);
+                                synth.noteOff(1, note, 0.0f, false);
+                            }
+                        }
+                        eventTimes.push_back((nowSeconds() - start) / numEvents);
+                        bank->reset();
+                    }
+
+                    if (!isBank)
+                        synth.clearSounds();
+
+                    auto* o = new juce::DynamicObject();
+                    o->setProperty("engine", isBank ? "oscillator_bank" : "synthesiser");
+                    o->setProperty("voices", numVoices);
+                    o->setProperty("idleBlockNs", median(idleTimes) * 1.0e9);
+                    o->setProperty("noteOnOffPairNs", median(eventTimes) * 1.0e9);
+                    rows.add(juce::var(o));
+                }
+            }
+
+            return rows;
+        }
+
+        //==============================================================================
+        // 等待 AudioController 的异步钢琴加载完成
+        static bool waitForPiano(AudioController& controller, int timeoutMs)
+        {
+            auto deadline = juce::Time::getMillisecondCounter() + (juce::uint32) timeoutMs;
+            while (!controller.arePianoSamplesLoaded())
+            {
+                if (juce::Time::getMillisecondCounter() > deadline)
+                    return false;
+                juce::Thread::sleep(10);
+            }
+            return true;
+        }
+
+        // 等待 AudioController 的后台响度测量完成，避免测量线程与被测渲染争用 CPU
+        static bool waitForLoudness(AudioController& controller, int timeoutMs)
+        {
+            auto deadline = juce::Time::getMillisecondCounter() + (juce::uint32) timeoutMs;
+            while (controller.isLoudnessMeasurementPending())
+            {
+                if (juce::Time::getMillisecondCounter() > deadline)
+                    return false;
+                juce::Thread::sleep(10);
+            }
+            return true;
+        }
+
+        // 音符起音延迟：从 playNote 到输出首次超过 -60 dB 的样本数，以及 noteOn 调用本身的耗时
+        juce::var benchNoteOnLatency()
+        {
+            juce::Array<juce::var> rows;
+            const int blockSize = 256;
+            const float threshold = juce::Decibels::decibelsToGain(-60.0f);
+            const int trials = config.quick ? 8 : 32;
+
+            for (auto timbre : { AppState::timbreSine, AppState::timbrePiano, AppState::timbreSaw })
+            {
+                AppState state;
+                state.audio.timbre = timbre;
+                AudioController controller(&state);
+                controller.initialize(kSampleRate);
+                waitForLoudness(controller, 30000);
+
+                if (timbre == AppState::timbrePiano && !waitForPiano(controller, 30000))
+                    continue;
+
+                juce::AudioBuffer<float> buffer(2, blockSize);
+                juce::MidiBuffer midi;
+                std::vector<double> latencySamples, callTimes;
+
+                for (int t = 0; t < trials; ++t)
+                {
+                    const int note = 48 + (t % 36);
+
+                    auto start = nowSeconds();
+                    controller.playNote(note, 0.8f);
+                    callTimes.push_back((nowSeconds() - start));
+
+                    int firstAudible = -1;
+                    for (int b = 0; b < 64 && firstAudible < 0; ++b)
+                    {
+                        buffer.clear();
+                        controller.renderNextBlock(buffer, midi, 0, blockSize);
+                        for (int i = 0; i < blockSize; ++i)
+                        {
+                            if (std::abs(buffer.getSample(0, i)) > threshold)
+                            {
+                                firstAudible = b * blockSize + i;
+                                break;
+                            }
+                        }
+                    }
+
+                    if (firstAudible >= 0)
+                        latencySamples.push_back((double) firstAudible);
+
+                    controller.stopAllNotes();
+                    for (int b = 0; b < 200; ++b)
+                    {
+                        buffer.clear();
+                        controller.renderNextBlock(buffer, midi, 0, blockSize);
+                    }
+                }
+
+                std::sort(latencySamples.begin(), latencySamples.end());
+                auto* o = new juce::DynamicObject();
+                o->setProperty("timbre", timbre == AppState::timbrePiano ? "piano"
+                                       : timbre == AppState::timbreSaw ? "saw" : "sine");
+                o->setProperty("trials", trials);
+                o->setProperty("medianLatencySamples", median(latencySamples));
+                o->setProperty("medianLatencyMs", median(latencySamples) * 1000.0 / kSampleRate);
+                o->setProperty("maxLatencyMs", latencySamples.empty() ? 0.0 : latencySamples.back() * 1000.0 / kSampleRate);
+                o->setProperty("noteOnCallNs", median(callTimes) * 1.0e9);
+                rows.add(juce::var(o));
+            }
+
+            return rows;
+        }
+
+        // 音色切换开销：淡出 + 切换 + 淡入的总块数、音频时长，以及最慢的一个块
+        // 弦模型与采样钢琴的内存 / CPU 对比：默认复音数全部发声，256 样本块
+        // 钢琴内存为解码后的全部样本，弦模型为每个 Voice 的两条延迟线
+        juce::var benchStringVsPiano()
+        {
+            const int numVoices = AudioController::DEFAULT_POLYPHONY;
+            const int blockSize = 256;
+            const double audioSeconds = config.quick ? 0.25 : 1.0;
+            juce::SynthesiserSound::Ptr stringModel(new StringModelSound());
+            juce::Array<juce::var> rows;
+
+            for (bool isString : { false, true })
+            {
+                if (!isString && !pianoLoaded)
+                    continue;
+
+                EarxSynthesiser synth;
+                size_t memoryBytes = 0;
+                if (isString)
+                {
+                    setupSharedSoundSynth<StringModelVoice>(synth, numVoices, stringModel.get());
+                    memoryBytes = sizeof(StringModelSound);
+                    for (int i = 0; i < synth.getNumVoices(); ++i)
+                        memoryBytes += sizeof(StringModelVoice) + static_cast<StringModelVoice*>(synth.getVoice(i))->getMemoryBytes();
+                }
+                else
+                {
+                    setupPianoSynth(synth, numVoices, piano);
+                    memoryBytes = piano->getSampleMemoryBytes() + (size_t) numVoices * sizeof(PianoVoice);
+                }
+
+                std::vector<double> times;
+                for (int r = 0; r < config.repeats; ++r)
+                    times.push_back(measureRender(synth, numVoices, blockSize, audioSeconds));
+
+                const auto perSample = median(times);
+                auto* o = new juce::DynamicObject();
+                o->setProperty("timbre", isString ? "string" : "piano");
+                o->setProperty("voices", numVoices);
+                o->setProperty("memoryBytes", (juce::int64) memoryBytes);
+                o->setProperty("memoryMB", memoryBytes / (1024.0 * 1024.0));
+                o->setProperty("nsPerVoiceSample", perSample * 1.0e9 / numVoices);
+                o->setProperty("cpuPercentOfRealtime", perSample * kSampleRate * 100.0);
+                rows.add(juce::var(o));
+
+                // 避免 synth 析构时删除共享的 Sound
+                synth.clearSounds();
+            }
+
+            return rows;
+        }
+
+        // 无音符发声时每块的开销：进入空闲前（完整经过合成器）与空闲快速路径
+        juce::var benchIdleBlock()
+        {
+            juce::Array<juce::var> rows;
+            for (auto timbre : { AppState::timbreSine, AppState::timbrePiano })
+            {
+                AppState state;
+                state.audio.timbre = timbre;
+                AudioController controller(&state);
+                controller.initialize(kSampleRate);
+                waitForLoudness(controller, 30000);
+
+                const int blockSize = 256;
+                const int blocks = config.quick ? 2000 : 20000;
+                juce::AudioBuffer<float> buffer(2, blockSize);
+                juce::MidiBuffer midi;
+                std::vector<double> activeTimes, idleTimes;
+
+                for (int r = 0; r < config.repeats; ++r)
+                {
+                    // 每轮先发一个短音再等它结束，前半段测正常路径，进入空闲后测快速路径
+                    controller.scheduleNote(69, 0.8f, 0, blockSize);
+                    double activeTotal = 0.0, idleTotal = 0.0;
+                    int activeBlocks = 0, idleBlocks = 0;
+                    for (int b = 0; b < blocks; ++b)
+                    {
+                        const bool wasIdle = controller.getIdleStats().idle;
+                        buffer.clear();
+                        auto start = nowSeconds();
+                        controller.renderNextBlock(buffer, midi, 0, blockSize);
+                        auto seconds = nowSeconds() - start;
+                        (wasIdle ? idleTotal : activeTotal) += seconds;
+                        ++(wasIdle ? idleBlocks : activeBlocks);
+                    }
+                    if (activeBlocks > 0) activeTimes.push_back(activeTotal / activeBlocks);
+                    if (idleBlocks > 0)   idleTimes.push_back(idleTotal / idleBlocks);
+                }
+
+                const auto stats = controller.getIdleStats();
+                auto* o = new juce::DynamicObject();
+                o->setProperty("timbre", timbre == AppState::timbrePiano ? "piano" : "sine");
+                o->setProperty("blockSize", blockSize);
+                o->setProperty("beforeIdleNsPerBlock", activeTimes.empty() ? 0.0 : median(activeTimes) * 1.0e9);
+                o->setProperty("idleNsPerBlock", idleTimes.empty() ? 0.0 : median(idleTimes) * 1.0e9);
+                o->setProperty("idleFraction", (double) stats.idleSamples / (double) juce::jmax((juce::int64) 1, stats.totalSamples));
+                rows.add(juce::var(o));
+            }
+            return rows;
+        }
+
+        // 房间卷积的总线开销：内置脉冲响应，单独处理一个持续的立体声信号
+        juce::var benchRoomConvolution()
+        {
+            juce::Array<juce::var> rows;
+            for (int blockSize : { 64, 256, 512 })
+            {
+                RoomConvolution room;
+                room.prepare(kSampleRate, 2);
+                room.setWetLevel(1.0f);
+                juce::Thread::sleep(200); // 等待后台线程准备好脉冲响应
+
+                juce::AudioBuffer<float> buffer(2, blockSize);
+                juce::Random random(1);
+                const int blocks = (int) ((config.quick ? 0.5 : 2.0) * kSampleRate / blockSize);
+                std::vector<double> times;
+                for (int r = 0; r < config.repeats; ++r)
+                {
+                    auto start = nowSeconds();
+                    for (int b = 0; b < blocks; ++b)
+                    {
+                        for (int ch = 0; ch < 2; ++ch)
+                            for (int i = 0; i < blockSize; ++i)
+                                buffer.setSample(ch, i, random.nextFloat() * 0.1f - 0.05f);
+                        room.process(buffer, 0, blockSize);
+                    }
+                    times.push_back((nowSeconds() - start) / ((double) blocks * blockSize));
+                }
+
+                auto* o = new juce::DynamicObject();
+                o->setProperty("blockSize", blockSize);
+                o->setProperty("irSamples", room.getTailSamples());
+                o->setProperty("nsPerSample", median(times) * 1.0e9);
+                o->setProperty("cpuPercentOfRealtime", median(times) * kSampleRate * 100.0);
+                rows.add(juce::var(o));
+            }
+            return rows;
+        }
+
+        // FDN 混响的总线开销（与 room_convolution 同样的输入），最大房间
+        juce::var benchFdnReverb()
+        {
+            juce::Array<juce::var> rows;
+            for (int blockSize : { 64, 256, 512 })
+            {
+                FdnReverb reverb;
+                reverb.prepare(kSampleRate);
+                reverb.setRoomSize(1.0f);
+                reverb.setMix(1.0f);
+
+                juce::AudioBuffer<float> buffer(2, blockSize);
+                juce::Random random(1);
+                const int blocks = (int) ((config.quick ? 0.5 : 2.0) * kSampleRate / blockSize);
+                std::vector<double> times;
+                for (int r = 0; r < config.repeats; ++r)
+                {
+                    auto start = nowSeconds();
+                    for (int b = 0; b < blocks; ++b)
+                    {
+                        for (int ch = 0; ch < 2; ++ch)
+                            for (int i = 0; i < blockSize; ++i)
+                                buffer.setSample(ch, i, random.nextFloat() * 0.1f - 0.05f);
+                        reverb.process(buffer, 0, blockSize);
+                    }
+                    times.push_back((nowSeconds() - start) / ((double) blocks * blockSize));
+                }
+
+                auto* o = new juce::DynamicObject();
+                o->setProperty("blockSize", blockSize);
+                o->setProperty("lines", FdnReverb::NUM_LINES);
+                o->setProperty("simdLanes", FdnReverb::NUM_LANES);
+                o->setProperty("nsPerSample", median(times) * 1.0e9);
+                o->setProperty("cpuPercentOfRealtime", median(times) * kSampleRate * 100.0);
+                rows.add(juce::var(o));
+            }
+            return rows;
+        }
+
+        // 真峰值限幅器的总线开销：低电平输入（跳过插值）与持续超限的输入，默认预读
+        juce::var benchTruePeakLimiter()
+        {
+            juce::Array<juce::var> rows;
+            for (float amplitude : { 0.1f, 1.5f })
+            {
+                TruePeakLimiter limiter;
+                limiter.prepare(kSampleRate);
+
+                const int blockSize = 256;
+                juce::AudioBuffer<float> buffer(2, blockSize);
+                juce::Random random(1);
+                const int blocks = (int) ((config.quick ? 0.5 : 2.0) * kSampleRate / blockSize);
+                std::vector<double> times;
+                for (int r = 0; r < config.repeats; ++r)
+                {
+                    auto start = nowSeconds();
+                    for (int b = 0; b < blocks; ++b)
+                    {
+                        for (int ch = 0; ch < 2; ++ch)
+                            for (int i = 0; i < blockSize; ++i)
+                                buffer.setSample(ch, i, (random.nextFloat() * 2.0f - 1.0f) * amplitude);
+                        limiter.process(buffer, 0, blockSize);
+                    }
+                    times.push_back((nowSeconds() - start) / ((double) blocks * blockSize));
+                }
+
+                auto* o = new juce::DynamicObject();
+                o->setProperty("inputPeak", amplitude);
+                o->setProperty("latencySamples", limiter.getLatencySamples());
+                o->setProperty("maxReductionDb", limiter.getStats().maxReductionDb);
+                o->setProperty("nsPerSample", median(times) * 1.0e9);
+                o->setProperty("cpuPercentOfRealtime", median(times) * kSampleRate * 100.0);
+                rows.add(juce::var(o));
+            }
+            return rows;
+        }
+
+        // 可闻下限剔除：快速自动播放（每秒 8 个音符，力度 0.3 - 0.8，各按住 6 秒）下不同下限的平均活动 Voice 数与渲染开销；
+        // 下限按默认主音量换算到 Voice 输出端，与 AudioController 一致
+        juce::var benchVoiceCulling()
+        {
+            juce::Array<juce::var> rows;
+            if (!pianoLoaded)
+                return rows;
+
+            const int blockSize = 256;
+            const int notesPerSecond = 8;
+            const double holdSeconds = 6.0;
+            const int blocks = (int) ((config.quick ? 4.0 : 12.0) * kSampleRate / blockSize);
+            const float masterVolume = AppState::AudioState().masterVolume;
+
+            for (float floorDb : { AudioController::MIN_CULLING_FLOOR_DB, -70.0f, -60.0f })
+            {
+                std::vector<double> times;
+                double activeVoiceBlocks = 0.0;
+                juce::int64 stolen = 0;
+
+                for (int r = 0; r < config.repeats; ++r)
+                {
+                    EarxSynthesiser synth;
+                    setupPianoSynth(synth, AudioController::MAX_POLYPHONY / 2, piano);
+                    for (int v = 0; v < synth.getNumVoices(); ++v)
+                        static_cast<EarxVoice*>(synth.getVoice(v))->setAudibilityFloor(
+                            juce::Decibels::decibelsToGain(floorDb, AudioController::MIN_CULLING_FLOOR_DB) / masterVolume);
+
+                    juce::AudioBuffer<float> buffer(2, blockSize);
+                    juce::MidiBuffer midi;
+                    juce::Random random(7);
+                    std::vector<std::pair<juce::int64, int>> pendingOffs;
+                    juce::int64 nextNoteAt = 0;
+                    double seconds = 0.0;
+                    activeVoiceBlocks = 0.0;
+
+                    for (int b = 0; b < blocks; ++b)
+                    {
+                        const juce::int64 now = (juce::int64) b * blockSize;
+                        for (auto it = pendingOffs.begin(); it != pendingOffs.end();)
+                        {
+                            if (it->first <= now)
+                            {
+                                synth.noteOff(1, it->second, 0.0f, true);
+                                it = pendingOffs.erase(it);
+                            }
+                            else
+                                ++it;
+                        }
+                        if (now >= nextNoteAt)
+                        {
+                            const int note = 48 + random.nextInt(37);
+                            synth.noteOn(1, note, 0.3f + 0.5f * random.nextFloat());
+                            pendingOffs.emplace_back(now + (juce::int64) (holdSeconds * kSampleRate), note);
+                            nextNoteAt += (juce::int64) (kSampleRate / notesPerSecond);
+                        }
+
+                        buffer.clear();
+                        auto start = nowSeconds();
+                        synth.renderNextBlock(buffer, midi, 0, blockSize);
+                        seconds += nowSeconds() - start;
+                        activeVoiceBlocks += synth.getNumActiveVoices();
+                    }
+
+                    times.push_back(seconds / ((double) blocks * blockSize));
+                    stolen = synth.getNumVoicesStolen();
+                }
+
+                auto* o = new juce::DynamicObject();
+                o->setProperty("floorDb", floorDb);
+                o->setProperty("masterVolume", masterVolume);
+                o->setProperty("averageActiveVoices", activeVoiceBlocks / blocks);
+                o->setProperty("voicesStolen", stolen);
+                o->setProperty("nsPerSample", median(times) * 1.0e9);
+                o->setProperty("cpuPercentOfRealtime", median(times) * kSampleRate * 100.0);
+                rows.add(juce::var(o));
+            }
+            return rows;
+        }
+
+        // 输出采样率转换：内部 48 kHz 转到常见设备采样率的开销与精度（1 kHz / 15 kHz 正弦与理想输出之比）
+        juce::var benchOutputResampler()
+        {
+            juce::Array<juce::var> rows;
+            for (double deviceRate : { 44100.0, 96000.0 })
+            {
+                const int blockSize = 256;
+                const int blocks = (int) ((config.quick ? 0.5 : 2.0) * deviceRate / blockSize);
+                juce::AudioBuffer<float> input(2, OutputResampler::MAX_OUTPUT_BLOCK * 4);
+                juce::AudioBuffer<float> output(2, blockSize);
+                std::vector<double> times;
+                for (int r = 0; r < config.repeats; ++r)
+                {
+                    OutputResampler resampler;
+                    resampler.prepare(AudioController::INTERNAL_SAMPLE_RATE, deviceRate);
+                    juce::Random random(3);
+                    double seconds = 0.0;
+                    for (int b = 0; b < blocks; ++b)
+                    {
+                        const int needed = resampler.getInputSamplesNeeded(blockSize);
+                        for (int ch = 0; ch < 2; ++ch)
+                            for (int i = 0; i < needed; ++i)
+                                input.setSample(ch, i, random.nextFloat() * 2.0f - 1.0f);
+                        auto start = nowSeconds();
+                        resampler.process(input, needed, output, 0, blockSize);
+                        seconds += nowSeconds() - start;
+                    }
+                    times.push_back(seconds / ((double) blocks * blockSize));
+                }
+
+                // 输出第 m 个样本对应输入时刻 m × 输入/输出采样率，与理想正弦逐点比较
+                auto measureSnr = [deviceRate, blockSize, &input, &output](double frequency)
+                {
+                    OutputResampler resampler;
+                    resampler.prepare(AudioController::INTERNAL_SAMPLE_RATE, deviceRate);
+                    juce::int64 inputPosition = 0, outputPosition = 0;
+                    double signal = 0.0, noise = 0.0;
+                    for (int b = 0; b < (int) (deviceRate / blockSize); ++b)
+                    {
+                        const int needed = resampler.getInputSamplesNeeded(blockSize);
+                        for (int i = 0; i < needed; ++i)
+                        {
+                            const float x = (float) std::sin(juce::MathConstants<double>::twoPi * frequency * (double) (inputPosition + i)
+                                                             / AudioController::INTERNAL_SAMPLE_RATE);
+                            input.setSample(0, i, x);
+                            input.setSample(1, i, x);
+                        }
+                        inputPosition += needed;
+                        resampler.process(input, needed, output, 0, blockSize);
+                        for (int i = 0; i < blockSize; ++i, ++outputPosition)
+                        {
+                            if (outputPosition < 4 * resampler.getLatencyInputSamples())
+                                continue;
+                            const double expected = std::sin(juce::MathConstants<double>::twoPi * frequency * (double) outputPosition / deviceRate);
+                            signal += expected * expected;
+                            noise += (output.getSample(0, i) - expected) * (output.getSample(0, i) - expected);
+                        }
+                    }
+                    return noise > 0.0 ? 10.0 * std::log10(signal / noise) : 200.0;
+                };
+
+                OutputResampler probe;
+                probe.prepare(AudioController::INTERNAL_SAMPLE_RATE, deviceRate);
+                auto* o = new juce::DynamicObject();
+                o->setProperty("deviceSampleRate", deviceRate);
+                o->setProperty("latencyInputSamples", probe.getLatencyInputSamples());
+                o->setProperty("nsPerOutputSample", median(times) * 1.0e9);
+                o->setProperty("cpuPercentOfRealtime", median(times) * deviceRate * 100.0);
+                o->setProperty("snrDb1k", measureSnr(1000.0));
+                o->setProperty("snrDb15k", measureSnr(15000.0));
+                rows.add(juce::var(o));
+            }
+            return rows;
+        }
+
+        // 压缩样本存储：两种存储方式的样本内存、加载时长与钢琴 Voice 渲染开销（压缩存储播放时逐块解码），
+        // 以及编解码本身的误差与块解码速度
+        juce::var benchCompressedSamples()
+        {
+            auto* result = new juce::DynamicObject();
+            if (!pianoLoaded)
+                return juce::var(result);
+
+            const int blockSize = 256;
+            const int blocks = (int) ((config.quick ? 0.5 : 2.0) * kSampleRate / blockSize);
+            juce::Array<juce::var> storages;
+            for (auto mode : { PianoSound::storageFloat, PianoSound::storageCompressed })
+            {
+                PianoSound::clearSampleCache();
+                auto* sound = new PianoSound();
+                juce::SynthesiserSound::Ptr holder(sound);
+                sound->setStorageMode(mode);
+                const auto loadStart = nowSeconds();
+                sound->loadSFZ(config.sfzFile);
+                const double loadSeconds = nowSeconds() - loadStart;
+
+                auto* o = new juce::DynamicObject();
+                o->setProperty("storage", mode == PianoSound::storageCompressed ? "compressed" : "float");
+                o->setProperty("sampleMemoryMB", (double) sound->getSampleMemoryBytes() / (1024.0 * 1024.0));
+                o->setProperty("msToLoad", loadSeconds * 1000.0);
+
+                // 各 Voice 在样本音域内各弹一个键（都有样本，不走合成回退）
+                juce::Array<juce::var> renders;
+                for (int numVoices : { 8, 32 })
+                {
+                    std::vector<double> times;
+                    for (int r = 0; r < config.repeats; ++r)
+                    {
+                        EarxSynthesiser synth;
+                        setupPianoSynth(synth, numVoices, sound);
+                        for (int v = 0; v < numVoices; ++v)
+                            synth.noteOn(1, 48 + v, 0.8f);
+
+                        juce::AudioBuffer<float> buffer(2, blockSize);
+                        juce::MidiBuffer midi;
+                        const auto start = nowSeconds();
+                        for (int b = 0; b < blocks; ++b)
+                        {
+                            buffer.clear();
+                            synth.renderNextBlock(buffer, midi, 0, blockSize);
+                        }
+                        times.push_back((nowSeconds() - start) / ((double) blocks * blockSize));
+                        synth.clearSounds();
+                    }
+
+                    auto* row = new juce::DynamicObject();
+                    row->setProperty("voices", numVoices);
+                    row->setProperty("nsPerVoiceSample", median(times) * 1.0e9 / numVoices);
+                    row->setProperty("cpuPercentOfRealtime", median(times) * kSampleRate * 100.0);
+                    renders.add(juce::var(row));
+                }
+                o->setProperty("render", renders);
+                storages.add(juce::var(o));
+            }
+            PianoSound::clearSampleCache();
+            result->setProperty("storages", storages);
+
+            // 编解码误差：已加载的（浮点）样本逐个压缩再解码，与原样本比较
+            double signal = 0.0, noise = 0.0, decodeSeconds = 0.0;
+            float maxError = 0.0f;
+            juce::int64 decodedSamples = 0;
+            juce::Array<const juce::AudioBuffer<float>*> counted;
+            float decoded[CompressedSample::BLOCK_FRAMES];
+            for (int note = 21; note <= 108; ++note)
+            {
+                const auto* source = piano->getSampleForNote(note);
+                if (source == nullptr || !counted.addIfNotAlreadyThere(source))
+                    continue;
+
+                auto compressed = CompressedSample::encode(*source);
+                auto restored = compressed->decode();
+                for (int ch = 0; ch < source->getNumChannels(); ++ch)
+                {
+                    for (int i = 0; i < source->getNumSamples(); ++i)
+                    {
+                        const float x = source->getSample(ch, i);
+                        const float e = restored->getSample(ch, i) - x;
+                        signal += (double) x * x;
+                        noise += (double) e * e;
+                        maxError = juce::jmax(maxError, std::abs(e));
+                    }
+
+                    const auto start = nowSeconds();
+                    for (int block = 0; block < compressed->getNumBlocks(); ++block)
+                        compressed->decodeBlock(ch, block, decoded);
+                    decodeSeconds += nowSeconds() - start;
+                    decodedSamples += (juce::int64) compressed->getNumBlocks() * CompressedSample::BLOCK_FRAMES;
+                }
+            }
+            result->setProperty("snrDb", noise > 0.0 ? 10.0 * std::log10(signal / noise) : 200.0);
+            result->setProperty("maxAbsError", maxError);
+            result->setProperty("nsPerDecodedSample", decodedSamples > 0 ? decodeSeconds * 1.0e9 / (double) decodedSamples : 0.0);
+            return juce::var(result);
+        }
+
+        juce::var benchTimbreSwitch()
+        {
+            AppState state;
+            AudioController controller(&state);
+            controller.initialize(kSampleRate);
+            if (!waitForPiano(controller, 30000))
+                return {};
+
+            const int blockSize = 256;
+            const int switches = config.quick ? 4 : 16;
+            juce::AudioBuffer<float> buffer(2, blockSize);
+            juce::MidiBuffer midi;
+            std::vector<double> totalTimes, worstBlocks, blockCounts;
+
+            for (int s = 0; s < switches; ++s)
+            {
+                controller.playNote(60, 0.8f);
+                controller.switchTimbre(state.audio.timbre == AppState::timbrePiano ? AppState::timbreSine
+                                                                                     : AppState::timbrePiano);
+
+                double total = 0.0, worst = 0.0;
+                int blocks = 0;
+                while (state.audio.isSwitchingTimbre && blocks < 10000)
+                {
+                    buffer.clear();
+                    auto start = nowSeconds();
+                    controller.renderNextBlock(buffer, midi, 0, blockSize);
+                    auto seconds = (nowSeconds() - start);
+                    total += seconds;
+                    worst = juce::jmax(worst, seconds);
+                    ++blocks;
+                }
+
+                totalTimes.push_back(total);
+                worstBlocks.push_back(worst);
+                blockCounts.push_back((double) blocks);
+                controller.stopAllNotes();
+            }
+
+            auto* o = new juce::DynamicObject();
+            o->setProperty("switches", switches);
+            o->setProperty("blockSize", blockSize);
+            o->setProperty("medianBlocks", median(blockCounts));
+            o->setProperty("medianAudioMs", median(blockCounts) * blockSize * 1000.0 / kSampleRate);
+            o->setProperty("medianCpuUs", median(totalTimes) * 1.0e6);
+            o->setProperty("worstBlockUs", median(worstBlocks) * 1.0e6);
+            o->setProperty("blockBudgetUs", blockSize * 1.0e6 / kSampleRate);
+            return juce::var(o);
+        }
+    };
+}
+
+//==============================================================================
+int main(int argc, char* argv[])
+{
+    juce::ArgumentList args(argc, argv);
+
+    BenchConfig config;
+    config.quick = args.containsOption("--quick");
+    config.filter = args.getValueForOption("--filter");
+    config.repeats = config.quick ? 3 : 5;
+
+    auto sfzArg = args.getValueForOption("--sfz");
+    config.sfzFile = sfzArg.isNotEmpty() ? juce::File::getCurrentWorkingDirectory().getChildFile(sfzArg)
+                                         : getDefaultSFZFile();
+
+    if (!config.sfzFile.existsAsFile())
+    {
+        std::fprintf(stderr, "earx_bench: SFZ file not found: %s\n", config.sfzFile.getFullPathName().toRawUTF8());
+        return 1;
+    }
+
+    Benchmarks benchmarks(config);
+    auto json = juce::JSON::toString(benchmarks.run());
+
+    auto outArg = args.getValueForOption("--out");
+    if (outArg.isNotEmpty())
+    {
+        auto outFile = juce::File::getCurrentWorkingDirectory().getChildFile(outArg);
+        if (!outFile.replaceWithText(json))
+        {
+            std::fprintf(stderr, "earx_bench: could not write %s\n", outFile.getFullPathName().toRawUTF8());
+            return 1;
+        }
+    }
+    else
+    {
+        std::printf("%s\n", json.toRawUTF8());
+    }
+
+    return 0;
+}
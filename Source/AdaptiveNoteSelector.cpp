@@ -0,0 +1,197 @@
+#include "AdaptiveNoteSelector.h"
+
+AdaptiveNoteSelector::AdaptiveNoteSelector()
+{
+    const juce::ScopedLock sl(writeLock);
+    activeMask = (uint16_t) ((1 << NUM_SEMITONES) - 1); // 与 AppState 默认一致：全部半音激活
+    rebuildAndPublish();
+}
+
+void AdaptiveNoteSelector::setActiveMask(uint16_t mask)
+{
+    // 掩码未变时不加锁直接返回（交互状态通知也可能来自音频线程）
+    if (mask == activeMask.load())
+        return;
+
+    const juce::ScopedLock sl(writeLock);
+    activeMask = mask;
+    rebuildAndPublish();
+}
+
+void AdaptiveNoteSelector::recordResult(int semitone, int octaveIndex, bool correct)
+{
+    if (semitone < 0 || semitone >= NUM_SEMITONES || octaveIndex < 0 || octaveIndex >= NUM_OCTAVES)
+        return;
+
+    const juce::ScopedLock sl(writeLock);
+    auto& cell = stats[semitone * NUM_OCTAVES + octaveIndex];
+    cell.attempts++;
+    if (!correct)
+        cell.misses++;
+    cell.errorRate += ERROR_RATE_SMOOTHING * ((correct ? 0.0f : 1.0f) - cell.errorRate);
+
+    rebuildAndPublish();
+}
+
+void AdaptiveNoteSelector::resetStatistics()
+{
+    const juce::ScopedLock sl(writeLock);
+    for (auto& cell : stats)
+        cell = CellStats();
+
+    rebuildAndPublish();
+}
+
+float AdaptiveNoteSelector::getWeight(int semitone, int octaveIndex) const
+{
+    if (semitone < 0 || semitone >= NUM_SEMITONES || octaveIndex < 0 || octaveIndex >= NUM_OCTAVES)
+        return 0.0f;
+
+    const juce::ScopedLock sl(writeLock);
+    return building.weights[semitone * NUM_OCTAVES + octaveIndex];
+}
+
+AdaptiveNoteSelector::CellStats AdaptiveNoteSelector::getStats(int semitone, int octaveIndex) const
+{
+    if (semitone < 0 || semitone >= NUM_SEMITONES || octaveIndex < 0 || octaveIndex >= NUM_OCTAVES)
+        return {};
+
+    const juce::ScopedLock sl(writeLock);
+    return stats[semitone * NUM_OCTAVES + octaveIndex];
+}
+
+void AdaptiveNoteSelector::rebuildAndPublish()
+{
+    // 调用方已持有 writeLock
+    const uint16_t mask = activeMask.load();
+    building.mask = mask;
+    for (int i = 0; i < NUM_CELLS; ++i)
+        building.weights[i] = BASE_WEIGHT + stats[i].errorRate;
+
+    for (int exclude = 0; exclude <= NUM_SEMITONES; ++exclude)
+        buildAliasTable(building.weights, mask, exclude < NUM_SEMITONES ? exclude : -1, building.tables[exclude]);
+
+    const juce::SpinLock::ScopedLockType sl(liveLock);
+    live = building;
+}
+
+void AdaptiveNoteSelector::buildAliasTable(const float* weights, uint16_t mask, int excludeSemitone, AliasTable& table)
+{
+    // Vose 别名法：把 n 个候选的概率摊平到 n 个等宽槽，每槽至多两个结果
+    int n = 0;
+    double total = 0.0;
+    for (int semitone = 0; semitone < NUM_SEMITONES; ++semitone)
+    {
+        if ((mask & (1 << semitone)) == 0 || semitone == excludeSemitone)
+            continue;
+
+        for (int octave = 0; octave < NUM_OCTAVES; ++octave)
+        {
+            const int cell = semitone * NUM_OCTAVES + octave;
+            table.cells[n++] = (uint8_t) cell;
+            total += weights[cell];
+        }
+    }
+
+    table.count = n;
+    if (n == 0 || total <= 0.0)
+    {
+        table.count = 0;
+        return;
+    }
+
+    double scaled[NUM_CELLS];
+    uint8_t small[NUM_CELLS], large[NUM_CELLS];
+    int numSmall = 0, numLarge = 0;
+
+    for (int i = 0; i < n; ++i)
+    {
+        scaled[i] = weights[table.cells[i]] * n / total;
+        if (scaled[i] < 1.0)
+            small[numSmall++] = (uint8_t) i;
+        else
+            large[numLarge++] = (uint8_t) i;
+    }
+
+    while (numSmall > 0 && numLarge > 0)
+    {
+        const int s = small[--numSmall];
+        const int l = large[--numLarge];
+
+        table.probability[s] = (float) scaled[s];
+        table.alias[s] = (uint8_t) l;
+
+        scaled[l] = (scaled[l] + scaled[s]) - 1.0;
+        if (scaled[l] < 1.0)
+            small[numSmall++] = (uint8_t) l;
+        else
+            large[numLarge++] = (uint8_t) l;
+    }
+
+    // 剩余槽位（含浮点误差留下的）概率为 1
+    while (numLarge > 0)
+    {
+        const int l = large[--numLarge];
+        table.probability[l] = 1.0f;
+        table.alias[l] = (uint8_t) l;
+    }
+    while (numSmall > 0)
+    {
+        const int s = small[--numSmall];
+        table.probability[s] = 1.0f;
+        table.alias[s] = (uint8_t) s;
+    }
+}
+
+bool AdaptiveNoteSelector::selectCell(uint16_t mask, int excludeSemitone, SessionRandom& random, int& semitone, int& octaveIndex)
+{
+    const juce::SpinLock::ScopedTryLockType sl(liveLock);
+    if (!sl.isLocked() || live.mask != mask)
+        return false;
+
+    const bool canExclude = excludeSemitone >= 0 && excludeSemitone < NUM_SEMITONES
+                            && (mask & (1 << excludeSemitone)) != 0;
+    const auto& table = live.tables[canExclude ? excludeSemitone : NUM_SEMITONES];
+    if (table.count == 0)
+        return false;
+
+    int slot = random.nextInt(table.count);
+    if (table.probability[slot] < 1.0f && random.nextFloat() >= table.probability[slot])
+        slot = table.alias[slot];
+
+    const int cell = table.cells[slot];
+    semitone = cell / NUM_OCTAVES;
+    octaveIndex = cell % NUM_OCTAVES;
+    return true;
+}
+
+int AdaptiveNoteSelector::selectOctave(int semitone, int excludeOctaveIndex, SessionRandom& random)
+{
+    if (semitone < 0 || semitone >= NUM_SEMITONES)
+        return -1;
+
+    const juce::SpinLock::ScopedTryLockType sl(liveLock);
+    if (!sl.isLocked())
+        return -1;
+
+    // 只有三个候选，直接按累积权重选择
+    const float* weights = live.weights + semitone * NUM_OCTAVES;
+    float total = 0.0f;
+    for (int octave = 0; octave < NUM_OCTAVES; ++octave)
+        if (octave != excludeOctaveIndex)
+            total += weights[octave];
+
+    float r = random.nextFloat() * total;
+    int chosen = -1;
+    for (int octave = 0; octave < NUM_OCTAVES; ++octave)
+    {
+        if (octave == excludeOctaveIndex)
+            continue;
+
+        chosen = octave;
+        r -= weights[octave];
+        if (r < 0.0f)
+            break;
+    }
+    return chosen;
+}
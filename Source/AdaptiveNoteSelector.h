@@ -0,0 +1,91 @@
+#pragma once
+#include <juce_core/juce_core.h>
+#include "SessionRandom.h"
+#include <atomic>
+#include <cstdint>
+
+/**
+ * 自适应出题选择器 - 答错越多的音出现越频繁（类似间隔重复）
+ * 职责：
+ * - 维护 12 半音 x 3 八度的答题统计与权重表
+ * - 以 Vose 别名法（alias method）构建采样表，出题时 O(1) 采样
+ * - 统计更新与建表在调用线程（FFI / 消息线程）完成，音频线程只读取已发布的表
+ *
+ * 线程模型：
+ * - 写端（recordResult / setActiveMask / resetStatistics）由 writeLock 串行化，
+ *   先在 building 中建好完整的表，再在 liveLock 内整体拷贝到 live
+ * - 读端（selectCell / selectOctave）只做 try-lock，拿不到锁或表与当前激活半音不符时
+ *   返回失败，由调用方退回均匀随机，音频线程永不等待
+ */
+class AdaptiveNoteSelector
+{
+public:
+    static constexpr int NUM_SEMITONES = 12;
+    static constexpr int NUM_OCTAVES = 3;
+    static constexpr int NUM_CELLS = NUM_SEMITONES * NUM_OCTAVES; // 下标 = semitone * NUM_OCTAVES + octaveIndex
+
+    struct CellStats
+    {
+        int attempts = 0;
+        int misses = 0;
+        float errorRate = 0.5f; // 指数滑动平均的错误率，初始值相同 => 初始均匀分布
+    };
+
+    AdaptiveNoteSelector();
+
+    // ---- 写端：不在音频线程调用 ----
+
+    // 激活半音变化时重建采样表（bit i 对应半音 i）
+    void setActiveMask(uint16_t mask);
+
+    // 记录一次答题结果并重建采样表
+    void recordResult(int semitone, int octaveIndex, bool correct);
+    void resetStatistics();
+
+    float getWeight(int semitone, int octaveIndex) const;
+    CellStats getStats(int semitone, int octaveIndex) const;
+
+    // ---- 读端：音频线程安全（不阻塞、不分配） ----
+
+    // 在 mask 内按权重同时选出半音与八度，excludeSemitone（可为 -1）不参与选择
+    // 返回 false 表示暂无可用的表，调用方应退回均匀随机
+    bool selectCell(uint16_t mask, int excludeSemitone, SessionRandom& random, int& semitone, int& octaveIndex);
+
+    // 在给定半音的八度中按权重选择，excludeOctaveIndex（可为 -1）不参与选择；失败返回 -1
+    int selectOctave(int semitone, int excludeOctaveIndex, SessionRandom& random);
+
+private:
+    // 权重 = 基础权重 + 错误率：全对的音仍保留 1/5 左右的出现机会
+    static constexpr float BASE_WEIGHT = 0.25f;
+    // 错误率滑动平均系数：最近约 5 次作答决定权重
+    static constexpr float ERROR_RATE_SMOOTHING = 0.2f;
+
+    struct AliasTable
+    {
+        int count = 0;
+        uint8_t cells[NUM_CELLS] = {};
+        uint8_t alias[NUM_CELLS] = {};
+        float probability[NUM_CELLS] = {};
+    };
+
+    // 每个被排除的半音各一张表，最后一张不排除：避免重复与加权采样同时保持 O(1)
+    struct Snapshot
+    {
+        uint16_t mask = 0;
+        float weights[NUM_CELLS] = {};
+        AliasTable tables[NUM_SEMITONES + 1];
+    };
+
+    CellStats stats[NUM_CELLS];
+    std::atomic<uint16_t> activeMask { 0 };
+    Snapshot building;
+    juce::CriticalSection writeLock;
+
+    Snapshot live;
+    juce::SpinLock liveLock;
+
+    void rebuildAndPublish();
+    static void buildAliasTable(const float* weights, uint16_t mask, int excludeSemitone, AliasTable& table);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AdaptiveNoteSelector)
+};
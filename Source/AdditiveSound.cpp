@@ -0,0 +1,61 @@
+#include "AdditiveSound.h"
+
+AdditiveSound::AdditiveSound()
+{
+    setProfile(createDefaultProfile());
+}
+
+bool AdditiveSound::appliesToNote(int)
+{
+    return enabled.load();
+}
+
+bool AdditiveSound::appliesToChannel(int)
+{
+    return enabled.load();
+}
+
+AdditiveSound::Profile AdditiveSound::createDefaultProfile()
+{
+    Profile p;
+    p.numPartials = 12;
+    for (int i = 0; i < p.numPartials; ++i)
+    {
+        p.amplitude[i] = 1.0f / (float) (i + 1);
+        p.decaySeconds[i] = 6.0f / (float) (i + 1);
+    }
+    return p;
+}
+
+void AdditiveSound::setProfile(const Profile& newProfile)
+{
+    Profile clamped = newProfile;
+    clamped.numPartials = juce::jlimit(0, PartialOscillator::MAX_PARTIALS, newProfile.numPartials);
+
+    // 非有限值与负振幅按 0 处理，非有限的衰减时间按不衰减处理
+    for (int i = 0; i < clamped.numPartials; ++i)
+    {
+        if (!std::isfinite(clamped.amplitude[i]) || clamped.amplitude[i] < 0.0f)
+            clamped.amplitude[i] = 0.0f;
+        if (!std::isfinite(clamped.decaySeconds[i]))
+            clamped.decaySeconds[i] = 0.0f;
+    }
+
+    // 以起音时的振幅计算 RMS（各谐波互不相关：RMS² = Σa² / 2），统一到单位正弦波的 RMS
+    double sumSquares = 0.0;
+    for (int i = 0; i < clamped.numPartials; ++i)
+        sumSquares += (double) clamped.amplitude[i] * clamped.amplitude[i];
+    const float gain = sumSquares > 1.0e-12 ? (float) (1.0 / std::sqrt(sumSquares)) : 0.0f;
+
+    const juce::SpinLock::ScopedLockType sl(profileLock);
+    profile = clamped;
+    profileGain = gain;
+}
+
+AdditiveSound::Profile AdditiveSound::getProfile(float* normalisationGain) const
+{
+    const juce::SpinLock::ScopedLockType sl(profileLock);
+    if (normalisationGain != nullptr)
+        *normalisationGain = profileGain;
+    return profile;
+}
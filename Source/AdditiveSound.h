@@ -0,0 +1,35 @@
+#pragma once
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_core/juce_core.h>
+#include "PartialOscillator.h"
+
+// 加法合成音色类：保存当前分音表，供练习控制泛音构成（例如突出第 5 次谐波、调节明亮度）
+class AdditiveSound : public juce::SynthesiserSound
+{
+public:
+    using Profile = PartialOscillator::Profile;
+
+    AdditiveSound();
+
+    bool appliesToNote(int midiNoteNumber) override;
+    bool appliesToChannel(int midiChannelNumber) override;
+    void setEnabled(bool e) { enabled = e; }
+    bool isEnabled() const { return enabled; }
+
+    // 默认分音表：12 个谐波，振幅 1/n，高次谐波衰减更快
+    static Profile createDefaultProfile();
+
+    // 新分音表从下一个音符开始生效（任意线程调用）
+    void setProfile(const Profile& newProfile);
+
+    // 当前分音表的副本；normalisationGain 为把该分音表缩放到单位正弦 RMS 的增益
+    Profile getProfile(float* normalisationGain = nullptr) const;
+
+private:
+    mutable juce::SpinLock profileLock;   // 音频线程只在 startNote 时短暂持有
+    Profile profile;
+    float profileGain = 1.0f;
+    std::atomic<bool> enabled { true };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AdditiveSound)
+};
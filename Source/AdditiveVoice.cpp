@@ -0,0 +1,129 @@
+#include "AdditiveVoice.h"
+
+bool AdditiveVoice::canPlaySound(juce::SynthesiserSound* sound)
+{
+    return dynamic_cast<AdditiveSound*>(sound) != nullptr;
+}
+
+void AdditiveVoice::startNote(int midiNoteNumber, float velocity, juce::SynthesiserSound* sound, int)
+{
+    auto* additiveSound = dynamic_cast<AdditiveSound*>(sound);
+    if (additiveSound == nullptr)
+    {
+        DBG("Error: Sound is not AdditiveSound type");
+        return;
+    }
+
+    float normalisationGain = 1.0f;
+    const auto profile = additiveSound->getProfile(&normalisationGain);
+    partials.start(profile, juce::MidiMessage::getMidiNoteInHertz(midiNoteNumber), getSampleRate());
+
+    level = velocity * normalisationGain * getLoudnessGain(midiNoteNumber);
+    tailOff = 0.0f;
+    attack = 0.0f;
+    attackStep = 1.0f / (float) juce::jmax(1.0, getSampleRate() * 0.01);
+
+    // 刚起音的 Voice 按目标电平报告，同一块内的后续音符不会把它当作最安静的抢走
+    currentLevel = level * volume * partials.getAmplitudeSum();
+}
+
+void AdditiveVoice::stopNote(float, bool allowTailOff)
+{
+    if (allowTailOff)
+    {
+        if (tailOff == 0.0f)
+            tailOff = 1.0f;
+    }
+    else
+    {
+        // 硬停止：接管当前分音状态做快速释放，Voice 立即空出
+        if (isVoiceActive() && partials.isActive())
+        {
+            releasePartials = partials;
+            releaseGain = level * volume * getEnvelopeGain();
+            releaseStep = releaseGain / (float) getFastReleaseSamples();
+        }
+        clearCurrentNote();
+        partials.stop();
+        currentLevel = releaseGain * releasePartials.getAmplitudeSum();
+    }
+}
+
+float AdditiveVoice::getEnvelopeGain() const
+{
+    return attack * (tailOff > 0.0f ? tailOff : 1.0f);
+}
+
+void AdditiveVoice::renderNextBlock(juce::AudioBuffer<float>& outputBuffer, int startSample, int numSamples)
+{
+    const int outChans = outputBuffer.getNumChannels();
+
+    // 起音时所有分音都被剔除（全部超过奈奎斯特频率）的音符不发声
+    if (isVoiceActive() && !partials.isActive())
+        clearCurrentNote();
+
+    while (numSamples > 0)
+    {
+        const int chunk = juce::jmin(numSamples, PartialOscillator::CHUNK_SIZE);
+
+        if (releaseGain > 0.0f)
+        {
+            releasePartials.render(scratch, chunk);
+            for (int i = 0; i < chunk; ++i)
+            {
+                scratch[i] *= juce::jmax(0.0f, releaseGain);
+                releaseGain -= releaseStep;
+            }
+            releaseGain = juce::jmax(0.0f, releaseGain);
+
+            for (int ch = 0; ch < outChans; ++ch)
+                outputBuffer.addFrom(ch, startSample, scratch, chunk);
+        }
+
+        if (isVoiceActive() && partials.isActive())
+        {
+            partials.render(scratch, chunk);
+
+            const float localLevel = level * volume;
+            int rendered = chunk;
+            for (int i = 0; i < chunk; ++i)
+            {
+                if (attack < 1.0f)
+                    attack = juce::jmin(1.0f, attack + attackStep);
+
+                if (tailOff > 0.0f)
+                {
+                    tailOff *= 0.995f;
+                    if (tailOff < 0.01f)
+                    {
+                        rendered = i;
+                        break;
+                    }
+                }
+
+                scratch[i] *= localLevel * getEnvelopeGain();
+            }
+
+            for (int ch = 0; ch < outChans; ++ch)
+                outputBuffer.addFrom(ch, startSample, scratch, rendered);
+
+            // 释音结束，或所有分音都已衰减到听不到
+            if (rendered < chunk || !partials.isActive())
+            {
+                clearCurrentNote();
+                partials.stop();
+            }
+        }
+        else if (releaseGain <= 0.0f)
+        {
+            break;
+        }
+
+        startSample += chunk;
+        numSamples -= chunk;
+    }
+
+    // 分音振幅之和是输出峰值的上界（不计起音渐入）
+    currentLevel = partials.isActive() ? level * volume * (tailOff > 0.0f ? tailOff : 1.0f) * partials.getAmplitudeSum()
+                                       : releaseGain * releasePartials.getAmplitudeSum();
+}
@@ -0,0 +1,42 @@
+#pragma once
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_core/juce_core.h>
+#include "AdditiveSound.h"
+#include "EarxVoice.h"
+#include "PartialOscillator.h"
+
+class AdditiveVoice : public EarxVoice
+{
+public:
+    AdditiveVoice() = default;
+
+    bool canPlaySound(juce::SynthesiserSound* sound) override;
+    void startNote(int midiNoteNumber, float velocity, juce::SynthesiserSound* sound, int currentPitchWheelPosition) override;
+    void stopNote(float velocity, bool allowTailOff) override;
+    void renderNextBlock(juce::AudioBuffer<float>& outputBuffer, int startSample, int numSamples) override;
+    void pitchWheelMoved(int) override {}
+    void controllerMoved(int, int) override {}
+
+    void setVolume(float newVolume) override { volume = newVolume; }
+    float getCurrentLevel() const override { return currentLevel; }
+
+private:
+    float getEnvelopeGain() const;
+
+    PartialOscillator partials;
+    float level = 0.0f;         // 力度 × 分音表归一化增益
+    float attack = 0.0f;
+    float attackStep = 0.0f;
+    float tailOff = 0.0f;
+    float volume = 0.2f;
+    float currentLevel = 0.0f;
+
+    // 硬停止 / 被抢占时保留的旧音符分音状态，线性淡出 FAST_RELEASE_MS
+    PartialOscillator releasePartials;
+    float releaseGain = 0.0f;
+    float releaseStep = 0.0f;
+
+    float scratch[PartialOscillator::CHUNK_SIZE] = {};
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AdditiveVoice)
+};
@@ -0,0 +1,62 @@
+#include "AnswerScorer.h"
+#include "AudioController.h"
+
+void AnswerScorer::noteStarted(int midiNote, juce::int64 onsetSample)
+{
+    if (midiNote < 0 || midiNote > 127 || onsetSample < 0)
+        return;
+
+    pendingQuestion = ((int64_t) onsetSample << 7) | (int64_t) midiNote;
+}
+
+bool AnswerScorer::submitAnswer(int semitone, double answerHostMs, const AudioController& clock, Result& result)
+{
+    const int64_t question = pendingQuestion.exchange(NO_QUESTION);
+    if (question == NO_QUESTION)
+        return false;
+
+    const int midiNote = (int) (question & 0x7f);
+    const juce::int64 onsetSample = (juce::int64) (question >> 7);
+
+    // 音符真正被听到的时刻 = 起始样本 + 输出延迟（设备延迟 + 一个缓冲区）
+    const juce::int64 heardSample = onsetSample + clock.getOutputLatencySamples();
+
+    result.midiNote = midiNote;
+    result.expectedSemitone = midiNote % 12;
+    result.answeredSemitone = semitone;
+    result.correct = semitone == result.expectedSemitone;
+    result.onsetMs = (double) heardSample * 1000.0 / clock.getSampleRate();
+    result.reactionMs = answerHostMs - clock.audioClockToHostTimeMs(heardSample);
+
+    const juce::ScopedLock sl(resultsLock);
+    results[nextResultIndex] = result;
+    nextResultIndex = (nextResultIndex + 1) % RESULT_CAPACITY;
+    numResults = juce::jmin(numResults + 1, RESULT_CAPACITY);
+
+    DBG("Answer: expected " + juce::String(result.expectedSemitone) + ", got " + juce::String(semitone)
+        + (result.correct ? " (correct)" : " (wrong)") + ", reaction " + juce::String(result.reactionMs, 1) + " ms");
+    return true;
+}
+
+int AnswerScorer::getNumResults() const
+{
+    const juce::ScopedLock sl(resultsLock);
+    return numResults;
+}
+
+bool AnswerScorer::getResult(int index, Result& result) const
+{
+    const juce::ScopedLock sl(resultsLock);
+    if (index < 0 || index >= numResults)
+        return false;
+
+    result = results[(nextResultIndex - 1 - index + RESULT_CAPACITY) % RESULT_CAPACITY];
+    return true;
+}
+
+void AnswerScorer::clearResults()
+{
+    const juce::ScopedLock sl(resultsLock);
+    nextResultIndex = 0;
+    numResults = 0;
+}
@@ -0,0 +1,58 @@
+#pragma once
+#include <juce_core/juce_core.h>
+#include <atomic>
+#include <cstdint>
+
+class AudioController;
+
+/**
+ * 作答评分 - 以音频时钟为准计算正确性与反应时间
+ * 职责：
+ * - 记录当前题目音符的起始样本位置（在音频时钟上，样本级精度）
+ * - 作答时以“实际被听到的时刻”（起始位置 + 输出延迟）为起点计算反应时间
+ * - 结果保存在固定容量的环形缓冲区中，最新的结果覆盖最旧的结果
+ *
+ * 线程模型：noteStarted 可在音频线程调用（仅一次原子写入）；
+ * 作答与查询在 FFI 线程调用，环形缓冲区由 resultsLock 保护
+ */
+class AnswerScorer
+{
+public:
+    static constexpr int RESULT_CAPACITY = 128;
+
+    struct Result
+    {
+        int midiNote = -1;          // 所出的音
+        int expectedSemitone = -1;
+        int answeredSemitone = -1;
+        bool correct = false;
+        double onsetMs = 0.0;       // 音符被听到的时刻（音频时钟，毫秒）
+        double reactionMs = 0.0;    // 作答时刻 - 被听到的时刻
+    };
+
+    AnswerScorer() = default;
+
+    // 出题：记录音符与其在音频时钟上的起始样本（新题目替换尚未作答的旧题目）
+    void noteStarted(int midiNote, juce::int64 onsetSample);
+
+    // 作答：answerHostMs 为 juce::Time::getMillisecondCounterHiRes() 时基下的作答时刻
+    // 没有待作答的题目时返回 false；每道题只计一次
+    bool submitAnswer(int semitone, double answerHostMs, const AudioController& clock, Result& result);
+
+    // 结果查询：index 0 为最近一次
+    int getNumResults() const;
+    bool getResult(int index, Result& result) const;
+    void clearResults();
+
+private:
+    // 待作答题目：起始样本与 MIDI 音符打包为一个 64 位值，音频线程写入时无需加锁
+    static constexpr int64_t NO_QUESTION = -1;
+    std::atomic<int64_t> pendingQuestion { NO_QUESTION };
+
+    Result results[RESULT_CAPACITY];
+    int nextResultIndex = 0;
+    int numResults = 0;
+    juce::CriticalSection resultsLock;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AnswerScorer)
+};
@@ -9,19 +9,47 @@
 class AppState
 {
 public:
+    // 音色（数值与 FFI 的 EarxTimbre 一致）
+    enum Timbre
+    {
+        timbreSine = 0,
+        timbrePiano = 1,
+        timbreSaw = 2,
+        timbreSquare = 3,
+        timbreOrgan = 4,
+        timbreUserWavetable = 5,
+        timbreAdditive = 6,
+        timbreString = 7,
+        numTimbres
+    };
+    
+    // 钢琴样本的存储方式（数值与 FFI 的 earx_get_piano_sample_storage 一致）
+    enum PianoSampleStorage
+    {
+        pianoStorageAuto = 0,       // 按设备内存选择：低内存设备压缩，其余浮点
+        pianoStorageFloat = 1,
+        pianoStorageCompressed = 2
+    };
+    
     // 音频相关状态
     struct AudioState
     {
-        bool isPianoMode = false;
+        Timbre timbre = timbreSine;
         float masterVolume = 0.2f;
+        float volumeSmoothingMs = 20.0f;    // 主音量变化的平滑时间
+        float roomLevel = 0.0f;             // 房间卷积湿声电平，0 表示旁路
+        float reverbRoomSize = 0.5f;        // FDN 混响参数（0 - 1），湿声为 0 表示旁路
+        float reverbDamping = 0.5f;
+        float reverbMix = 0.0f;
+        float limiterLookaheadMs = 1.0f;    // 主总线限幅器的预读时长（0.25 - 2 毫秒）
+        float voiceCullingFloorDb = -70.0f; // 可闻下限（相对输出满幅）：采样钢琴 Voice 的剩余峰值低于它时提前结束
+        PianoSampleStorage pianoSampleStorage = pianoStorageAuto;   // 下次加载钢琴样本时生效
         bool isSwitchingTimbre = false;
-        float currentFadeVolume = 1.0f;
-        float targetVolume = 0.2f;
         bool pendingTimbreSwitch = false;
-        bool nextIsPianoMode = false;
+        Timbre nextTimbre = timbreSine;
         
-        static constexpr float FADE_STEP = 0.05f;
-        static constexpr float FADE_DURATION_MS = 150.0f;
+        static constexpr float FADE_DURATION_MS = 150.0f;   // 音色切换时淡出、淡入各自的时长
+        static constexpr float MAX_VOLUME_SMOOTHING_MS = 1000.0f;
     } audio;
     
     // UI交互状态
@@ -76,6 +104,11 @@ public:
         int lastMidiNote = -1;
         int lastSemitone = -1;
         
+        // 练习模式: 0=单音, 1=音程, 2=三和弦, 3=七和弦
+        int exerciseMode = 0;
+        // 练习播放方式: 0=和声(同时), 1=旋律上行, 2=旋律下行
+        int exerciseStyle = 0;
+        
         // 自动播放状态
         bool autoPlayEnabled = false;
         double lastAutoPlayTime = 0; // 上次自动播放的时间（毫秒）
@@ -1,170 +1,798 @@
 #include "AudioController.h"
 #include "AppState.h"
+#include "InstrumentPack.h"
+#include "PlaybackEngine.h"
+
+namespace
+{
+    // 仅用于 DBG 日志，release 构建中未被引用
+    [[maybe_unused]] const char* getTimbreName(AppState::Timbre timbre)
+    {
+        switch (timbre)
+        {
+            case AppState::timbreSine:          return "Sine";
+            case AppState::timbrePiano:         return "Piano";
+            case AppState::timbreSaw:           return "Saw";
+            case AppState::timbreSquare:        return "Square";
+            case AppState::timbreOrgan:         return "Organ";
+            case AppState::timbreUserWavetable: return "User wavetable";
+            case AppState::timbreAdditive:      return "Additive";
+            case AppState::timbreString:        return "String model";
+            default:                            return "Unknown";
+        }
+    }
+    
+    // 波表音色与 WavetableSound 波形的对应关系
+    WavetableSound::Waveform getWaveformForTimbre(AppState::Timbre timbre)
+    {
+        switch (timbre)
+        {
+            case AppState::timbreSquare:        return WavetableSound::square;
+            case AppState::timbreOrgan:         return WavetableSound::organ;
+            case AppState::timbreUserWavetable: return WavetableSound::user;
+            default:                            return WavetableSound::saw;
+        }
+    }
+    
+    bool isWavetableTimbre(AppState::Timbre timbre)
+    {
+        return timbre >= AppState::timbreSaw && timbre <= AppState::timbreUserWavetable;
+    }
+}
 
 AudioController::AudioController(AppState* state) 
     : appState(state)
 {
+    targetMasterGain.store(appState->audio.masterVolume);
+    volumeSmoothingMs.store(appState->audio.volumeSmoothingMs);
+    appliedSmoothingMs = appState->audio.volumeSmoothingMs;
+    roomConvolution.setWetLevel(appState->audio.roomLevel);
+    reverb.setRoomSize(appState->audio.reverbRoomSize);
+    reverb.setDamping(appState->audio.reverbDamping);
+    reverb.setMix(appState->audio.reverbMix);
+    limiter.setLookahead(appState->audio.limiterLookaheadMs);
+    setVoiceCullingFloor(appState->audio.voiceCullingFloorDb);
+    loudnessThread = std::make_unique<LoudnessThread>(this);
     DBG("AudioController initialized");
 }
 
 AudioController::~AudioController()
 {
+    // 先停钢琴加载线程与测量线程：它们会读取下面释放的 Sound，加载完成的回调还会回到本对象测量响度；
+    // 不能留到 clearSounds 中析构 PianoSound 时再等
+    if (pianoSound != nullptr)
+        pianoSound->stopLoading();
+    loudnessThread->stopThread(10000);
+    
+    publishedPianoSound.store(nullptr, std::memory_order_release);
     synth.clearVoices();
     synth.clearSounds();
 }
 
-void AudioController::initialize(double sampleRate)
+void AudioController::initialize(double deviceSampleRate)
 {
+    // 引擎内部固定采样率，与设备采样率的差异只由输出转换处理
+    const double sampleRate = INTERNAL_SAMPLE_RATE;
     currentSampleRate = sampleRate;
     synth.setCurrentPlaybackSampleRate(sampleRate);
+    oscillatorBank.prepare(sampleRate);
+    blockMidi.ensureSize(2048); // 预分配，渲染时不再分配
+    setDeviceSampleRate(deviceSampleRate);
+    
+    {
+        const juce::ScopedLock sl (synthMutex);
+        appliedSmoothingMs = volumeSmoothingMs.load();
+        masterGain.reset(sampleRate, appliedSmoothingMs / 1000.0);
+        masterGain.setCurrentAndTargetValue(targetMasterGain.load());
+        fadeGain.reset(sampleRate, AppState::AudioState::FADE_DURATION_MS / 1000.0);
+        fadeGain.setCurrentAndTargetValue(1.0f);
+        roomConvolution.prepare(sampleRate, 2);
+        reverb.prepare(sampleRate);
+        limiter.prepare(sampleRate);
+    }
     setupSynthesiser();
+    
+    // 按键响度补偿表：合成音色交给测量线程；钢琴在样本加载完成后于加载线程测量，没有 SFZ 时测量合成回退音色
+    for (int timbre = 0; timbre < AppState::numTimbres; ++timbre)
+        if (timbre != AppState::timbrePiano || !getPianoInstrumentFile().exists())
+            requestLoudnessMeasurement((AppState::Timbre) timbre);
     DBG("AudioController initialized with sample rate: " + juce::String(sampleRate));
     
     // 添加详细的采样率调试信息
     DBG("=== AUDIO SYSTEM INFO ===");
-    DBG("Current sample rate: " + juce::String(currentSampleRate));
+    DBG("Internal sample rate: " + juce::String(currentSampleRate) + ", device sample rate: " + juce::String(getDeviceSampleRate()));
     DBG("Synthesiser sample rate: " + juce::String(synth.getSampleRate()));
     DBG("=== END AUDIO SYSTEM INFO ===");
 }
 
+void AudioController::setDeviceSampleRate(double sampleRate)
+{
+    if (sampleRate <= 0.0)
+        return;
+    
+    outputResampler.prepare(INTERNAL_SAMPLE_RATE, sampleRate);
+    internalBuffer.setSize(OutputResampler::MAX_CHANNELS, juce::jmax(1, outputResampler.getMaxInputSamples()));
+    resamplerMidi.ensureSize(2048);
+    deviceSampleRate.store(sampleRate);
+    DBG("Device sample rate: " + juce::String(sampleRate) + (outputResampler.isBypassed() ? " (no conversion)" : " (resampling output)"));
+}
+
+int AudioController::getOutputLatencySamples() const
+{
+    const double device = deviceSampleRate.load();
+    const int deviceLatency = juce::roundToInt(outputLatencySamples.load() * currentSampleRate / device);
+    return deviceLatency + limiter.getLatencySamples() + outputResampler.getLatencyInputSamples();
+}
+
 void AudioController::renderNextBlock(juce::AudioBuffer<float>& buffer, 
                                     const juce::MidiBuffer& midiBuffer,
                                     int startSample, int numSamples)
 {
+    if (outputResampler.isBypassed())
+    {
+        renderInternalBlock(buffer, midiBuffer, startSample, numSamples);
+        return;
+    }
+    
+    // 设备采样率不同：分段以内部采样率渲染，再转换到设备缓冲区；传入的 MIDI 事件按比例换算到内部样本位置
+    for (int offset = 0; offset < numSamples; offset += OutputResampler::MAX_OUTPUT_BLOCK)
+    {
+        const int count = juce::jmin((int) OutputResampler::MAX_OUTPUT_BLOCK, numSamples - offset);
+        const int needed = outputResampler.getInputSamplesNeeded(count);
+        if (needed > 0)
+        {
+            resamplerMidi.clear();
+            for (const auto metadata : midiBuffer)
+            {
+                const int position = metadata.samplePosition - startSample - offset;
+                if (position >= 0 && position < count)
+                    resamplerMidi.addEvent(metadata.getMessage(), juce::jmin(needed - 1, position * needed / count));
+            }
+            internalBuffer.clear(0, needed);
+            renderInternalBlock(internalBuffer, resamplerMidi, 0, needed);
+        }
+        outputResampler.process(internalBuffer, needed, buffer, startSample + offset, count);
+    }
+}
+
+void AudioController::renderInternalBlock(juce::AudioBuffer<float>& buffer, const juce::MidiBuffer& midiBuffer,
+                                          int startSample, int numSamples)
+{
+    // 本块内有外部 MIDI 事件时不能走空闲路径，否则事件会被丢弃
+    const auto nextEvent = midiBuffer.findNextSamplePosition(startSample);
+    const bool hasMidiInBlock = nextEvent != midiBuffer.cend()
+                             && (*nextEvent).samplePosition < startSample + numSamples;
+    
+    if (!hasMidiInBlock)
+    {
+        // 空闲快速路径：非阻塞取锁，其他线程正在发音符时退回正常路径
+        const juce::ScopedTryLock tl (synthMutex);
+        if (tl.isLocked() && idle && !appState->audio.isSwitchingTimbre)
+        {
+            buffer.clear(startSample, numSamples);
+            clockAnchorSample = renderedSamples;
+            clockAnchorHostMs = juce::Time::getMillisecondCounterHiRes();
+            renderedSamples += numSamples;
+            idleSamples += numSamples;
+            return;
+        }
+    }
+    
     // 在音频线程中推进淡入淡出与切换逻辑，避免点击声
     updateFadeTransition();
     const juce::ScopedLock sl (synthMutex);
-    synth.renderNextBlock(buffer, midiBuffer, startSample, numSamples);
+    
+    // 记录本块开始时的时钟锚点，供作答时刻换算
+    clockAnchorSample = renderedSamples;
+    clockAnchorHostMs = juce::Time::getMillisecondCounterHiRes();
+    
+    const int voicesBefore = synth.getNumActiveVoices() + oscillatorBank.getNumActiveVoices();
+    const auto startTicks = juce::Time::getHighResolutionTicks();
+    
+    const juce::MidiBuffer* midi = &midiBuffer;
+    if (numScheduledEvents > 0)
+    {
+        // 把落在本块内的定时事件按样本偏移并入 MIDI 缓冲
+        collectScheduledEvents(midiBuffer, startSample, numSamples);
+        midi = &blockMidi;
+    }
+    
+    // 事件只交给当前音色的引擎，另一个引擎只渲染残留的尾音
+    const bool usesSynth = appState->audio.timbre != AppState::timbreSine;
+    updateAudibilityFloor();
+    synth.renderNextBlock(buffer, usesSynth ? *midi : noMidi, startSample, numSamples);
+    oscillatorBank.renderNextBlock(buffer, usesSynth ? noMidi : *midi, startSample, numSamples);
+    
+    const auto elapsedTicks = juce::Time::getHighResolutionTicks() - startTicks;
+    const int voicesAfter = synth.getNumActiveVoices() + oscillatorBank.getNumActiveVoices();
+    
+    // 总线处理：房间卷积与 FDN 混响（单独计时，不计入每个 Voice 的开销）→ 主音量
+    roomConvolution.process(buffer, startSample, numSamples);
+    reverb.process(buffer, startSample, numSamples);
+    applyMasterGain(buffer, startSample, numSamples);
+    limiter.process(buffer, startSample, numSamples);
+    updateRenderCost(elapsedTicks, juce::jmax(voicesBefore, voicesAfter), numSamples);
+    updateIdleState(voicesAfter, numSamples);
+    
+    renderedSamples += numSamples;
+}
+
+void AudioController::updateIdleState(int activeVoices, int numSamples)
+{
+    // 调用方已持有 synthMutex
+    if (activeVoices > 0 || numScheduledEvents > 0 || appState->audio.isSwitchingTimbre || reverb.isRinging())
+    {
+        // 外部 MIDI 触发的音符经正常路径渲染后在这里退出空闲
+        quietSamples = 0;
+        idle = false;
+        return;
+    }
+    
+    // 房间卷积开启时等尾音放完再进入空闲
+    const int graceSamples = juce::jmax((int) (IDLE_GRACE_MS * currentSampleRate / 1000.0), roomConvolution.getTailSamples());
+    quietSamples = juce::jmin(quietSamples + numSamples, graceSamples);
+    if (quietSamples >= graceSamples && !idle)
+    {
+        idle = true;
+        DBG("Audio engine idle");
+    }
+}
+
+AudioController::IdleStats AudioController::getIdleStats() const
+{
+    const juce::ScopedLock sl (synthMutex);
+    return { idleSamples, renderedSamples, idle };
+}
+
+void AudioController::updateAudibilityFloor()
+{
+    // 调用方已持有 synthMutex；取平滑中的当前值与目标值的较大者，音量正在升高时不提前结束音符
+    const float outputGain = juce::jmax(masterGain.getCurrentValue(), targetMasterGain.load(std::memory_order_relaxed));
+    const float floorGain = juce::jmin(juce::Decibels::decibelsToGain(MAX_CULLING_FLOOR_DB),
+                                       cullingFloorGain.load(std::memory_order_relaxed) / juce::jmax(outputGain, 1.0e-5f));
+    if (floorGain == appliedFloorGain)
+        return;
+    
+    // 合成器中只有引擎自己添加的 EarxVoice
+    for (int i = 0; i < synth.getNumVoices(); ++i)
+        static_cast<EarxVoice*>(synth.getVoice(i))->setAudibilityFloor(floorGain);
+    appliedFloorGain = floorGain;
+}
+
+void AudioController::applyMasterGain(juce::AudioBuffer<float>& buffer, int startSample, int numSamples)
+{
+    // 调用方已持有 synthMutex；平滑时间变化时保留当前值，只改变之后的斜坡长度
+    const float smoothingMs = volumeSmoothingMs.load(std::memory_order_relaxed);
+    if (smoothingMs != appliedSmoothingMs)
+    {
+        const float current = masterGain.getCurrentValue();
+        masterGain.reset(currentSampleRate, smoothingMs / 1000.0);
+        masterGain.setCurrentAndTargetValue(current);
+        appliedSmoothingMs = smoothingMs;
+    }
+    masterGain.setTargetValue(targetMasterGain.load(std::memory_order_relaxed));
+    
+    const int numChannels = buffer.getNumChannels();
+    if (!masterGain.isSmoothing() && !fadeGain.isSmoothing())
+    {
+        // 稳态：整块一个常数增益
+        buffer.applyGain(startSample, numSamples, masterGain.getCurrentValue() * fadeGain.getCurrentValue());
+        return;
+    }
+    
+    // 斜坡：先按块生成逐样本增益，再对各声道做向量乘法
+    for (int offset = 0; offset < numSamples; offset += GAIN_CHUNK)
+    {
+        const int count = juce::jmin(GAIN_CHUNK, numSamples - offset);
+        for (int i = 0; i < count; ++i)
+            gainRamp[i] = masterGain.getNextValue() * fadeGain.getNextValue();
+        
+        for (int ch = 0; ch < numChannels; ++ch)
+            juce::FloatVectorOperations::multiply(buffer.getWritePointer(ch, startSample + offset), gainRamp, count);
+    }
+}
+
+void AudioController::updateRenderCost(juce::int64 elapsedTicks, int activeVoices, int numSamples)
+{
+    // 调用方已持有 synthMutex；没有活动 Voice 的块不反映每个 Voice 的开销
+    if (activeVoices <= 0 || numSamples <= 0)
+        return;
+    
+    const double seconds = juce::Time::highResolutionTicksToSeconds(elapsedTicks);
+    const double cost = seconds / ((double) activeVoices * numSamples);
+    
+    // 固定开销摊入每个 Voice，估算偏保守
+    constexpr double alpha = 0.05;
+    voiceSampleCostSeconds = measuredBlocks == 0 ? cost : voiceSampleCostSeconds + alpha * (cost - voiceSampleCostSeconds);
+    
+    if (++measuredBlocks < MIN_MEASURED_BLOCKS || voiceSampleCostSeconds <= 0.0)
+        return;
+    
+    // 每个 Voice 占用的实时预算比例 = 每样本耗时 × 采样率
+    const double loadPerVoice = voiceSampleCostSeconds * currentSampleRate;
+    const int sustainable = (int) juce::jlimit(1.0, (double) MAX_POLYPHONY, std::floor(RENDER_LOAD_TARGET / loadPerVoice));
+    maxSustainablePolyphony.store(sustainable, std::memory_order_relaxed);
+}
+
+void AudioController::collectScheduledEvents(const juce::MidiBuffer& incoming, int startSample, int numSamples)
+{
+    // 调用方已持有 synthMutex
+    blockMidi.clear();
+    blockMidi.addEvents(incoming, startSample, numSamples, 0);
+    
+    const juce::int64 blockEnd = renderedSamples + numSamples;
+    int remaining = 0;
+    
+    for (int i = 0; i < numScheduledEvents; ++i)
+    {
+        const auto& event = scheduledEvents[i];
+        if (event.samplePosition < blockEnd)
+        {
+            const int offset = startSample + (int) juce::jmax((juce::int64) 0, event.samplePosition - renderedSamples);
+            if (event.velocity > 0.0f)
+                blockMidi.addEvent(juce::MidiMessage::noteOn(1, event.midiNote, event.velocity), offset);
+            else
+                blockMidi.addEvent(juce::MidiMessage::noteOff(1, event.midiNote), offset);
+        }
+        else
+        {
+            scheduledEvents[remaining++] = event;
+        }
+    }
+    
+    numScheduledEvents = remaining;
+}
+
+juce::int64 AudioController::scheduleNote(int midiNote, float velocity, int delaySamples, int durationSamples)
+{
+    return scheduleNotes(&midiNote, 1, velocity, delaySamples, 0, durationSamples);
+}
+
+juce::int64 AudioController::scheduleNotes(const int* midiNotes, int numNotes, float velocity, int delaySamples,
+                                           int spacingSamples, int durationSamples)
+{
+    if (numNotes <= 0)
+        return -1;
+    
+    if (!appState->system.midiOutputEnabled)
+    {
+        DBG("MIDI output disabled, ignoring " + juce::String(numNotes) + " note(s) from " + juce::String(midiNotes[0]));
+        return -1;
+    }
+    
+    // 整组在同一次加锁内排队：音频线程不会在两个音符之间渲染，和弦的各音落在同一块内
+    const juce::ScopedLock sl (synthMutex);
+    if (numScheduledEvents + 2 * numNotes > MAX_SCHEDULED_EVENTS)
+    {
+        DBG("Scheduled event queue full, dropping " + juce::String(numNotes) + " note(s) from " + juce::String(midiNotes[0]));
+        return -1;
+    }
+    
+    const juce::int64 onset = renderedSamples + juce::jmax(0, delaySamples);
+    for (int i = 0; i < numNotes; ++i)
+    {
+        const juce::int64 noteOnset = onset + (juce::int64) i * juce::jmax(0, spacingSamples);
+        scheduledEvents[numScheduledEvents++] = { noteOnset, midiNotes[i], juce::jmax(0.01f, velocity) };
+        scheduledEvents[numScheduledEvents++] = { noteOnset + juce::jmax(1, durationSamples), midiNotes[i], 0.0f };
+    }
+    idle = false;
+    quietSamples = 0;
+    return onset;
+}
+
+void AudioController::setPolyphony(int numVoices)
+{
+    numVoices = juce::jlimit(1, MAX_POLYPHONY, numVoices);
+    
+    const juce::ScopedLock sl (synthMutex);
+    if (numVoices == polyphony)
+        return;
+    
+    DBG("Changing polyphony from " + juce::String(polyphony) + " to " + juce::String(numVoices));
+    oscillatorBank.setPolyphony(numVoices);
+    if (numVoices > polyphony)
+    {
+        addVoicesForCurrentTimbre(numVoices - polyphony);
+    }
+    else
+    {
+        // 从末尾移除多余的 Voice（其上正在发声的音符直接结束）
+        while (synth.getNumVoices() > numVoices)
+            synth.removeVoice(synth.getNumVoices() - 1);
+    }
+    polyphony = numVoices;
+    applyLoudnessTablesToVoices();
+}
+
+void AudioController::ensurePolyphony(int numVoices)
+{
+    const juce::ScopedLock sl (synthMutex);
+    if (numVoices > polyphony)
+        setPolyphony(numVoices);
+}
+
+int AudioController::getPolyphony() const
+{
+    const juce::ScopedLock sl (synthMutex);
+    return polyphony;
+}
+
+juce::int64 AudioController::getNumVoicesStolen() const
+{
+    const juce::ScopedLock sl (synthMutex);
+    return synth.getNumVoicesStolen() + oscillatorBank.getNumVoicesStolen();
+}
+
+void AudioController::addVoicesForCurrentTimbre(int count)
+{
+    // 调用方已持有 synthMutex；正弦音色由 OscillatorBank 发声，其余音色的 Voice 由合成器承载
+    const auto timbre = appState->audio.timbre;
+    if (timbre == AppState::timbreSine)
+        return;
+    
+    for (int i = 0; i < count; ++i)
+    {
+        if (timbre == AppState::timbrePiano)
+            synth.addVoice(new PianoVoice());
+        else if (timbre == AppState::timbreAdditive)
+            synth.addVoice(new AdditiveVoice());
+        else if (timbre == AppState::timbreString)
+            synth.addVoice(new StringModelVoice());
+        else
+            synth.addVoice(new WavetableVoice());
+    }
+}
+
+juce::int64 AudioController::getAudioClockPosition() const
+{
+    const juce::ScopedLock sl (synthMutex);
+    return renderedSamples;
+}
+
+double AudioController::audioClockToHostTimeMs(juce::int64 samplePosition) const
+{
+    const juce::ScopedLock sl (synthMutex);
+    return clockAnchorHostMs + (double) (samplePosition - clockAnchorSample) * 1000.0 / currentSampleRate;
 }
 
-void AudioController::switchTimbre(bool isPianoMode)
+void AudioController::switchTimbre(AppState::Timbre timbre)
 {
     if (appState->audio.isSwitchingTimbre) {
         DBG("Already switching timbre, ignoring request");
         return;
     }
     
-    if (isPianoMode == appState->audio.isPianoMode) {
-        return; // 已经是目标模式
+    if (timbre == appState->audio.timbre) {
+        return; // 已经是目标音色
     }
     
-    DBG("Starting smooth timbre switch to: " + juce::String(isPianoMode ? "Piano" : "Sine"));
+    DBG("Starting smooth timbre switch to: " + juce::String(getTimbreName(timbre)));
     // 先淡出，淡出完成后在音频线程执行真正的切换，再淡入
-    startTimbreFadeOut(isPianoMode);
+    startTimbreFadeOut(timbre);
+}
+
+bool AudioController::loadUserWavetable(const juce::File& file)
+{
+    WavetableSound* sound = nullptr;
+    {
+        const juce::ScopedLock sl (synthMutex);
+        sound = wavetableSound;
+    }
+    if (sound == nullptr)
+        return false;
+    
+    // 波表在调用线程生成（不持锁），音频线程只在下一个音符开始时取用新表；响度补偿表在后台重新测量
+    if (!sound->loadUserWavetable(file))
+        return false;
+    requestLoudnessMeasurement(AppState::timbreUserWavetable);
+    return true;
+}
+
+void AudioController::setPartialProfile(const AdditiveSound::Profile& profile)
+{
+    {
+        const juce::ScopedLock sl (synthMutex);
+        if (additiveSound == nullptr)
+            return;
+        additiveSound->setProfile(profile);
+    }
+    requestLoudnessMeasurement(AppState::timbreAdditive);
+}
+
+AdditiveSound::Profile AudioController::getPartialProfile() const
+{
+    const juce::ScopedLock sl (synthMutex);
+    return additiveSound != nullptr ? additiveSound->getProfile() : AdditiveSound::createDefaultProfile();
 }
 
 void AudioController::setupSynthesiser()
 {
     DBG("=== setupSynthesiser() called ===");
-    DBG("Starting synthesiser setup, mode: " + juce::String(appState->audio.isPianoMode ? "piano" : "sine"));
+    DBG("Starting synthesiser setup, timbre: " + juce::String(getTimbreName(appState->audio.timbre)));
     const juce::ScopedLock sl (synthMutex);
     // 只清除现有的voices，保留sounds（一次性添加，避免切换时重新加载样本）
     synth.clearVoices();
+    oscillatorBank.reset();
+    oscillatorBank.setPolyphony(polyphony);
 
-    // 首次初始化时一次性添加两种Sound（DummySound + PianoSound），之后不再移除
+    // 首次初始化时一次性添加钢琴Sound，之后不再移除
     if (!soundsInitialized)
     {
-        // 添加正弦用的占位Sound
-        dummySound = new DummySound();
-        synth.addSound(dummySound);
-
         // 添加钢琴Sound：异步加载避免阻塞UI
         pianoSound = new PianoSound();
         synth.addSound(pianoSound);
         
-        juce::File sfzFile = getSFZFile();
-        if (sfzFile.exists())
+        auto storage = appState->audio.pianoSampleStorage;
+        if (storage == AppState::pianoStorageAuto)
+            storage = juce::SystemStats::getMemorySizeInMegabytes() < LOW_MEMORY_DEVICE_MB ? AppState::pianoStorageCompressed
+                                                                                           : AppState::pianoStorageFloat;
+        pianoSound->setStorageMode(storage == AppState::pianoStorageCompressed ? PianoSound::storageCompressed
+                                                                               : PianoSound::storageFloat);
+        publishedPianoSound.store(pianoSound, std::memory_order_release);
+        
+        juce::File instrumentFile = getPianoInstrumentFile();
+        if (instrumentFile.exists())
         {
+            // 按练习音域的优先级逐个 region 发布，第一个音符只需等一个 region 解码；
+            // 钢琴的响度补偿表在全部加载完成后测量，之前发声的键不做补偿
             DBG("Starting async SFZ loading to avoid UI blocking");
-            pianoSound->loadSFZAsync(sfzFile, [this](bool completed, int progress, int loadedSamples) {
+            pianoSound->loadSFZAsync(instrumentFile, [this](bool completed, int progress, int loadedSamples) {
                 if (completed)
                 {
                     DBG("[Preload] SFZ piano samples preloaded");
+                    measureLoudness(AppState::timbrePiano);
+                    pianoLoudnessMeasured = true;
                 }
                 else
                 {
                     DBG("[Preload] Loading progress: " + juce::String(progress) + "% (" + juce::String(loadedSamples) + " samples)");
                 }
-            });
+            }, getPianoLoadingPriority());
         }
         else
         {
             DBG("Initial attach: SFZ file not found, piano sound will be silent");
         }
 
+        // 波表 Sound：内置波表在构造时一次性生成，所有波表 Voice 共享
+        wavetableSound = new WavetableSound();
+        synth.addSound(wavetableSound);
+        
+        // 加法合成 Sound：只保存分音表，每个 Voice 起音时复制
+        additiveSound = new AdditiveSound();
+        synth.addSound(additiveSound);
+        
+        // 弦模型 Sound：只有按音符的参数表，不需要样本
+        stringSound = new StringModelSound();
+        synth.addSound(stringSound);
+
         soundsInitialized = true;
     }
     
-    if (appState->audio.isPianoMode)
-    {
-        // 钢琴模式：仅添加钢琴 Voices（PianoSound 已常驻）
-        DBG("Setting up piano mode with SFZ samples");
-        if (dummySound) dummySound->setEnabled(false);
-        if (pianoSound) pianoSound->setEnabled(true);
-        for (int i = 0; i < 8; ++i)
-            synth.addVoice(new PianoVoice());
-        DBG("Piano mode setup complete");
-    }
-    else
+    const auto timbre = appState->audio.timbre;
+    if (pianoSound) pianoSound->setEnabled(timbre == AppState::timbrePiano);
+    if (wavetableSound)
     {
-        // 正弦波模式：仅添加正弦 Voices（DummySound 已常驻）
-        DBG("Setting up sine mode");
-        if (dummySound) dummySound->setEnabled(true);
-        if (pianoSound) pianoSound->setEnabled(false);
-        for (int i = 0; i < 8; ++i)
-            synth.addVoice(new SineVoice());
+        wavetableSound->setEnabled(isWavetableTimbre(timbre));
+        wavetableSound->setWaveform(getWaveformForTimbre(timbre));
     }
+    if (additiveSound) additiveSound->setEnabled(timbre == AppState::timbreAdditive);
+    if (stringSound) stringSound->setEnabled(timbre == AppState::timbreString);
     
-    // 应用当前音量设置
-    if (!appState->audio.isSwitchingTimbre) {
-        appState->audio.targetVolume = appState->audio.masterVolume;
-        appState->audio.currentFadeVolume = 1.0f;
-        applyVolumeToVoices(appState->audio.masterVolume);
-    }
+    // 正弦波由 OscillatorBank 发声，合成器不保留 Voice；钢琴与波表音色只添加各自的 Voice
+    addVoicesForCurrentTimbre(polyphony);
+    DBG(juce::String(getTimbreName(timbre)) + " timbre setup complete");
+    
+    applyLoudnessTablesToVoices();
     
     DBG("Synthesiser setup completed");
 }
 
 void AudioController::setMasterVolume(float volume)
 {
-    appState->audio.targetVolume = volume;
+    // 音频线程在下一个块开始时取用新目标，逐样本平滑过渡
     appState->audio.masterVolume = volume;
-    
-    if (!appState->audio.isSwitchingTimbre) {
-        appState->audio.currentFadeVolume = 1.0f;
-        applyVolumeToVoices(volume);
-    }
+    targetMasterGain.store(volume);
     
     appState->notifyAudioStateChanged();
 }
 
-void AudioController::applyVolumeToVoices(float volume)
+void AudioController::setVolumeSmoothingTime(float milliseconds)
 {
-    float effectiveVolume = volume * appState->audio.currentFadeVolume;
-    const juce::ScopedLock sl (synthMutex);
-    // 为了匹配两种音色的主观响度，适当降低正弦波音色的电平
-    constexpr float kSineLoudnessScale = 0.55f; // 调整此系数以微调两种音色的相对音量
-    for (int i = 0; i < synth.getNumVoices(); ++i)
+    milliseconds = juce::jlimit(0.0f, AppState::AudioState::MAX_VOLUME_SMOOTHING_MS, milliseconds);
+    appState->audio.volumeSmoothingMs = milliseconds;
+    volumeSmoothingMs.store(milliseconds);
+}
+
+float AudioController::getVolumeSmoothingTime() const
+{
+    return volumeSmoothingMs.load();
+}
+
+void AudioController::setRoomLevel(float level)
+{
+    level = juce::jlimit(0.0f, 1.0f, level);
+    appState->audio.roomLevel = level;
+    roomConvolution.setWetLevel(level);
+}
+
+float AudioController::getRoomLevel() const
+{
+    return roomConvolution.getWetLevel();
+}
+
+bool AudioController::loadRoomImpulseResponse(const juce::File& file)
+{
+    // 文件检查在调用线程，读取与重采样在卷积的后台线程
+    return roomConvolution.loadImpulseResponse(file);
+}
+
+void AudioController::setReverbRoomSize(float size)
+{
+    reverb.setRoomSize(size);
+    appState->audio.reverbRoomSize = reverb.getRoomSize();
+}
+
+void AudioController::setReverbDamping(float damping)
+{
+    reverb.setDamping(damping);
+    appState->audio.reverbDamping = reverb.getDamping();
+}
+
+void AudioController::setReverbMix(float mix)
+{
+    reverb.setMix(mix);
+    appState->audio.reverbMix = reverb.getMix();
+}
+
+void AudioController::setLimiterLookahead(float milliseconds)
+{
+    limiter.setLookahead(milliseconds);
+    appState->audio.limiterLookaheadMs = limiter.getLookahead();
+}
+
+void AudioController::setVoiceCullingFloor(float decibels)
+{
+    // 音频线程在下一个块开始时按当前主音量换算并下发
+    appState->audio.voiceCullingFloorDb = juce::jlimit(MIN_CULLING_FLOOR_DB, MAX_CULLING_FLOOR_DB, decibels);
+    cullingFloorGain.store(juce::Decibels::decibelsToGain(appState->audio.voiceCullingFloorDb, MIN_CULLING_FLOOR_DB));
+}
+
+juce::Array<int> AudioController::getPianoLoadingPriority() const
+{
+    juce::Array<int> keys;
+    const auto& activeSemitones = appState->interaction.customSemitones;
+    for (int octave = PlaybackEngine::MIN_OCTAVE; octave < PlaybackEngine::MIN_OCTAVE + PlaybackEngine::NUM_OCTAVES; ++octave)
+        for (int semitone = 0; semitone < 12; ++semitone)
+            if (semitone < activeSemitones.size() && activeSemitones[semitone])
+                keys.add(octave * 12 + semitone);
+    
+    for (int key = PlaybackEngine::MIN_OCTAVE * 12; key < (PlaybackEngine::MIN_OCTAVE + PlaybackEngine::NUM_OCTAVES) * 12; ++key)
+        keys.addIfNotAlreadyThere(key);
+    return keys;
+}
+
+void AudioController::measureLoudness(AppState::Timbre timbre)
+{
+    // 用独立的 Voice 逐键渲染（不持锁，共享的 Sound 只被读取），测量完成后在锁内替换补偿表
+    PianoSound* piano = nullptr;
+    WavetableSound* wavetable = nullptr;
+    AdditiveSound* additive = nullptr;
+    StringModelSound* string = nullptr;
+    {
+        const juce::ScopedLock sl (synthMutex);
+        piano = pianoSound;
+        wavetable = wavetableSound;
+        additive = additiveSound;
+        string = stringSound;
+    }
+    
+    const double sampleRate = currentSampleRate;
+    LoudnessTable table;
+    if (timbre == AppState::timbreSine)
     {
-        if (auto* sineVoice = dynamic_cast<SineVoice*>(synth.getVoice(i)))
+        auto bank = std::make_unique<OscillatorBank>();
+        bank->prepare(sampleRate);
+        bank->setPolyphony(1);
+        bank->setVolume(1.0f);
+        table = LoudnessTable::measure([&bank, this](int midiNote, float velocity, juce::AudioBuffer<float>& buffer)
         {
-            sineVoice->setVolume(effectiveVolume * kSineLoudnessScale);
-        }
-        else if (auto* pianoVoice = dynamic_cast<PianoVoice*>(synth.getVoice(i)))
+            bank->reset();
+            bank->noteOn(midiNote, velocity);
+            bank->renderNextBlock(buffer, noMidi, 0, buffer.getNumSamples());
+        }, sampleRate);
+    }
+    else if (timbre == AppState::timbrePiano && piano != nullptr)
+    {
+        table = LoudnessTable::measureVoice(std::make_unique<PianoVoice>(), *piano, sampleRate);
+    }
+    else if (timbre == AppState::timbreAdditive && additive != nullptr)
+    {
+        table = LoudnessTable::measureVoice(std::make_unique<AdditiveVoice>(), *additive, sampleRate);
+    }
+    else if (timbre == AppState::timbreString && string != nullptr)
+    {
+        table = LoudnessTable::measureVoice(std::make_unique<StringModelVoice>(), *string, sampleRate);
+    }
+    else if (isWavetableTimbre(timbre) && wavetable != nullptr)
+    {
+        auto voice = std::make_unique<WavetableVoice>();
+        voice->setWavetableOverride(wavetable->getWavetable(getWaveformForTimbre(timbre)));
+        table = LoudnessTable::measureVoice(std::move(voice), *wavetable, sampleRate);
+    }
+    else
+    {
+        return;
+    }
+    
+    const juce::ScopedLock sl (synthMutex);
+    loudnessTables[timbre] = table;
+    DBG(juce::String(getTimbreName(timbre)) + " loudness offsets: A0 " + juce::String(table.getOffsetDb(21), 2)
+        + " dB, C4 " + juce::String(table.getOffsetDb(60), 2) + " dB, C8 " + juce::String(table.getOffsetDb(108), 2) + " dB");
+}
+
+void AudioController::requestLoudnessMeasurement(AppState::Timbre timbre)
+{
+    pendingLoudness.fetch_or(1u << timbre);
+    
+    // startThread 内部加锁，多个线程同时请求时只启动一次
+    if (!loudnessThread->isThreadRunning())
+        loudnessThread->startThread();
+    loudnessThread->notify();
+}
+
+bool AudioController::isLoudnessMeasurementPending() const
+{
+    return pendingLoudness.load() != 0 || measuringLoudness.load();
+}
+
+void AudioController::runLoudnessThread()
+{
+    while (!loudnessThread->threadShouldExit())
+    {
+        measuringLoudness = true;
+        const uint32_t pending = pendingLoudness.exchange(0);
+        for (int timbre = 0; timbre < AppState::numTimbres && !loudnessThread->threadShouldExit(); ++timbre)
         {
-            pianoVoice->setVolume(effectiveVolume);
+            if ((pending & (1u << timbre)) == 0)
+                continue;
+            
+            measureLoudness((AppState::Timbre) timbre);
+            if (timbre == AppState::timbrePiano)
+                pianoLoudnessMeasured = true;
         }
+        measuringLoudness = false;
+        
+        if (pendingLoudness.load() == 0)
+            loudnessThread->wait(-1);
+    }
+}
+
+void AudioController::applyLoudnessTablesToVoices()
+{
+    const juce::ScopedLock sl (synthMutex);
+    // 各音色、各音区的响度差异由按键补偿表抵消（正弦音色同样经过补偿），Voice 本身不再缩放
+    const auto* table = &loudnessTables[appState->audio.timbre];
+    oscillatorBank.setVolume(1.0f);
+    oscillatorBank.setLoudnessTable(table);
+    
+    // 合成器中只有引擎自己添加的 EarxVoice
+    for (int i = 0; i < synth.getNumVoices(); ++i)
+    {
+        auto* voice = static_cast<EarxVoice*>(synth.getVoice(i));
+        voice->setVolume(1.0f);
+        voice->setLoudnessTable(table);
     }
+    appliedFloorGain = -1.0f;
 }
 
-void AudioController::startTimbreFadeOut(bool targetIsPianoMode)
+void AudioController::startTimbreFadeOut(AppState::Timbre targetTimbre)
 {
     appState->audio.isSwitchingTimbre = true;
     appState->audio.pendingTimbreSwitch = true;
-    appState->audio.nextIsPianoMode = targetIsPianoMode;
-    appState->audio.currentFadeVolume = 1.0f;
+    appState->audio.nextTimbre = targetTimbre;
     
-    DBG("Starting fade out, current volume: " + juce::String(appState->audio.currentFadeVolume));
+    DBG("Starting fade out");
 }
 
 void AudioController::performTimbreSwitch()
@@ -174,9 +802,9 @@ void AudioController::performTimbreSwitch()
     // 停止所有正在播放的音符
     stopAllNotes();
     // 在音频线程中完成真正的音色切换，避免点击
-    appState->audio.isPianoMode = appState->audio.nextIsPianoMode;
+    appState->audio.timbre = appState->audio.nextTimbre;
     setupSynthesiser();
-    DBG("Timbre switched to: " + juce::String(appState->audio.isPianoMode ? "Piano" : "Sine"));
+    DBG("Timbre switched to: " + juce::String(getTimbreName(appState->audio.timbre)));
     
     // 开始淡入
     startTimbreFadeIn();
@@ -185,198 +813,118 @@ void AudioController::performTimbreSwitch()
 void AudioController::startTimbreFadeIn()
 {
     appState->audio.pendingTimbreSwitch = false;
-    appState->audio.currentFadeVolume = 0.0f;
+    fadeGain.setTargetValue(1.0f);
     
     DBG("Starting fade in");
 }
 
 void AudioController::updateFadeTransition()
 {
+    // 音频线程在块开始时调用；fadeGain 在 applyMasterGain 中逐样本推进，淡入淡出时长与缓冲区大小无关
     if (!appState->audio.isSwitchingTimbre) return;
     
+    const juce::ScopedLock sl (synthMutex);
     if (appState->audio.pendingTimbreSwitch)
     {
-        // 淡出阶段
-        appState->audio.currentFadeVolume -= appState->audio.FADE_STEP;
-        
-        if (appState->audio.currentFadeVolume <= 0.0f)
+        // 淡出阶段：上一块已淡到 0 时执行音色切换
+        if (fadeGain.getTargetValue() > 0.0f)
         {
-            appState->audio.currentFadeVolume = 0.0f;
-            applyVolumeToVoices(appState->audio.targetVolume);
-            
-            // 淡出完成，执行音色切换
-            performTimbreSwitch();
+            fadeGain.setTargetValue(0.0f);
         }
-        else
+        else if (!fadeGain.isSmoothing())
         {
-            applyVolumeToVoices(appState->audio.targetVolume);
+            performTimbreSwitch();
         }
     }
-    else
+    else if (!fadeGain.isSmoothing())
     {
-        // 淡入阶段
-        appState->audio.currentFadeVolume += appState->audio.FADE_STEP;
+        // 淡入完成，结束切换过程
+        appState->audio.isSwitchingTimbre = false;
+        DBG("Smooth timbre switch completed");
         
-        if (appState->audio.currentFadeVolume >= 1.0f)
-        {
-            appState->audio.currentFadeVolume = 1.0f;
-            applyVolumeToVoices(appState->audio.targetVolume);
-            
-            // 淡入完成，结束切换过程
-            appState->audio.isSwitchingTimbre = false;
-            DBG("Smooth timbre switch completed");
-            
-            appState->notifyAudioStateChanged();
-        }
-        else
-        {
-            applyVolumeToVoices(appState->audio.targetVolume);
-        }
+        appState->notifyAudioStateChanged();
     }
 }
 
-void AudioController::playNote(int midiNote, float velocity)
+juce::int64 AudioController::playNote(int midiNote, float velocity)
 {
     // 检查MIDI输出是否启用
     if (!appState->system.midiOutputEnabled)
     {
         DBG("MIDI output disabled, ignoring note: " + juce::String(midiNote));
-        return;
+        return -1;
     }
     const juce::ScopedLock sl (synthMutex);
-    synth.noteOn(1, midiNote, velocity);
+    if (appState->audio.timbre == AppState::timbreSine)
+        oscillatorBank.noteOn(midiNote, velocity);
+    else
+        synth.noteOn(1, midiNote, velocity);
+    idle = false;
+    quietSamples = 0;
+    
+    // 音符从下一个渲染块的第一个样本开始发声
+    return renderedSamples;
 }
 
 void AudioController::stopNote(int midiNote)
 {
     const juce::ScopedLock sl (synthMutex);
     synth.noteOff(1, midiNote, 0.0f, true); // 允许淡出
+    oscillatorBank.noteOff(midiNote);
 }
 
 void AudioController::stopAllNotes()
 {
     const juce::ScopedLock sl (synthMutex);
+    numScheduledEvents = 0; // 尚未触发的定时音符一并取消
     synth.allNotesOff(1, true); // 允许淡出
+    oscillatorBank.allNotesOff(true);
 }
 
-juce::File AudioController::getSFZFile() const
+juce::File AudioController::getPianoInstrumentFile() const
 {
-    DBG("=== getSFZFile() called ===");
+    // 每个候选目录先找打包乐器文件（一次打开、一次映射），再找 SFZ + 样本目录；只检查文件是否存在，不列目录
+    const juce::String sfzPath = "AccurateSalamanderGrandPianoV6.0_48khz16bit/sfz/"
+                                 "Accurate-SalamanderGrandPiano_flat.Recommended_vel9_dry_flac_48_84.sfz";
+    const juce::String packName = juce::String("AccurateSalamanderGrandPiano") + InstrumentPack::FILE_EXTENSION;
+    juce::Array<juce::File> candidates;
+    auto addDirectory = [&](const juce::File& directory)
+    {
+        candidates.add(directory.getChildFile(packName));
+        candidates.add(directory.getChildFile(sfzPath));
+    };
     
-    // iOS真机优先：尝试从app bundle获取资源
     #if JUCE_IOS
+    // iOS：app bundle（保留目录层级的蓝色文件夹）、以“创建组”方式添加时被扁平化到 bundle 根目录的 SFZ、
+    // Resources、Flutter 资产目录（flutter_assets 或 flutter_assets/assets），最后是可写目录（可通过 Files / iTunes 拷入）
     juce::File bundleDir = juce::File::getSpecialLocation(juce::File::currentApplicationFile);
-    DBG("Bundle directory: " + bundleDir.getFullPathName());
-    
-    // 列出bundle根目录内容
-    juce::Array<juce::File> bundleContents;
-    bundleDir.findChildFiles(bundleContents, juce::File::findFilesAndDirectories, false);
-    DBG("Bundle root contents (" + juce::String(bundleContents.size()) + " items):");
-    for (auto& file : bundleContents) {
-        DBG("  - " + file.getFileName() + (file.isDirectory() ? " (dir)" : " (file)"));
-    }
-    
-    // 常规：保留目录层级的蓝色文件夹
-    {
-        juce::File bundleSFZ = bundleDir
-            .getChildFile("AccurateSalamanderGrandPianoV6.0_48khz16bit")
-            .getChildFile("sfz")
-            .getChildFile("Accurate-SalamanderGrandPiano_flat.Recommended_vel9_dry_flac_48_84.sfz");
-        DBG("Checking bundle SFZ path: " + bundleSFZ.getFullPathName());
-        if (bundleSFZ.exists()) {
-            DBG("Found SFZ in app bundle: " + bundleSFZ.getFullPathName());
-            return bundleSFZ;
-        }
-    }
-
-    // 特殊：若以“创建组（黄色文件夹）”方式添加，可能被扁平化到根目录
-    {
-        juce::File flatSFZ = bundleDir.getChildFile("Accurate-SalamanderGrandPiano_flat.Recommended_vel9_dry_flac_48_84.sfz");
-        if (flatSFZ.exists()) {
-            DBG("Found flat SFZ in bundle root: " + flatSFZ.getFullPathName());
-            return flatSFZ;
-        }
-    }
-    
-    DBG("SFZ not found in bundle structure, trying Resources directory...");
+    auto flutterAssets = bundleDir.getChildFile("Frameworks").getChildFile("App.framework").getChildFile("flutter_assets");
+    addDirectory(bundleDir);
+    candidates.add(bundleDir.getChildFile(juce::File(sfzPath).getFileName()));
+    addDirectory(bundleDir.getChildFile("Resources"));
+    addDirectory(flutterAssets);
+    addDirectory(flutterAssets.getChildFile("assets"));
+    addDirectory(juce::File::getSpecialLocation(juce::File::userDocumentsDirectory));
+    addDirectory(juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory));
+    #endif
     
-    // 尝试从Resources目录获取
-    juce::File resourcesDir = bundleDir.getChildFile("Resources");
-    DBG("Resources directory: " + resourcesDir.getFullPathName());
-    DBG("Resources directory exists: " + juce::String(resourcesDir.exists() ? "true" : "false"));
+    // 开发环境回退：源码目录
+    juce::File sourceDir = juce::File(__FILE__).getParentDirectory();
+    addDirectory(sourceDir);
     
-    if (resourcesDir.exists()) {
-        juce::Array<juce::File> resourcesContents;
-        resourcesDir.findChildFiles(resourcesContents, juce::File::findFilesAndDirectories, false);
-        DBG("Resources contents (" + juce::String(resourcesContents.size()) + " items):");
-        for (auto& file : resourcesContents) {
-            DBG("  - " + file.getFileName() + (file.isDirectory() ? " (dir)" : " (file)"));
-        }
-        
-        juce::File resourcesSFZ = resourcesDir
-            .getChildFile("AccurateSalamanderGrandPianoV6.0_48khz16bit")
-            .getChildFile("sfz")
-            .getChildFile("Accurate-SalamanderGrandPiano_flat.Recommended_vel9_dry_flac_48_84.sfz");
-            
-        if (resourcesSFZ.exists()) {
-            DBG("Found SFZ in Resources: " + resourcesSFZ.getFullPathName());
-            return resourcesSFZ;
+    for (const auto& candidate : candidates)
+    {
+        if (candidate.existsAsFile())
+        {
+            DBG("Found piano instrument: " + candidate.getFullPathName());
+            return candidate;
         }
     }
-    // 再尝试：Flutter 资产目录 (Runner.app/Frameworks/App.framework/flutter_assets/...)
-    {
-        auto flutterAssets = bundleDir
-            .getChildFile("Frameworks")
-            .getChildFile("App.framework")
-            .getChildFile("flutter_assets");
-        DBG("Flutter assets dir: " + flutterAssets.getFullPathName() + ", exists=" + juce::String(flutterAssets.exists() ? "true" : "false"));
-
-        // 允许两种布局：直接放在 flutter_assets/Accurate... 或 flutter_assets/assets/Accurate...
-        juce::File fa1 = flutterAssets
-            .getChildFile("AccurateSalamanderGrandPianoV6.0_48khz16bit")
-            .getChildFile("sfz")
-            .getChildFile("Accurate-SalamanderGrandPiano_flat.Recommended_vel9_dry_flac_48_84.sfz");
-        juce::File fa2 = flutterAssets
-            .getChildFile("assets")
-            .getChildFile("AccurateSalamanderGrandPianoV6.0_48khz16bit")
-            .getChildFile("sfz")
-            .getChildFile("Accurate-SalamanderGrandPiano_flat.Recommended_vel9_dry_flac_48_84.sfz");
-        if (fa1.exists()) { DBG("Found SFZ in flutter_assets: " + fa1.getFullPathName()); return fa1; }
-        if (fa2.exists()) { DBG("Found SFZ in flutter_assets/assets: " + fa2.getFullPathName()); return fa2; }
-    }
-
-    // 最后尝试：应用可写目录（可通过 Files / iTunes 拷入）
-    {
-        auto docs = juce::File::getSpecialLocation(juce::File::userDocumentsDirectory);
-        juce::File docsSFZ = docs
-            .getChildFile("AccurateSalamanderGrandPianoV6.0_48khz16bit")
-            .getChildFile("sfz")
-            .getChildFile("Accurate-SalamanderGrandPiano_flat.Recommended_vel9_dry_flac_48_84.sfz");
-        DBG("Documents dir: " + docs.getFullPathName() + ", candidate: " + docsSFZ.getFullPathName());
-        if (docsSFZ.exists()) { DBG("Found SFZ in Documents"); return docsSFZ; }
-
-        auto appData = juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory);
-        juce::File dataSFZ = appData
-            .getChildFile("AccurateSalamanderGrandPianoV6.0_48khz16bit")
-            .getChildFile("sfz")
-            .getChildFile("Accurate-SalamanderGrandPiano_flat.Recommended_vel9_dry_flac_48_84.sfz");
-        DBG("ApplicationSupport dir: " + appData.getFullPathName() + ", candidate: " + dataSFZ.getFullPathName());
-        if (dataSFZ.exists()) { DBG("Found SFZ in ApplicationSupport"); return dataSFZ; }
-    }
-    #endif
     
-    // 开发环境回退：使用源码目录
-    DBG("Using source directory fallback");
-    juce::File sourceDir = juce::File(__FILE__).getParentDirectory();
-    juce::File sourceSFZ = sourceDir
-        .getChildFile("AccurateSalamanderGrandPianoV6.0_48khz16bit")
-        .getChildFile("sfz")
-        .getChildFile("Accurate-SalamanderGrandPiano_flat.Recommended_vel9_dry_flac_48_84.sfz");
-    
-    DBG("Source SFZ exists: " + juce::String(sourceSFZ.exists() ? "true" : "false"));
-    DBG("Using source directory SFZ: " + sourceSFZ.getFullPathName());
-    return sourceSFZ;
-} 
+    DBG("Piano instrument not found, using source directory SFZ path");
+    return sourceDir.getChildFile(sfzPath);
+}
+
 void AudioController::preloadPianoSamples()
 {
     // 现在由 setupSynthesiser() 中的异步加载处理，这个方法已不需要
@@ -391,5 +939,27 @@ bool AudioController::arePianoSamplesLoaded() const
         return false;
     }
     
-    return pianoSound->isLoaded();
+    return pianoSound->isLoaded() && pianoLoudnessMeasured.load();
+}
+
+bool AudioController::isPianoNoteLoaded(int midiNote) const
+{
+    const juce::ScopedLock sl(synthMutex);
+    return soundsInitialized && pianoSound != nullptr && pianoSound->isNoteLoaded(midiNote);
+}
+
+AppState::PianoSampleStorage AudioController::getPianoSampleStorage() const
+{
+    const juce::ScopedLock sl(synthMutex);
+    if (pianoSound == nullptr)
+        return appState->audio.pianoSampleStorage;
+    return pianoSound->getStorageMode() == PianoSound::storageCompressed ? AppState::pianoStorageCompressed
+                                                                         : AppState::pianoStorageFloat;
+}
+
+size_t AudioController::getPianoSampleMemoryBytes() const
+{
+    // 不取 synthMutex：Sound 指针与内存计数都是原子量
+    const auto* piano = publishedPianoSound.load(std::memory_order_acquire);
+    return piano != nullptr ? piano->getSampleMemoryBytes() : 0;
 }
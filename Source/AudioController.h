@@ -5,18 +5,31 @@
 #include <juce_audio_utils/juce_audio_utils.h>
 #include <juce_core/juce_core.h>
 #include "AppState.h"  // 完整包含而不是前向声明
+#include "AdditiveSound.h"
+#include "AdditiveVoice.h"
 #include "PianoSound.h"
 #include "PianoVoice.h"
-#include "SineVoice.h"
-#include "DummySound.h"
+#include "StringModelSound.h"
+#include "StringModelVoice.h"
+#include "WavetableSound.h"
+#include "WavetableVoice.h"
+#include "EarxSynthesiser.h"
+#include "OscillatorBank.h"
+#include "RoomConvolution.h"
+#include "FdnReverb.h"
+#include "TruePeakLimiter.h"
+#include "OutputResampler.h"
+#include "LoudnessTable.h"
 
 /**
  * 音频控制器 - 负责管理所有音频相关逻辑
  * 职责：
- * - 合成器设置和管理
- * - 音色切换（Piano/Sine）
- * - 音量控制和淡入淡出
+ * - 合成器设置和管理（钢琴、波表、加法合成与弦模型音色走 juce::Synthesiser，正弦波走 OscillatorBank）
+ * - 音色切换（AppState::Timbre）
+ * - 音量控制和淡入淡出，主总线上的房间卷积、FDN 混响与真峰值限幅
+ * - 引擎内部固定以 INTERNAL_SAMPLE_RATE 渲染，设备采样率不同时在主总线最后一级统一转换
  * - 音符播放和停止
+ * - 复音数（Voice 池）管理与渲染开销测量
  */
 class AudioController
 {
@@ -24,51 +37,250 @@ public:
     AudioController(AppState* appState);
     ~AudioController();
     
-    // 初始化音频系统
-    void initialize(double sampleRate);
+    // 内部采样率（钢琴样本的采样率）：Voice、总线处理、音频时钟与定时音符都以此计，音色与设备无关
+    static constexpr double INTERNAL_SAMPLE_RATE = 48000.0;
     
-    // 音频渲染
+    // 初始化音频系统（deviceSampleRate 为设备采样率）
+    void initialize(double deviceSampleRate);
+    
+    // 设备采样率变化时只重新配置输出采样率转换（需与渲染串行调用，例如在设备启动回调中）
+    void setDeviceSampleRate(double sampleRate);
+    double getDeviceSampleRate() const { return deviceSampleRate.load(); }
+    
+    // 音频渲染（numSamples 为设备采样率下的样本数）
     void renderNextBlock(juce::AudioBuffer<float>& buffer, 
                         const juce::MidiBuffer& midiBuffer,
                         int startSample, int numSamples);
     
     // 音色管理
-    void switchTimbre(bool isPianoMode);
+    void switchTimbre(AppState::Timbre timbre);
     void setupSynthesiser();
     void preloadPianoSamples();
     
-    // 音量控制
+    // 加载用户单周期波形作为 timbreUserWavetable 的波表（在调用线程生成，不在音频线程调用）
+    bool loadUserWavetable(const juce::File& file);
+    
+    // 加法合成音色的分音表（下一个音符开始生效）
+    void setPartialProfile(const AdditiveSound::Profile& profile);
+    AdditiveSound::Profile getPartialProfile() const;
+    
+    // 是否仍有响度补偿表在后台测量（测量完成前发声的音符沿用旧表）
+    bool isLoudnessMeasurementPending() const;
+    
+    // 音量控制：主音量作用在混合后的总线上，按样本线性平滑（平滑时间 0 - MAX_VOLUME_SMOOTHING_MS 毫秒）
     void setMasterVolume(float volume);
-    void applyVolumeToVoices(float volume);
+    void setVolumeSmoothingTime(float milliseconds);
+    float getVolumeSmoothingTime() const;
+    
+    // 房间卷积（主总线，湿声电平 0 - 1，为 0 时整级旁路）；脉冲响应在后台加载，准备好后无缝切换
+    void setRoomLevel(float level);
+    float getRoomLevel() const;
+    bool loadRoomImpulseResponse(const juce::File& file);
+    double getRoomCpuLoad() const { return roomConvolution.getCpuLoad(); }
+    
+    // FDN 算法混响（主总线，比房间卷积便宜）：房间大小、阻尼、湿声电平均为 0 - 1，湿声为 0 时整级旁路
+    void setReverbRoomSize(float size);
+    void setReverbDamping(float damping);
+    void setReverbMix(float mix);
+    float getReverbRoomSize() const { return reverb.getRoomSize(); }
+    float getReverbDamping() const { return reverb.getDamping(); }
+    float getReverbMix() const { return reverb.getMix(); }
+    
+    // 主总线最后一级的预读真峰值限幅器（上限 -1 dBTP），预读时长即附加的输出延迟
+    void setLimiterLookahead(float milliseconds);
+    float getLimiterLookahead() const { return limiter.getLookahead(); }
+    TruePeakLimiter::Stats getLimiterStats() const { return limiter.getStats(); }
+    void resetLimiterStats() { limiter.resetStats(); }
     
     // 平滑音色切换
-    void startTimbreFadeOut(bool targetIsPianoMode);
+    void startTimbreFadeOut(AppState::Timbre targetTimbre);
     void performTimbreSwitch();
     void startTimbreFadeIn();
     void updateFadeTransition();
     
-    // 音符播放
-    void playNote(int midiNote, float velocity);
+    // 音符播放：返回该音符在音频时钟上的起始样本位置（未发声时返回 -1）
+    juce::int64 playNote(int midiNote, float velocity);
     void stopNote(int midiNote);
     void stopAllNotes();
     
-    // 获取合成器引用（用于MainComponent的getNextAudioBlock）
+    // 定时音符：从下一个渲染块开始计 delaySamples 后发声，持续 durationSamples 后松开
+    // 事件在所在渲染块内以样本精度触发（经 MidiBuffer 交给合成器），返回起始样本位置
+    // 队列容量为 MAX_SCHEDULED_EVENTS 个事件，每个音符占两个（按下与松开）
+    static constexpr int MAX_SCHEDULED_EVENTS = 256;
+    juce::int64 scheduleNote(int midiNote, float velocity, int delaySamples, int durationSamples);
+    
+    // 一组定时音符：第 i 个音符在 delaySamples + i * spacingSamples 处发声（spacingSamples 为 0 时同时发声）；
+    // 在同一次加锁内以同一个时钟读数排队，队列放不下整组时一个也不排，返回第一个音符的起始样本位置
+    juce::int64 scheduleNotes(const int* midiNotes, int numNotes, float velocity, int delaySamples,
+                              int spacingSamples, int durationSamples);
+    
+    // 复音数：新增的 Voice 使用当前音色（会分配内存，不在音频线程调用）
+    // setPolyphony 设置 Voice 池大小（1 - MAX_POLYPHONY），ensurePolyphony 只增不减
+    static constexpr int MAX_POLYPHONY = EarxSynthesiser::MAX_POLYPHONY;
+    static constexpr int DEFAULT_POLYPHONY = 16;
+    void setPolyphony(int numVoices);
+    void ensurePolyphony(int numVoices);
+    int getPolyphony() const;
+    
+    // 由实测渲染开销估算的可持续复音数（尚未测得时返回 0）
+    int getMaxSustainablePolyphony() const { return maxSustainablePolyphony.load(); }
+    juce::int64 getNumVoicesStolen() const;
+    
+    // Voice 可闻下限（dB，相对最终输出满幅、计入主音量，MIN_CULLING_FLOOR_DB - MAX_CULLING_FLOOR_DB）：
+    // 采样钢琴按加载时计算的幅度包络，在剩余输出峰值低于下限时提前结束；MIN_CULLING_FLOOR_DB 表示不剔除
+    static constexpr float MIN_CULLING_FLOOR_DB = -100.0f;
+    static constexpr float MAX_CULLING_FLOOR_DB = -30.0f;
+    void setVoiceCullingFloor(float decibels);
+    float getVoiceCullingFloor() const { return appState->audio.voiceCullingFloorDb; }
+    
+    // 空闲统计：没有活动 Voice、没有待触发的定时音符且不在切换音色，持续 IDLE_GRACE_MS 后进入空闲，
+    // 空闲时渲染只清零输出并推进音频时钟，不经过合成器；新音符或块内的外部 MIDI 事件立即退出空闲
+    struct IdleStats
+    {
+        juce::int64 idleSamples = 0;    // 累计以空闲快速路径渲染的样本数
+        juce::int64 totalSamples = 0;   // 累计渲染的样本数
+        bool idle = false;
+    };
+    IdleStats getIdleStats() const;
+    
+    // 获取合成器引用（用于MainComponent的getNextAudioBlock；正弦音色不经过该合成器）
     juce::Synthesiser& getSynthesiser() { return synth; }
     
-    // 采样加载状态查询
+    // 采样加载状态查询（样本加载完成且钢琴的响度补偿表已测量）
     bool arePianoSamplesLoaded() const;
+    // 单个键的样本是否已可用（加载过程中按优先级逐键变为可用）
+    bool isPianoNoteLoaded(int midiNote) const;
+    
+    // 钢琴样本存储方式：AppState::audio.pianoSampleStorage 为 pianoStorageAuto 时，物理内存低于 LOW_MEMORY_DEVICE_MB
+    // 的设备以压缩块存放样本。getPianoSampleStorage 返回实际采用的方式（pianoStorageFloat / pianoStorageCompressed），
+    // getPianoSampleMemoryBytes 返回已加载样本占用的内存（加载过程中随 region 累加，只读原子量，不取 synthMutex）
+    static constexpr int LOW_MEMORY_DEVICE_MB = 3072;
+    AppState::PianoSampleStorage getPianoSampleStorage() const;
+    size_t getPianoSampleMemoryBytes() const;
+    
+    // 音频时钟：以已渲染的样本数计时，音符起始时刻由此得到样本级精度
+    juce::int64 getAudioClockPosition() const;
+    double getSampleRate() const { return currentSampleRate; }
+    
+    // 输出延迟（内部采样率下的样本数）：设备延迟 + 一个缓冲区（由设备初始化时按设备采样率设置），
+    // 加上限幅器的预读延迟与采样率转换的群延迟
+    void setOutputLatencySamples(int deviceLatencySamples) { outputLatencySamples = deviceLatencySamples; }
+    int getOutputLatencySamples() const;
+    
+    // 音频时钟位置与高精度毫秒计时（juce::Time::getMillisecondCounterHiRes）之间的换算，
+    // 以最近一次渲染块的开始时刻为锚点
+    double audioClockToHostTimeMs(juce::int64 samplePosition) const;
     
 private:
     AppState* appState;
-    juce::Synthesiser synth;
+    EarxSynthesiser synth;
+    OscillatorBank oscillatorBank;          // 正弦音色（受 synthMutex 保护）
+    const juce::MidiBuffer noMidi;
     double currentSampleRate = 44100.0;
     bool soundsInitialized = false;
     juce::CriticalSection synthMutex; // 保护对 synth 的并发访问
-    DummySound* dummySound = nullptr;
     PianoSound* pianoSound = nullptr;
+    std::atomic<PianoSound*> publishedPianoSound { nullptr };  // pianoSound 创建后发布，供不取 synthMutex 的读取
+    WavetableSound* wavetableSound = nullptr;
+    AdditiveSound* additiveSound = nullptr;
+    StringModelSound* stringSound = nullptr;
+    
+    // 当前音色的 Voice 数量（钢琴音色切换时按此重建合成器 Voice，受 synthMutex 保护）
+    int polyphony = DEFAULT_POLYPHONY;
+    
+    // 渲染开销测量（音频线程，受 synthMutex 保护）：每个活动 Voice 每个样本的耗时（秒），指数滑动平均
+    static constexpr double RENDER_LOAD_TARGET = 0.5;   // 合成器最多占用实时预算的比例，余下留给系统与其他处理
+    static constexpr int MIN_MEASURED_BLOCKS = 32;      // 测量块数达到后才公布估算值
+    double voiceSampleCostSeconds = 0.0;
+    int measuredBlocks = 0;
+    std::atomic<int> maxSustainablePolyphony { 0 };
+    void updateRenderCost(juce::int64 elapsedTicks, int activeVoices, int numSamples);
+    
+    // 定时音符事件（受 synthMutex 保护），渲染时取出落在本块内的事件
+    struct ScheduledEvent
+    {
+        juce::int64 samplePosition;
+        int midiNote;
+        float velocity; // 0 表示松开
+    };
+    ScheduledEvent scheduledEvents[MAX_SCHEDULED_EVENTS];
+    int numScheduledEvents = 0;
+    juce::MidiBuffer blockMidi;
+    
+    // 总线增益（音频线程，受 synthMutex 保护）= 主音量 × 音色切换淡入淡出，逐样本平滑
+    static constexpr int GAIN_CHUNK = 256;
+    juce::SmoothedValue<float> masterGain { 0.2f };
+    juce::SmoothedValue<float> fadeGain { 1.0f };
+    std::atomic<float> targetMasterGain { 0.2f };
+    std::atomic<float> volumeSmoothingMs { 20.0f };
+    float appliedSmoothingMs = 20.0f;
+    float gainRamp[GAIN_CHUNK] = {};
+    RoomConvolution roomConvolution;
+    FdnReverb reverb;
+    TruePeakLimiter limiter;
+    void applyMasterGain(juce::AudioBuffer<float>& buffer, int startSample, int numSamples);
+    
+    // 以内部采样率渲染一块（合成器 → 总线处理 → 限幅）
+    void renderInternalBlock(juce::AudioBuffer<float>& buffer, const juce::MidiBuffer& midiBuffer,
+                             int startSample, int numSamples);
+    
+    // 输出采样率转换（设备采样率与内部采样率相同时旁路）；内部块与换算后的 MIDI 在 setDeviceSampleRate 中预分配
+    OutputResampler outputResampler;
+    juce::AudioBuffer<float> internalBuffer;
+    juce::MidiBuffer resamplerMidi;
+    std::atomic<double> deviceSampleRate { INTERNAL_SAMPLE_RATE };
+    
+    // 可闻下限按主音量换算到 Voice 输出端，变化时（音量斜坡、下限设置、新增 Voice）才写到各 Voice；
+    // 换算结果不超过 MAX_CULLING_FLOOR_DB，静音时不会结束所有音符
+    std::atomic<float> cullingFloorGain { 0.0f };
+    float appliedFloorGain = -1.0f;
+    void updateAudibilityFloor();
+    
+    // 各音色的按键响度补偿表（受 synthMutex 保护）：合成音色在 initialize 时、用户波表与分音表在更换后
+    // 交给测量线程，钢琴在样本加载完成后于加载线程测量；测量不持锁，完成后在锁内替换
+    LoudnessTable loudnessTables[AppState::numTimbres];
+    std::atomic<bool> pianoLoudnessMeasured { false };
+    void measureLoudness(AppState::Timbre timbre);
+    
+    // 响度测量线程：请求按音色合并成位图，同一音色的多次请求只测最后一次
+    class LoudnessThread : public juce::Thread
+    {
+    public:
+        LoudnessThread(AudioController* owner) : Thread("EarxLoudness"), controller(owner) {}
+        void run() override { controller->runLoudnessThread(); }
+    private:
+        AudioController* controller;
+    };
+    
+    std::unique_ptr<LoudnessThread> loudnessThread;
+    std::atomic<uint32_t> pendingLoudness { 0 };
+    std::atomic<bool> measuringLoudness { false };
+    void requestLoudnessMeasurement(AppState::Timbre timbre);
+    void runLoudnessThread();
+    
+    // 钢琴样本的加载顺序：练习音域内当前激活的半音 → 练习音域其余的键（其余 region 随后按文件顺序加载）
+    juce::Array<int> getPianoLoadingPriority() const;
+    
+    // 当前音色的补偿表只在 Voice 创建或音色切换时挂到 Voice 上，不随音量变化（可闻下限在下一个渲染块重新下发）
+    void applyLoudnessTablesToVoices();
+    void addVoicesForCurrentTimbre(int count);
+    
+    // 空闲检测（受 synthMutex 保护）；宽限期远长于快速释放，被硬停止的 Voice 尾音可以渲染完
+    static constexpr double IDLE_GRACE_MS = 50.0;
+    bool idle = false;
+    int quietSamples = 0;
+    juce::int64 idleSamples = 0;
+    void updateIdleState(int activeVoices, int numSamples);
+    void collectScheduledEvents(const juce::MidiBuffer& incoming, int startSample, int numSamples);
+    
+    // 音频时钟（受 synthMutex 保护）
+    juce::int64 renderedSamples = 0;
+    juce::int64 clockAnchorSample = 0;
+    double clockAnchorHostMs = 0.0;
+    std::atomic<int> outputLatencySamples { 0 };
     
-    // SFZ文件路径辅助方法
-    juce::File getSFZFile() const;
+    // 钢琴乐器文件：打包文件（.earxpack）优先，其次 SFZ；都找不到时返回源码目录中的 SFZ 路径
+    juce::File getPianoInstrumentFile() const;
     
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AudioController)
 }; 
@@ -0,0 +1,153 @@
+#include "CompressedSample.h"
+#include <cstring>
+
+namespace
+{
+    constexpr float kFixedToFloat = 1.0f / 32768.0f;
+
+    int predict(int order, const int* reconstructed, int i)
+    {
+        if (order == 1 || i < 2)
+            return reconstructed[i - 1];
+        return 2 * reconstructed[i - 1] - reconstructed[i - 2];
+    }
+
+    // 按给定阶数与移位闭环量化一块，返回平方误差和；残差超出 8 位（削波）时 clipped 为 true
+    juce::int64 quantise(const int* values, int order, int shift, int8_t* residuals, bool& clipped)
+    {
+        int reconstructed[CompressedSample::BLOCK_FRAMES];
+        reconstructed[0] = values[0];
+        const int half = (1 << shift) >> 1;
+        juce::int64 error = 0;
+        clipped = false;
+
+        for (int i = 1; i < CompressedSample::BLOCK_FRAMES; ++i)
+        {
+            const int prediction = predict(order, reconstructed, i);
+            int q = (values[i] - prediction + half) >> shift;     // 四舍五入（算术右移）
+            if (q < -128 || q > 127)
+            {
+                clipped = true;
+                q = juce::jlimit(-128, 127, q);
+            }
+            residuals[i - 1] = (int8_t) q;
+            reconstructed[i] = prediction + q * (1 << shift);
+            const int e = values[i] - reconstructed[i];
+            error += (juce::int64) e * e;
+        }
+        return error;
+    }
+}
+
+std::shared_ptr<const CompressedSample> CompressedSample::encode(const juce::AudioBuffer<float>& source)
+{
+    auto sample = std::make_shared<CompressedSample>();
+    sample->numChannels = source.getNumChannels();
+    sample->numFrames = source.getNumSamples();
+    sample->numBlocks = (sample->numFrames + BLOCK_FRAMES - 1) / BLOCK_FRAMES;
+    sample->data.resize((size_t) sample->numChannels * (size_t) sample->numBlocks * BLOCK_BYTES);
+
+    int values[BLOCK_FRAMES];
+    for (int ch = 0; ch < sample->numChannels; ++ch)
+    {
+        const float* input = source.getReadPointer(ch);
+        for (int block = 0; block < sample->numBlocks; ++block)
+        {
+            // 量化到 16 位；末块不足的部分重复最后一个样本，残差为零
+            const int start = block * BLOCK_FRAMES;
+            const int count = juce::jmin(BLOCK_FRAMES, sample->numFrames - start);
+            for (int i = 0; i < BLOCK_FRAMES; ++i)
+            {
+                const float x = input[start + juce::jmin(i, count - 1)];
+                values[i] = juce::jlimit(-32768, 32767, juce::roundToInt(x * 32768.0f));
+            }
+            encodeBlock(values, sample->data.data() + ((size_t) ch * (size_t) sample->numBlocks + (size_t) block) * BLOCK_BYTES);
+        }
+    }
+    return sample;
+}
+
+void CompressedSample::encodeBlock(const int* values, uint8_t* block)
+{
+    // 两种阶数各自找不削波的最小移位（从开环残差估计的移位开始），取移位较小、误差较小者
+    int8_t residuals[BLOCK_FRAMES - 1], candidate[BLOCK_FRAMES - 1];
+    int bestOrder = 1, bestShift = MAX_SHIFT;
+    juce::int64 bestError = -1;
+
+    for (int order = 1; order <= 2 && bestError != 0; ++order)     // 无损的块不必再试二阶
+    {
+        int maxResidual = 0;
+        for (int i = 1; i < BLOCK_FRAMES; ++i)
+            maxResidual = juce::jmax(maxResidual, std::abs(values[i] - predict(order, values, i)));
+        int shift = 0;
+        while (shift < MAX_SHIFT && (maxResidual >> shift) > 127)
+            ++shift;
+        shift = juce::jmax(0, shift - 1);
+
+        for (; shift <= MAX_SHIFT && shift <= bestShift; ++shift)
+        {
+            bool clipped = false;
+            const auto error = quantise(values, order, shift, candidate, clipped);
+            if (clipped && shift < MAX_SHIFT)
+                continue;
+            if (bestError < 0 || shift < bestShift || error < bestError)
+            {
+                bestOrder = order;
+                bestShift = shift;
+                bestError = error;
+                std::memcpy(residuals, candidate, sizeof(residuals));
+            }
+            break;
+        }
+    }
+
+    const auto first = (uint16_t) (int16_t) values[0];
+    block[0] = (uint8_t) (first & 0xff);
+    block[1] = (uint8_t) (first >> 8);
+    block[2] = (uint8_t) bestShift;
+    block[3] = (uint8_t) bestOrder;
+    std::memcpy(block + BLOCK_HEADER_BYTES, residuals, sizeof(residuals));
+    block[BLOCK_BYTES - 1] = 0;
+}
+
+void CompressedSample::decodeBlock(int channel, int block, float* dest) const
+{
+    const uint8_t* encoded = data.data() + ((size_t) channel * (size_t) numBlocks + (size_t) block) * BLOCK_BYTES;
+    const auto* residuals = reinterpret_cast<const int8_t*>(encoded + BLOCK_HEADER_BYTES);
+    const int step = 1 << encoded[2];
+    const int order = encoded[3];
+
+    // 残差放大到 16 位单位，再按预测阶数做一次（一阶）或两次（二阶）前缀和
+    int values[BLOCK_FRAMES];
+    values[0] = (int16_t) (uint16_t) (encoded[0] | (encoded[1] << 8));
+    for (int i = 1; i < BLOCK_FRAMES; ++i)
+        values[i] = residuals[i - 1] * step;
+
+    if (order == 1)
+    {
+        for (int i = 1; i < BLOCK_FRAMES; ++i)
+            values[i] += values[i - 1];
+    }
+    else
+    {
+        int slope = values[1];
+        values[1] += values[0];
+        for (int i = 2; i < BLOCK_FRAMES; ++i)
+        {
+            slope += values[i];
+            values[i] = values[i - 1] + slope;
+        }
+    }
+
+    juce::FloatVectorOperations::convertFixedToFloat(dest, values, kFixedToFloat, BLOCK_FRAMES);
+}
+
+std::shared_ptr<juce::AudioBuffer<float>> CompressedSample::decode() const
+{
+    auto buffer = std::make_shared<juce::AudioBuffer<float>>(numChannels, numBlocks * BLOCK_FRAMES);
+    for (int ch = 0; ch < numChannels; ++ch)
+        for (int block = 0; block < numBlocks; ++block)
+            decodeBlock(ch, block, buffer->getWritePointer(ch, block * BLOCK_FRAMES));
+    buffer->setSize(numChannels, numFrames, true, false, true);
+    return buffer;
+}
@@ -0,0 +1,51 @@
+#pragma once
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+/**
+ * 内存中的压缩样本 - 低内存设备上钢琴样本的存储格式（PianoSound::storageCompressed）
+ * 编码：
+ * - 样本先量化到 16 位，逐声道按 BLOCK_FRAMES 帧分块，块之间互不依赖，可随机访问
+ * - 每块 BLOCK_BYTES 字节（固定码率，约为 32 位浮点的 1/4）：块首样本（16 位）、量化移位、预测阶数，
+ *   其后每帧一个 8 位残差；一阶（前一样本）或二阶（线性外推）预测，闭环量化（编码端按解码结果预测，误差不累积）
+ * - 编码时逐块选择不削波的最小移位，残差在 8 位以内的块（钢琴衰减段的绝大部分）无损；
+ *   起音等高频能量大的块量化误差不超过 2^(移位-1) 个 16 位单位
+ * 解码：预测递推逐样本进行，整数到浮点的转换与缩放用 FloatVectorOperations（SIMD）。
+ *
+ * 编码在加载线程进行；解码只读，可在多个 Voice（音频线程）中同时进行，不分配内存。
+ */
+class CompressedSample
+{
+public:
+    static constexpr int BLOCK_FRAMES = 256;
+    static constexpr int BLOCK_HEADER_BYTES = 4;
+    static constexpr int BLOCK_BYTES = 260;     // 块头 + (BLOCK_FRAMES - 1) 个残差，补齐到 4 字节
+    static constexpr int MAX_SHIFT = 10;        // 二阶预测残差最大 2^17，移位 10 后落入 8 位
+
+    // 编码 source 的全部声道与帧
+    static std::shared_ptr<const CompressedSample> encode(const juce::AudioBuffer<float>& source);
+
+    int getNumChannels() const { return numChannels; }
+    int getNumFrames() const { return numFrames; }
+    int getNumBlocks() const { return numBlocks; }
+    size_t getMemoryBytes() const { return data.size(); }
+
+    // 第 block 块的量化移位（0 表示无损），量化误差不超过 2^(移位-1) 个 16 位单位
+    int getBlockShift(int channel, int block) const { return data[((size_t) channel * (size_t) numBlocks + (size_t) block) * BLOCK_BYTES + 2]; }
+
+    // 解码 channel 的第 block 块到 dest（BLOCK_FRAMES 个样本；末块超出 getNumFrames 的部分为补齐值）
+    void decodeBlock(int channel, int block, float* dest) const;
+
+    // 解码全部帧（加载时分析起音与包络用）
+    std::shared_ptr<juce::AudioBuffer<float>> decode() const;
+
+private:
+    static void encodeBlock(const int* values, uint8_t* block);
+
+    int numChannels = 0;
+    int numFrames = 0;
+    int numBlocks = 0;
+    std::vector<uint8_t> data;     // [声道][块][BLOCK_BYTES]
+};
@@ -6,6 +6,7 @@
 #include <thread>
 #include <atomic>
 #include <chrono>
+#include <limits>
 #include <juce_audio_devices/juce_audio_devices.h>
 #include <juce_core/juce_core.h>
 #include <juce_events/juce_events.h>
@@ -95,16 +96,21 @@ public:
             
             juce::AudioBuffer<float> buffer(outputChannelData, numOutputChannels, numSamples);
             buffer.clear();
-            juce::MidiBuffer midiBuffer;
-            audioController->renderNextBlock(buffer, midiBuffer, 0, numSamples);
+            audioController->renderNextBlock(buffer, noMidi, 0, numSamples);
         }
     }
     
-    void audioDeviceAboutToStart(juce::AudioIODevice* device) override {}
+    void audioDeviceAboutToStart(juce::AudioIODevice* device) override
+    {
+        // 设备（重新）启动时采样率可能已变化：引擎内部采样率固定，只重新配置输出采样率转换
+        if (audioController && device)
+            audioController->setDeviceSampleRate(device->getCurrentSampleRate());
+    }
     void audioDeviceStopped() override {}
     
 private:
     AudioController* audioController;
+    const juce::MidiBuffer noMidi;
 };
 
 static std::unique_ptr<AudioEngineCallback> g_audioCallback;
@@ -233,6 +239,14 @@ int earx_initialize(double sampleRate) {
         // 统一初始化音频控制器，避免重复设置
         printf("[EarX C++] 初始化音频控制器，采样率: %.2f\n", finalSampleRate);
         g_audioController->initialize(finalSampleRate);
+        
+        // 输出延迟 = 设备延迟 + 一个缓冲区（本块渲染完成后才开始播放），用于作答反应时间校正
+        if (auto* device = g_deviceManager->getCurrentAudioDevice())
+        {
+            int latencySamples = device->getOutputLatencyInSamples() + device->getCurrentBufferSizeSamples();
+            g_audioController->setOutputLatencySamples(latencySamples);
+            DBG("Output latency: " + juce::String(latencySamples) + " samples");
+        }
 
         // 控制器初始化完毕后再添加音频回调（iOS/macOS 在主线程执行更安全）
        #if JUCE_MAC || JUCE_IOS
@@ -329,7 +343,7 @@ int earx_stop_all_notes() {
 int earx_set_piano_mode(int isPianoMode) {
     if (!g_initialized || !g_audioController) return -100;
     try {
-        g_audioController->switchTimbre(isPianoMode != 0);
+        g_audioController->switchTimbre(isPianoMode != 0 ? AppState::timbrePiano : AppState::timbreSine);
         return 0;
     } catch (...) {
         return -6;
@@ -339,7 +353,7 @@ int earx_set_piano_mode(int isPianoMode) {
 int earx_get_current_timbre() {
     if (!g_initialized || !g_appState) return -100;
     try {
-        return g_appState->audio.isPianoMode ? 1 : 0;
+        return (int) g_appState->audio.timbre;
     } catch (...) {
         return -7;
     }
@@ -364,6 +378,173 @@ float earx_get_master_volume() {
     }
 }
 
+int earx_set_volume_smoothing_ms(float milliseconds) {
+    if (!g_initialized || !g_audioController) return -100;
+    if (!std::isfinite(milliseconds)) return -101;
+    try {
+        g_audioController->setVolumeSmoothingTime(milliseconds);
+        return 0;
+    } catch (...) {
+        return -49;
+    }
+}
+
+float earx_get_volume_smoothing_ms() {
+    if (!g_initialized || !g_audioController) return 0.0f;
+    try {
+        return g_audioController->getVolumeSmoothingTime();
+    } catch (...) {
+        return 0.0f;
+    }
+}
+
+int earx_set_room_level(float level) {
+    if (!g_initialized || !g_audioController) return -100;
+    if (!std::isfinite(level)) return -101;
+    try {
+        g_audioController->setRoomLevel(level);
+        return 0;
+    } catch (...) {
+        return -51;
+    }
+}
+
+float earx_get_room_level() {
+    if (!g_initialized || !g_audioController) return 0.0f;
+    try {
+        return g_audioController->getRoomLevel();
+    } catch (...) {
+        return 0.0f;
+    }
+}
+
+int earx_load_room_impulse(const char* path) {
+    if (!g_initialized || !g_audioController) return -100;
+    if (path == nullptr) return -101;
+    try {
+        juce::File file(juce::String::fromUTF8(path));
+        if (!file.existsAsFile()) return -102;
+        return g_audioController->loadRoomImpulseResponse(file) ? 0 : -52;
+    } catch (...) {
+        return -52;
+    }
+}
+
+float earx_get_room_cpu_load() {
+    if (!g_initialized || !g_audioController) return 0.0f;
+    try {
+        return (float) (g_audioController->getRoomCpuLoad() * 100.0);
+    } catch (...) {
+        return 0.0f;
+    }
+}
+
+int earx_set_reverb_room_size(float size) {
+    if (!g_initialized || !g_audioController) return -100;
+    if (!std::isfinite(size)) return -101;
+    try {
+        g_audioController->setReverbRoomSize(size);
+        return 0;
+    } catch (...) {
+        return -53;
+    }
+}
+
+int earx_set_reverb_damping(float damping) {
+    if (!g_initialized || !g_audioController) return -100;
+    if (!std::isfinite(damping)) return -101;
+    try {
+        g_audioController->setReverbDamping(damping);
+        return 0;
+    } catch (...) {
+        return -54;
+    }
+}
+
+int earx_set_reverb_mix(float mix) {
+    if (!g_initialized || !g_audioController) return -100;
+    if (!std::isfinite(mix)) return -101;
+    try {
+        g_audioController->setReverbMix(mix);
+        return 0;
+    } catch (...) {
+        return -55;
+    }
+}
+
+float earx_get_reverb_room_size() {
+    if (!g_initialized || !g_audioController) return 0.0f;
+    try {
+        return g_audioController->getReverbRoomSize();
+    } catch (...) {
+        return 0.0f;
+    }
+}
+
+float earx_get_reverb_damping() {
+    if (!g_initialized || !g_audioController) return 0.0f;
+    try {
+        return g_audioController->getReverbDamping();
+    } catch (...) {
+        return 0.0f;
+    }
+}
+
+float earx_get_reverb_mix() {
+    if (!g_initialized || !g_audioController) return 0.0f;
+    try {
+        return g_audioController->getReverbMix();
+    } catch (...) {
+        return 0.0f;
+    }
+}
+
+int earx_set_limiter_lookahead_ms(float milliseconds) {
+    if (!g_initialized || !g_audioController) return -100;
+    if (!std::isfinite(milliseconds)) return -101;
+    try {
+        g_audioController->setLimiterLookahead(milliseconds);
+        return 0;
+    } catch (...) {
+        return -56;
+    }
+}
+
+float earx_get_limiter_lookahead_ms() {
+    if (!g_initialized || !g_audioController) return 0.0f;
+    try {
+        return g_audioController->getLimiterLookahead();
+    } catch (...) {
+        return 0.0f;
+    }
+}
+
+int earx_get_limiter_stats(float* currentReductionDb, float* maxReductionDb, double* limitedSeconds) {
+    if (!g_initialized || !g_audioController) return -100;
+    try {
+        const auto stats = g_audioController->getLimiterStats();
+        if (currentReductionDb != nullptr)
+            *currentReductionDb = stats.currentReductionDb;
+        if (maxReductionDb != nullptr)
+            *maxReductionDb = stats.maxReductionDb;
+        if (limitedSeconds != nullptr)
+            *limitedSeconds = (double) stats.limitedSamples / g_audioController->getSampleRate();
+        return 0;
+    } catch (...) {
+        return -57;
+    }
+}
+
+int earx_reset_limiter_stats() {
+    if (!g_initialized || !g_audioController) return -100;
+    try {
+        g_audioController->resetLimiterStats();
+        return 0;
+    } catch (...) {
+        return -58;
+    }
+}
+
 int earx_set_bpm(double bpm) {
     if (!g_initialized || !g_appState) return -100;
     try {
@@ -550,6 +731,488 @@ int earx_set_should_play_center_note(int should_play) {
     }
 }
 
+int earx_set_random_seed(uint64_t seed) {
+    if (!g_initialized || !g_playbackEngine) return -100;
+    try {
+        g_playbackEngine->setRandomSeed(seed);
+        return 0;
+    } catch (...) {
+        return -25;
+    }
+}
+
+uint64_t earx_get_random_seed() {
+    if (!g_initialized || !g_playbackEngine) return 0;
+    try {
+        return g_playbackEngine->getRandomSeed();
+    } catch (...) {
+        return 0;
+    }
+}
+
+int earx_report_answer_result(int midiNote, int correct) {
+    if (!g_initialized || !g_playbackEngine) return -100;
+    try {
+        if (!g_playbackEngine->reportAnswerResult(midiNote, correct != 0))
+            return -101; // 音符不在出题范围内
+        return 0;
+    } catch (...) {
+        return -26;
+    }
+}
+
+int earx_get_note_weights(float* weights, int maxCount) {
+    if (!g_initialized || !g_playbackEngine || !weights || maxCount <= 0) return -100;
+    try {
+        const auto& selector = g_playbackEngine->getNoteSelector();
+        int count = juce::jmin(maxCount, (int) AdaptiveNoteSelector::NUM_CELLS);
+        
+        for (int i = 0; i < count; ++i)
+            weights[i] = selector.getWeight(i / AdaptiveNoteSelector::NUM_OCTAVES, i % AdaptiveNoteSelector::NUM_OCTAVES);
+        
+        return count;
+    } catch (...) {
+        return -27;
+    }
+}
+
+int earx_get_note_statistics(int* attempts, int* misses, int maxCount) {
+    if (!g_initialized || !g_playbackEngine || !attempts || !misses || maxCount <= 0) return -100;
+    try {
+        const auto& selector = g_playbackEngine->getNoteSelector();
+        int count = juce::jmin(maxCount, (int) AdaptiveNoteSelector::NUM_CELLS);
+        
+        for (int i = 0; i < count; ++i)
+        {
+            auto stats = selector.getStats(i / AdaptiveNoteSelector::NUM_OCTAVES, i % AdaptiveNoteSelector::NUM_OCTAVES);
+            attempts[i] = stats.attempts;
+            misses[i] = stats.misses;
+        }
+        
+        return count;
+    } catch (...) {
+        return -28;
+    }
+}
+
+int earx_reset_note_statistics() {
+    if (!g_initialized || !g_playbackEngine) return -100;
+    try {
+        g_playbackEngine->resetNoteStatistics();
+        return 0;
+    } catch (...) {
+        return -29;
+    }
+}
+
+double earx_get_engine_time_ms() {
+    return juce::Time::getMillisecondCounterHiRes();
+}
+
+int earx_submit_answer(int semitone, double timestampMs) {
+    if (!g_initialized || !g_playbackEngine) return -100;
+    if (semitone < 0 || semitone > 11) return -101; // 无效半音
+    
+    try {
+        if (timestampMs <= 0.0)
+            timestampMs = juce::Time::getMillisecondCounterHiRes();
+        
+        AnswerScorer::Result result;
+        if (!g_playbackEngine->submitAnswer(semitone, timestampMs, result))
+            return -102; // 没有待作答的题目
+        
+        return result.correct ? 1 : 0;
+    } catch (...) {
+        return -30;
+    }
+}
+
+int earx_get_answer_count() {
+    if (!g_initialized || !g_playbackEngine) return 0;
+    try {
+        return g_playbackEngine->getAnswerScorer().getNumResults();
+    } catch (...) {
+        return 0;
+    }
+}
+
+int earx_get_answer_result(int index, int* expectedSemitone, int* answeredSemitone, int* correct, double* reactionMs) {
+    if (!g_initialized || !g_playbackEngine) return -100;
+    if (!expectedSemitone || !answeredSemitone || !correct || !reactionMs) return -100;
+    
+    try {
+        AnswerScorer::Result result;
+        if (!g_playbackEngine->getAnswerScorer().getResult(index, result))
+            return -101; // 无效索引
+        
+        *expectedSemitone = result.expectedSemitone;
+        *answeredSemitone = result.answeredSemitone;
+        *correct = result.correct ? 1 : 0;
+        *reactionMs = result.reactionMs;
+        return 0;
+    } catch (...) {
+        return -31;
+    }
+}
+
+int earx_clear_answer_results() {
+    if (!g_initialized || !g_playbackEngine) return -100;
+    try {
+        g_playbackEngine->getAnswerScorer().clearResults();
+        return 0;
+    } catch (...) {
+        return -32;
+    }
+}
+
+int earx_start_session_log(const char* directoryPath) {
+    if (!g_initialized || !g_playbackEngine || !directoryPath) return -100;
+    try {
+        juce::File directory(juce::String::fromUTF8(directoryPath));
+        if (!g_playbackEngine->startSessionLog(directory))
+            return -101; // 无法创建日志文件
+        return 0;
+    } catch (...) {
+        return -33;
+    }
+}
+
+int earx_stop_session_log() {
+    if (!g_initialized || !g_playbackEngine) return -100;
+    try {
+        g_playbackEngine->stopSessionLog();
+        return 0;
+    } catch (...) {
+        return -34;
+    }
+}
+
+int earx_get_session_log_path(char* buffer, int bufferSize) {
+    if (!g_initialized || !g_playbackEngine || !buffer || bufferSize <= 0) return -100;
+    try {
+        juce::String path = g_playbackEngine->getSessionLog().getCurrentFile().getFullPathName();
+        
+        if ((int) path.getNumBytesAsUTF8() >= bufferSize) {
+            return -103; // 缓冲区太小
+        }
+        
+        strcpy(buffer, path.toUTF8());
+        return 0;
+    } catch (...) {
+        return -35;
+    }
+}
+
+int earx_get_semitone_performance(int semitone, int* attempts, int* correct, double* meanReactionMs) {
+    if (!g_initialized || !g_playbackEngine || !attempts || !correct || !meanReactionMs) return -100;
+    if (semitone < 0 || semitone > 11) return -101;
+    
+    try {
+        auto performance = g_playbackEngine->getSessionLog().getSemitonePerformance(semitone);
+        *attempts = performance.attempts;
+        *correct = performance.correct;
+        *meanReactionMs = performance.getMeanReactionMs();
+        return 0;
+    } catch (...) {
+        return -36;
+    }
+}
+
+int earx_get_confusion_count(int expectedSemitone, int answeredSemitone) {
+    if (!g_initialized || !g_playbackEngine) return -100;
+    if (expectedSemitone < 0 || expectedSemitone > 11 || answeredSemitone < 0 || answeredSemitone > 11) return -101;
+    
+    try {
+        return g_playbackEngine->getSessionLog().getConfusionCount(expectedSemitone, answeredSemitone);
+    } catch (...) {
+        return -37;
+    }
+}
+
+int earx_get_bpm_performance(double bpm, int* attempts, int* correct, double* meanReactionMs) {
+    if (!g_initialized || !g_playbackEngine || !attempts || !correct || !meanReactionMs) return -100;
+    try {
+        auto performance = g_playbackEngine->getSessionLog().getBpmPerformance(bpm);
+        *attempts = performance.attempts;
+        *correct = performance.correct;
+        *meanReactionMs = performance.getMeanReactionMs();
+        return 0;
+    } catch (...) {
+        return -38;
+    }
+}
+
+int earx_set_exercise_mode(int mode) {
+    if (!g_initialized || !g_playbackEngine) return -100;
+    if (mode < 0 || mode > 3) return -101; // 无效模式
+    
+    try {
+        g_playbackEngine->setExerciseMode(mode);
+        return 0;
+    } catch (...) {
+        return -39;
+    }
+}
+
+int earx_get_exercise_mode() {
+    if (!g_initialized || !g_appState) return 0;
+    try {
+        return g_appState->playback.exerciseMode;
+    } catch (...) {
+        return 0;
+    }
+}
+
+int earx_set_exercise_style(int style) {
+    if (!g_initialized || !g_playbackEngine) return -100;
+    if (style < 0 || style > 2) return -101; // 无效播放方式
+    
+    try {
+        g_playbackEngine->setExerciseStyle(style);
+        return 0;
+    } catch (...) {
+        return -40;
+    }
+}
+
+int earx_get_exercise_style() {
+    if (!g_initialized || !g_appState) return 0;
+    try {
+        return g_appState->playback.exerciseStyle;
+    } catch (...) {
+        return 0;
+    }
+}
+
+// 单次练习的时值与自动播放一致：BPM x 音符时长百分比
+static double getExerciseDurationMs() {
+    return (60000.0 / g_appState->playback.bpm) * (g_appState->playback.noteDuration / 100.0);
+}
+
+int earx_play_interval(int rootNote, int semitones, int style) {
+    if (!g_initialized || !g_playbackEngine || !g_audioController) return -100;
+    if (rootNote < 0 || rootNote > 127 || semitones < 1 || semitones > 12) return -101;
+    if (style < 0 || style > 2) return -102;
+    
+    try {
+        g_audioController->ensurePolyphony(ExerciseEngine::REQUIRED_POLYPHONY);
+        auto& engine = g_playbackEngine->getExerciseEngine();
+        auto exercise = engine.createInterval(rootNote, semitones, (ExerciseEngine::Style) style);
+        
+        const double durationMs = getExerciseDurationMs();
+        const bool harmonic = style == ExerciseEngine::harmonic;
+        engine.play(exercise, harmonic ? 0.0 : durationMs / 2.0, harmonic ? durationMs : durationMs / 2.0, 0.8f);
+        return 0;
+    } catch (...) {
+        return -41;
+    }
+}
+
+int earx_play_chord(int rootNote, int chordType, int inversion, int voicing, int style) {
+    if (!g_initialized || !g_playbackEngine || !g_audioController) return -100;
+    if (rootNote < 0 || rootNote > 127 || chordType < 0 || chordType >= ExerciseEngine::NUM_CHORD_TYPES) return -101;
+    if (inversion < 0 || inversion >= ExerciseEngine::MAX_NOTES || voicing < 0 || voicing >= ExerciseEngine::NUM_VOICINGS) return -101;
+    if (style < 0 || style > 2) return -102;
+    
+    try {
+        g_audioController->ensurePolyphony(ExerciseEngine::REQUIRED_POLYPHONY);
+        auto& engine = g_playbackEngine->getExerciseEngine();
+        auto exercise = engine.createChord(rootNote, chordType, inversion, (ExerciseEngine::Voicing) voicing,
+                                           (ExerciseEngine::Style) style);
+        
+        const double durationMs = getExerciseDurationMs();
+        const bool harmonic = style == ExerciseEngine::harmonic;
+        const double spacingMs = durationMs / exercise.numNotes;
+        engine.play(exercise, harmonic ? 0.0 : spacingMs, harmonic ? durationMs : spacingMs, 0.8f);
+        return 0;
+    } catch (...) {
+        return -42;
+    }
+}
+
+int earx_get_last_exercise(int* kind, int* rootNote, int* quality, int* inversion, int* voicing) {
+    if (!g_initialized || !g_playbackEngine || !kind || !rootNote || !quality || !inversion || !voicing) return -100;
+    try {
+        auto exercise = g_playbackEngine->getExerciseEngine().getLastExercise();
+        if (exercise.numNotes == 0)
+            return -101; // 尚未播放过练习
+        
+        *kind = exercise.kind;
+        *rootNote = exercise.rootNote;
+        *quality = exercise.quality;
+        *inversion = exercise.inversion;
+        *voicing = exercise.voicing;
+        return 0;
+    } catch (...) {
+        return -43;
+    }
+}
+
+// 复音数与 Voice 抢占
+int earx_set_polyphony(int numVoices) {
+    if (!g_initialized || !g_audioController) return -100;
+    if (numVoices < 1 || numVoices > AudioController::MAX_POLYPHONY) return -101;
+    
+    try {
+        g_audioController->setPolyphony(numVoices);
+        return 0;
+    } catch (...) {
+        return -44;
+    }
+}
+
+int earx_get_polyphony() {
+    if (!g_initialized || !g_audioController) return 0;
+    try {
+        return g_audioController->getPolyphony();
+    } catch (...) {
+        return 0;
+    }
+}
+
+int earx_get_max_sustainable_polyphony() {
+    if (!g_initialized || !g_audioController) return 0;
+    try {
+        return g_audioController->getMaxSustainablePolyphony();
+    } catch (...) {
+        return 0;
+    }
+}
+
+int earx_get_voices_stolen() {
+    if (!g_initialized || !g_audioController) return 0;
+    try {
+        return (int) juce::jmin((juce::int64) std::numeric_limits<int>::max(), g_audioController->getNumVoicesStolen());
+    } catch (...) {
+        return 0;
+    }
+}
+
+int earx_set_voice_culling_floor_db(float decibels) {
+    if (!g_initialized || !g_audioController) return -100;
+    if (!std::isfinite(decibels)) return -101;
+    
+    try {
+        g_audioController->setVoiceCullingFloor(decibels);
+        return 0;
+    } catch (...) {
+        return -59;
+    }
+}
+
+float earx_get_voice_culling_floor_db() {
+    if (!g_initialized || !g_audioController) return 0.0f;
+    try {
+        return g_audioController->getVoiceCullingFloor();
+    } catch (...) {
+        return 0.0f;
+    }
+}
+
+int earx_get_idle_stats(double* idleSeconds, double* totalSeconds) {
+    if (!g_initialized || !g_audioController) return -100;
+    try {
+        const auto stats = g_audioController->getIdleStats();
+        const double sampleRate = g_audioController->getSampleRate();
+        if (idleSeconds != nullptr)
+            *idleSeconds = (double) stats.idleSamples / sampleRate;
+        if (totalSeconds != nullptr)
+            *totalSeconds = (double) stats.totalSamples / sampleRate;
+        return stats.idle ? 1 : 0;
+    } catch (...) {
+        return -50;
+    }
+}
+
+// 音色选择：EarxTimbre 与 AppState::Timbre 数值一一对应
+static_assert((int) EARX_TIMBRE_PIANO == (int) AppState::timbrePiano
+              && (int) EARX_TIMBRE_ADDITIVE == (int) AppState::timbreAdditive
+              && (int) EARX_TIMBRE_STRING == (int) AppState::timbreString
+              && (int) EARX_TIMBRE_COUNT == (int) AppState::numTimbres,
+              "EarxTimbre must match AppState::Timbre");
+
+int earx_set_timbre(int timbre) {
+    if (!g_initialized || !g_audioController) return -100;
+    if (timbre < 0 || timbre >= EARX_TIMBRE_COUNT) return -101;
+    
+    try {
+        g_audioController->switchTimbre(static_cast<AppState::Timbre>(timbre));
+        return 0;
+    } catch (...) {
+        return -45;
+    }
+}
+
+int earx_load_user_wavetable(const char* path) {
+    if (!g_initialized || !g_audioController) return -100;
+    if (path == nullptr) return -101;
+    
+    try {
+        juce::File file(juce::String::fromUTF8(path));
+        if (!file.existsAsFile()) return -102;
+        return g_audioController->loadUserWavetable(file) ? 0 : -46;
+    } catch (...) {
+        return -46;
+    }
+}
+
+// 加法合成分音表
+int earx_set_partial_profile(const float* amplitudes, const float* decaySeconds, int numPartials) {
+    if (!g_initialized || !g_audioController) return -100;
+    if (amplitudes == nullptr) return -101;
+    if (numPartials < 1 || numPartials > PartialOscillator::MAX_PARTIALS) return -102;
+    
+    // NaN / Inf 会经分音振荡器进入 FDN 与响度测量，负振幅没有意义，一律拒绝
+    for (int i = 0; i < numPartials; ++i)
+        if (!std::isfinite(amplitudes[i]) || amplitudes[i] < 0.0f
+            || (decaySeconds != nullptr && !std::isfinite(decaySeconds[i])))
+            return -62;
+    
+    try {
+        AdditiveSound::Profile profile;
+        profile.numPartials = numPartials;
+        for (int i = 0; i < numPartials; ++i)
+        {
+            profile.amplitude[i] = amplitudes[i];
+            profile.decaySeconds[i] = decaySeconds != nullptr ? decaySeconds[i] : 0.0f;
+        }
+        g_audioController->setPartialProfile(profile);
+        return 0;
+    } catch (...) {
+        return -47;
+    }
+}
+
+int earx_get_partial_profile(float* amplitudes, float* decaySeconds, int maxCount) {
+    if (!g_initialized || !g_audioController || !amplitudes || maxCount <= 0) return -100;
+    try {
+        const auto profile = g_audioController->getPartialProfile();
+        const int count = juce::jmin(maxCount, profile.numPartials);
+        for (int i = 0; i < count; ++i)
+        {
+            amplitudes[i] = profile.amplitude[i];
+            if (decaySeconds != nullptr)
+                decaySeconds[i] = profile.decaySeconds[i];
+        }
+        return count;
+    } catch (...) {
+        return -48;
+    }
+}
+
+int earx_get_sample_rates(double* internalSampleRate, double* deviceSampleRate) {
+    if (!g_initialized || !g_audioController) return -100;
+    try {
+        if (internalSampleRate != nullptr)
+            *internalSampleRate = g_audioController->getSampleRate();
+        if (deviceSampleRate != nullptr)
+            *deviceSampleRate = g_audioController->getDeviceSampleRate();
+        return 0;
+    } catch (...) {
+        return -60;
+    }
+}
+
 int earx_is_initialized() {
     return g_initialized ? 1 : 0;
 }
@@ -562,6 +1225,30 @@ int earx_are_piano_samples_loaded() {
     return g_audioController->arePianoSamplesLoaded() ? 1 : 0;
 }
 
+int earx_is_piano_note_loaded(int midiNote) {
+    if (midiNote < 0 || midiNote > 127) {
+        return -101;
+    }
+    if (!g_initialized || !g_audioController) {
+        return 0;
+    }
+    
+    return g_audioController->isPianoNoteLoaded(midiNote) ? 1 : 0;
+}
+
+int earx_get_piano_sample_storage(int* storageMode, double* sampleMemoryMB) {
+    if (!g_initialized || !g_audioController) return -100;
+    try {
+        if (storageMode != nullptr)
+            *storageMode = (int) g_audioController->getPianoSampleStorage();
+        if (sampleMemoryMB != nullptr)
+            *sampleMemoryMB = (double) g_audioController->getPianoSampleMemoryBytes() / (1024.0 * 1024.0);
+        return 0;
+    } catch (...) {
+        return -61;
+    }
+}
+
 // 删除所有scale mode相关的FFI函数实现
 
 // 定时器控制
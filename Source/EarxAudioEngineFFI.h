@@ -1,5 +1,7 @@
 #pragma once
 
+#include <stdint.h>
+
 // 强制符号导出
 #if defined(__GNUC__) || defined(__clang__)
     #define EARX_EXPORT __attribute__((visibility("default")))
@@ -26,12 +28,55 @@ EARX_EXPORT int earx_stop_note(int midiNote);
 EARX_EXPORT int earx_stop_all_notes();
 
 // 音色控制
-EARX_EXPORT int earx_set_piano_mode(int isPianoMode); // 0=正弦波, 1=钢琴
-EARX_EXPORT int earx_get_current_timbre(); // 返回当前音色: 0=正弦波, 1=钢琴
+typedef enum EarxTimbre {
+    EARX_TIMBRE_SINE = 0,
+    EARX_TIMBRE_PIANO = 1,           // SFZ 采样钢琴（解码后约 40 MB）
+    EARX_TIMBRE_SAW = 2,             // 2-5 为带限波表音色
+    EARX_TIMBRE_SQUARE = 3,
+    EARX_TIMBRE_ORGAN = 4,
+    EARX_TIMBRE_USER_WAVETABLE = 5,
+    EARX_TIMBRE_ADDITIVE = 6,        // 加法合成（分音表见下）
+    EARX_TIMBRE_STRING = 7,          // 弦物理模型：不需要样本，低内存设备上替代采样钢琴
+    EARX_TIMBRE_COUNT
+} EarxTimbre;
+
+EARX_EXPORT int earx_set_timbre(int timbre); // EarxTimbre
+EARX_EXPORT int earx_get_current_timbre(); // 返回当前音色（EarxTimbre）
+EARX_EXPORT int earx_set_piano_mode(int isPianoMode); // 已弃用，改用 earx_set_timbre：0=正弦波, 1=钢琴
+EARX_EXPORT int earx_load_user_wavetable(const char* path); // 单周期 WAV/AIFF，任意长度（最多 8192 个样本），供音色 5 使用
+
+// 加法合成分音表（音色 6，下一个音符生效）：第 i 项对应第 i + 1 次谐波，最多 32 个
+// decaySeconds 为衰减 60 dB 的时间（<= 0 表示不衰减，传 NULL 表示全部不衰减）；整体响度自动归一化到正弦波
+// 振幅为负或非有限值、衰减时间为非有限值时返回 -62，分音表不变
+EARX_EXPORT int earx_set_partial_profile(const float* amplitudes, const float* decaySeconds, int numPartials);
+EARX_EXPORT int earx_get_partial_profile(float* amplitudes, float* decaySeconds, int maxCount); // 返回写入的分音个数
 
 // 音量控制
 EARX_EXPORT int earx_set_master_volume(float volume); // 0.0-1.0
 EARX_EXPORT float earx_get_master_volume();
+EARX_EXPORT int earx_set_volume_smoothing_ms(float milliseconds); // 主音量变化的平滑时间 0-1000ms，默认 20ms
+EARX_EXPORT float earx_get_volume_smoothing_ms();
+
+// 房间卷积（主总线上的混响）：湿声电平 0-1，默认 0（整级旁路，不占 CPU）
+EARX_EXPORT int earx_set_room_level(float level);
+EARX_EXPORT float earx_get_room_level();
+EARX_EXPORT int earx_load_room_impulse(const char* path); // 单声道或立体声 WAV/AIFF，后台加载与重采样，完成后无缝切换
+EARX_EXPORT float earx_get_room_cpu_load(); // 卷积耗时占实时预算的百分比（旁路时为 0）
+
+// FDN 算法混响（比房间卷积便宜）：参数均为 0-1；湿声电平默认 0（整级旁路），尾音低于 -90 dB 后自动静音
+EARX_EXPORT int earx_set_reverb_room_size(float size); // 混响时间约 0.2-4 秒
+EARX_EXPORT int earx_set_reverb_damping(float damping); // 越大高频衰减越快
+EARX_EXPORT int earx_set_reverb_mix(float mix); // 湿声电平，干声不变
+EARX_EXPORT float earx_get_reverb_room_size();
+EARX_EXPORT float earx_get_reverb_damping();
+EARX_EXPORT float earx_get_reverb_mix();
+
+// 主总线预读真峰值限幅器（4 倍过采样检测，上限 -1 dBTP），始终开启
+EARX_EXPORT int earx_set_limiter_lookahead_ms(float milliseconds); // 0.25-2ms，默认 1ms；即附加的输出延迟，在输出静音时生效
+EARX_EXPORT float earx_get_limiter_lookahead_ms();
+// 增益衰减统计（dB 为正数，可传 NULL）：最近一个块的衰减、重置以来的最大衰减、累计限幅时长（秒）
+EARX_EXPORT int earx_get_limiter_stats(float* currentReductionDb, float* maxReductionDb, double* limitedSeconds);
+EARX_EXPORT int earx_reset_limiter_stats();
 
 // 播放引擎控制
 EARX_EXPORT int earx_set_bpm(double bpm);
@@ -60,6 +105,60 @@ EARX_EXPORT int earx_get_center_tone(); // 获取当前中心音 (-1表示无中
 EARX_EXPORT int earx_should_play_center_note(); // 返回是否应该播放中心音 (0或1)
 EARX_EXPORT int earx_set_should_play_center_note(int should_play); // 设置是否播放中心音
 
+// 会话随机种子（复现练习序列：问题反馈、基准测试、共享的“每日挑战”）
+EARX_EXPORT int earx_set_random_seed(uint64_t seed); // 设置种子并开始新会话，下一次出题生效
+EARX_EXPORT uint64_t earx_get_random_seed(); // 获取当前会话种子（未设置时为基于时间的随机种子）
+
+// 自适应出题（答错越多的音出现越频繁）
+// 权重与统计按 semitone * 3 + octave 排列，共 36 项：semitone 0-11，octave 0-2 对应八度 4-6
+EARX_EXPORT int earx_report_answer_result(int midiNote, int correct); // 上报所出音符的作答结果 (correct: 0或1)
+EARX_EXPORT int earx_get_note_weights(float* weights, int maxCount); // 返回写入的权重个数
+EARX_EXPORT int earx_get_note_statistics(int* attempts, int* misses, int maxCount); // 返回写入的统计个数
+EARX_EXPORT int earx_reset_note_statistics(); // 清空统计，恢复均匀出题
+
+// 作答评分（反应时间以音符实际被听到的时刻为起点：音频时钟起始样本 + 设备输出延迟）
+// timestampMs 使用 earx_get_engine_time_ms() 的时基，<= 0 表示以调用时刻为作答时刻
+EARX_EXPORT double earx_get_engine_time_ms(); // 引擎高精度时钟（毫秒）
+EARX_EXPORT int earx_submit_answer(int semitone, double timestampMs); // 返回 1=正确, 0=错误, -102=没有待作答的题目
+EARX_EXPORT int earx_get_answer_count(); // 环形缓冲区中的结果数量（最多 128）
+EARX_EXPORT int earx_get_answer_result(int index, int* expectedSemitone, int* answeredSemitone, int* correct, double* reactionMs); // index 0 为最近一次
+EARX_EXPORT int earx_clear_answer_results();
+
+// 训练会话日志（二进制定长记录，每个会话一个文件）与会话统计
+EARX_EXPORT int earx_start_session_log(const char* directoryPath); // 在目录中新建日志文件并开始记录，同时清空会话统计
+EARX_EXPORT int earx_stop_session_log();
+EARX_EXPORT int earx_get_session_log_path(char* buffer, int bufferSize); // 当前日志文件路径
+EARX_EXPORT int earx_get_semitone_performance(int semitone, int* attempts, int* correct, double* meanReactionMs);
+EARX_EXPORT int earx_get_confusion_count(int expectedSemitone, int answeredSemitone); // 返回把 expected 答成 answered 的次数
+EARX_EXPORT int earx_get_bpm_performance(double bpm, int* attempts, int* correct, double* meanReactionMs); // 按 10 BPM 分档统计
+
+// 音程 / 和弦练习
+// 和弦类型: 0=maj, 1=min, 2=dim, 3=aug, 4=maj7, 5=7, 6=m7, 7=m7b5, 8=dim7
+// 排列方式: 0=密集, 1=开放(drop-2)；播放方式: 0=和声(同时), 1=旋律上行, 2=旋律下行
+EARX_EXPORT int earx_set_exercise_mode(int mode); // 0=单音, 1=音程, 2=三和弦, 3=七和弦（自动播放与随机出题使用）
+EARX_EXPORT int earx_get_exercise_mode();
+EARX_EXPORT int earx_set_exercise_style(int style);
+EARX_EXPORT int earx_get_exercise_style();
+EARX_EXPORT int earx_play_interval(int rootNote, int semitones, int style); // semitones: 1-12
+EARX_EXPORT int earx_play_chord(int rootNote, int chordType, int inversion, int voicing, int style);
+EARX_EXPORT int earx_get_last_exercise(int* kind, int* rootNote, int* quality, int* inversion, int* voicing); // kind: 0=音程, 1=和弦
+
+// 复音数（Voice 池大小，1-64）与抢占统计
+// 复音用尽时优先抢占已松开且最安静的 Voice，被抢占的音符做 3ms 快速释放
+EARX_EXPORT int earx_set_polyphony(int numVoices);
+EARX_EXPORT int earx_get_polyphony();
+EARX_EXPORT int earx_get_max_sustainable_polyphony(); // 由实测渲染开销估算的本机可持续复音数（尚未测得时为 0）
+EARX_EXPORT int earx_get_voices_stolen(); // 累计被抢占的 Voice 数
+
+// Voice 可闻下限（dB，相对最终输出满幅、计入主音量；-100 到 -30，默认 -70，-100 表示不剔除）：采样钢琴按加载时计算的幅度包络，
+// 剩余输出峰值低于下限时提前结束该音符；抢占也按剩余峰值选择最安静的 Voice
+EARX_EXPORT int earx_set_voice_culling_floor_db(float decibels);
+EARX_EXPORT float earx_get_voice_culling_floor_db();
+
+// 空闲统计：没有音符发声时渲染只清零输出；返回 1=当前空闲, 0=正在发声
+// idleSeconds / totalSeconds 为累计空闲时长与累计渲染时长（音频时钟，可传 NULL）
+EARX_EXPORT int earx_get_idle_stats(double* idleSeconds, double* totalSeconds);
+
 // 删除所有scale mode相关的FFI函数
 
 // 定时器控制
@@ -77,7 +176,14 @@ EARX_EXPORT int earx_get_selected_note_names_display(int semitone, char* buffer,
 
 // 状态查询
 EARX_EXPORT int earx_is_initialized();
+// 引擎内部采样率（固定 48 kHz，音频时钟与各项统计以此计）与当前设备采样率；两者不同时输出端做一次采样率转换（可传 NULL）
+EARX_EXPORT int earx_get_sample_rates(double* internalSampleRate, double* deviceSampleRate);
 EARX_EXPORT int earx_are_piano_samples_loaded(); // 检查钢琴采样是否加载完成
+// 单个键的钢琴采样是否已可用（加载过程中按练习音域优先逐键可用）：1 可用，0 尚未加载，-101 键号超出 0-127
+EARX_EXPORT int earx_is_piano_note_loaded(int midiNote);
+// 钢琴样本的存储方式（初始化时按设备内存选择，低内存设备以压缩块存放、播放时解码）：1=浮点, 2=压缩；
+// sampleMemoryMB 为样本占用的内存（MB，加载完成后准确，可传 NULL）
+EARX_EXPORT int earx_get_piano_sample_storage(int* storageMode, double* sampleMemoryMB);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,103 @@
+#include "EarxSynthesiser.h"
+
+namespace
+{
+    // 抢占优先级：刚开始的 Voice 最后才抢；已松开的 Voice 排在仍按住的之前，同组内电平低者优先，再按年龄
+    bool isBetterVictim(const juce::SynthesiserVoice* candidate, float candidateLevel, bool candidateFresh,
+                        const juce::SynthesiserVoice* best, float bestLevel, bool bestFresh)
+    {
+        if (candidateFresh != bestFresh)
+            return !candidateFresh;
+
+        const bool candidateReleased = candidate->isPlayingButReleased();
+        const bool bestReleased = best->isPlayingButReleased();
+        if (candidateReleased != bestReleased)
+            return candidateReleased;
+
+        if (candidateLevel != bestLevel)
+            return candidateLevel < bestLevel;
+
+        return candidate->wasStartedBefore(*best);
+    }
+
+    float getVoiceLevel(const juce::SynthesiserVoice* voice)
+    {
+        // 引擎内的 Voice 都是 EarxVoice；其他类型视为满电平，最后才被抢占
+        if (auto* earxVoice = dynamic_cast<const EarxVoice*>(voice))
+            return earxVoice->getCurrentLevel();
+        return 1.0f;
+    }
+}
+
+void EarxSynthesiser::noteOn(int midiChannel, int midiNoteNumber, float velocity)
+{
+    const juce::ScopedLock sl(lock);
+
+    juce::Synthesiser::noteOn(midiChannel, midiNoteNumber, velocity);
+
+    // 记下刚开始的 Voice：该音高上按住且最晚开始的那个
+    int started = -1;
+    for (int i = 0; i < juce::jmin(getNumVoices(), MAX_POLYPHONY); ++i)
+    {
+        auto* voice = getVoice(i);
+        if (voice->getCurrentlyPlayingNote() == midiNoteNumber && voice->isKeyDown()
+            && (started < 0 || getVoice(started)->wasStartedBefore(*voice)))
+            started = i;
+    }
+
+    if (started >= 0)
+        freshVoices |= uint64_t(1) << started;
+}
+
+void EarxSynthesiser::renderVoices(juce::AudioBuffer<float>& outputAudio, int startSample, int numSamples)
+{
+    // 渲染之后各 Voice 的电平已反映实际输出，不再需要保护
+    freshVoices = 0;
+    juce::Synthesiser::renderVoices(outputAudio, startSample, numSamples);
+}
+
+juce::SynthesiserVoice* EarxSynthesiser::findVoiceToSteal(juce::SynthesiserSound* soundToPlay,
+                                                          int, int midiNoteNumber) const
+{
+    // 调用方（noteOn）已持有合成器锁，遍历期间 Voice 列表不会变化
+    juce::SynthesiserVoice* sameNote = nullptr;
+    juce::SynthesiserVoice* best = nullptr;
+    float bestLevel = 0.0f;
+    bool bestFresh = false;
+
+    for (int i = 0; i < getNumVoices(); ++i)
+    {
+        auto* voice = getVoice(i);
+        if (!voice->canPlaySound(soundToPlay))
+            continue;
+
+        // 同音高重复触发：复用最早开始的那个
+        if (voice->getCurrentlyPlayingNote() == midiNoteNumber
+            && (sameNote == nullptr || voice->wasStartedBefore(*sameNote)))
+            sameNote = voice;
+
+        const float level = getVoiceLevel(voice);
+        const bool fresh = i < MAX_POLYPHONY && (freshVoices >> i) & 1;
+        if (best == nullptr || isBetterVictim(voice, level, fresh, best, bestLevel, bestFresh))
+        {
+            best = voice;
+            bestLevel = level;
+            bestFresh = fresh;
+        }
+    }
+
+    auto* victim = sameNote != nullptr ? sameNote : best;
+    if (victim != nullptr)
+        voicesStolen++;
+
+    return victim;
+}
+
+int EarxSynthesiser::getNumActiveVoices() const
+{
+    int count = 0;
+    for (int i = 0; i < getNumVoices(); ++i)
+        if (getVoice(i)->isVoiceActive())
+            ++count;
+    return count;
+}
@@ -0,0 +1,42 @@
+#pragma once
+#include <juce_audio_basics/juce_audio_basics.h>
+#include "EarxVoice.h"
+
+/**
+ * 引擎使用的合成器 - 在 juce::Synthesiser 上替换抢占策略
+ * 职责：
+ * - 复音用尽时按“是否已松开 → 电平 → 年龄”选择被抢占的 Voice：
+ *   先抢已松开且最安静的，其次是仍按住但最安静的，电平相同时抢最早开始的；
+ *   上次渲染之后才开始的 Voice（同一块内的和弦）排在最后，和弦的音不会互相抢占
+ * - 同音高重复触发时优先复用正在播放该音高的 Voice
+ * - 统计抢占次数（音频线程写、任意线程读）
+ *
+ * 被抢占的 Voice 由 juce::Synthesiser::startVoice 以 stopNote(0, false) 通知，
+ * EarxVoice 在该路径上做快速释放，因此这里只负责挑选。
+ */
+class EarxSynthesiser : public juce::Synthesiser
+{
+public:
+    // 复音数上限（Voice 池大小的上限）
+    static constexpr int MAX_POLYPHONY = 64;
+
+    juce::int64 getNumVoicesStolen() const { return voicesStolen.load(); }
+
+    // 当前占用的 Voice 数（不含快速释放中的尾音），调用方需与渲染串行
+    int getNumActiveVoices() const;
+
+    void noteOn(int midiChannel, int midiNoteNumber, float velocity) override;
+
+protected:
+    using juce::Synthesiser::renderVoices;
+    void renderVoices(juce::AudioBuffer<float>& outputAudio, int startSample, int numSamples) override;
+
+    juce::SynthesiserVoice* findVoiceToSteal(juce::SynthesiserSound* soundToPlay,
+                                             int midiChannel, int midiNoteNumber) const override;
+
+private:
+    // 自上次渲染以来开始的 Voice（按 Voice 下标的位图），仅在合成器锁内读写
+    uint64_t freshVoices = 0;
+
+    mutable std::atomic<juce::int64> voicesStolen { 0 };
+};
@@ -0,0 +1,49 @@
+#pragma once
+#include <juce_audio_basics/juce_audio_basics.h>
+#include "LoudnessTable.h"
+
+/**
+ * 引擎内所有 Voice 的公共基类
+ * 职责：
+ * - 向 EarxSynthesiser 报告当前电平，供按响度抢占 Voice
+ * - 统一的音量接口，AudioController 无需按具体类型转换
+ * - 按键响度补偿：起音时按音符取 LoudnessTable 中的固定增益
+ * - 可闻下限：能预知剩余输出峰值的 Voice（采样钢琴）在其低于下限时提前结束，不再渲染听不见的尾部
+ * - 约定硬停止（stopNote 且 allowTailOff == false，包括被抢占）时做短暂的快速释放：
+ *   旧音符的状态被保留下来单独淡出，Voice 本身立即空出给新音符，避免波形突变造成爆音
+ */
+class EarxVoice : public juce::SynthesiserVoice
+{
+public:
+    // 快速释放时长（毫秒）
+    static constexpr double FAST_RELEASE_MS = 3.0;
+
+    virtual void setVolume(float newVolume) = 0;
+
+    // 按键响度补偿表（AudioController 持有，与渲染在同一把锁下更新），为空时不补偿
+    void setLoudnessTable(const LoudnessTable* table) { loudnessTable = table; }
+
+    // 可闻下限（线性幅度，0 为不剔除）；与渲染在同一把锁下设置
+    void setAudibilityFloor(float gain) { audibilityFloor = gain; }
+
+    // 最近一个渲染块的输出峰值（线性幅度，未发声时为 0）；
+    // 采样钢琴报告按幅度包络预估的剩余峰值，正在衰减的音符因此先于刚起音的音符被抢占
+    virtual float getCurrentLevel() const = 0;
+
+protected:
+    float getAudibilityFloor() const { return audibilityFloor; }
+
+    float getLoudnessGain(int midiNote) const
+    {
+        return loudnessTable != nullptr ? loudnessTable->getGain(midiNote) : 1.0f;
+    }
+
+    int getFastReleaseSamples() const
+    {
+        return juce::jmax(1, juce::roundToInt(getSampleRate() * FAST_RELEASE_MS / 1000.0));
+    }
+
+private:
+    const LoudnessTable* loudnessTable = nullptr;
+    float audibilityFloor = 0.0f;
+};
@@ -0,0 +1,199 @@
+#include "ExerciseEngine.h"
+#include "AudioController.h"
+
+namespace
+{
+    struct ChordShape
+    {
+        const char* name;
+        int numNotes;
+        int intervals[ExerciseEngine::MAX_NOTES];
+    };
+
+    constexpr ChordShape kChordShapes[ExerciseEngine::NUM_CHORD_TYPES] = {
+        { "maj",  3, { 0, 4, 7 } },
+        { "min",  3, { 0, 3, 7 } },
+        { "dim",  3, { 0, 3, 6 } },
+        { "aug",  3, { 0, 4, 8 } },
+        { "maj7", 4, { 0, 4, 7, 11 } },
+        { "7",    4, { 0, 4, 7, 10 } },
+        { "m7",   4, { 0, 3, 7, 10 } },
+        { "m7b5", 4, { 0, 3, 6, 10 } },
+        { "dim7", 4, { 0, 3, 6, 9 } },
+    };
+
+    constexpr const char* kIntervalNames[ExerciseEngine::NUM_INTERVALS + 1] = {
+        "P1", "m2", "M2", "m3", "M3", "P4", "TT", "P5", "m6", "M6", "m7", "M7", "P8"
+    };
+
+    struct VoicedChord
+    {
+        int numNotes;
+        int offsets[ExerciseEngine::MAX_NOTES]; // 相对根音的半音数，由低到高
+    };
+
+    constexpr VoicedChord voiceChord(const ChordShape& shape, int inversion, int voicing)
+    {
+        VoicedChord chord {};
+        const int n = shape.numNotes;
+        inversion %= n;
+        chord.numNotes = n;
+
+        // 转位：从第 inversion 个音开始排列，被越过的低音升高八度
+        for (int i = 0; i < n; ++i)
+        {
+            const int source = (i + inversion) % n;
+            chord.offsets[i] = shape.intervals[source] + (source < inversion ? 12 : 0);
+        }
+
+        if (voicing == ExerciseEngine::openVoicing)
+        {
+            // drop-2：次高音降低八度后重新排序
+            chord.offsets[n - 2] -= 12;
+            for (int i = 1; i < n; ++i)
+                for (int j = i; j > 0 && chord.offsets[j - 1] > chord.offsets[j]; --j)
+                {
+                    const int t = chord.offsets[j];
+                    chord.offsets[j] = chord.offsets[j - 1];
+                    chord.offsets[j - 1] = t;
+                }
+        }
+
+        return chord;
+    }
+
+    using VoicingTable = std::array<std::array<std::array<VoicedChord, ExerciseEngine::NUM_VOICINGS>,
+                                               ExerciseEngine::MAX_NOTES>,
+                                    ExerciseEngine::NUM_CHORD_TYPES>;
+
+    constexpr VoicingTable buildVoicingTable()
+    {
+        VoicingTable table {};
+        for (int type = 0; type < ExerciseEngine::NUM_CHORD_TYPES; ++type)
+            for (int inversion = 0; inversion < ExerciseEngine::MAX_NOTES; ++inversion)
+                for (int voicing = 0; voicing < ExerciseEngine::NUM_VOICINGS; ++voicing)
+                    table[type][inversion][voicing] = voiceChord(kChordShapes[type], inversion, voicing);
+        return table;
+    }
+
+    // 编译期生成：[和弦类型][转位][排列方式]
+    constexpr VoicingTable kVoicings = buildVoicingTable();
+
+    static_assert(kVoicings[0][1][ExerciseEngine::closeVoicing].offsets[0] == 4
+                  && kVoicings[0][1][ExerciseEngine::closeVoicing].offsets[2] == 12,
+                  "major triad first inversion should be E-G-C");
+    static_assert(kVoicings[4][0][ExerciseEngine::openVoicing].offsets[0] == -5,
+                  "drop-2 maj7 should put the fifth in the bass");
+
+    // 音域限制：整体按八度移动，保持排列不变
+    constexpr int LOWEST_NOTE = 36;
+    constexpr int HIGHEST_NOTE = 96;
+}
+
+ExerciseEngine::ExerciseEngine(AudioController* audio)
+    : audioController(audio)
+{
+}
+
+ExerciseEngine::Exercise ExerciseEngine::createInterval(int rootNote, int semitones, Style style) const
+{
+    Exercise exercise;
+    exercise.kind = interval;
+    exercise.rootNote = rootNote;
+    exercise.quality = juce::jlimit(1, NUM_INTERVALS, semitones);
+    exercise.style = style;
+    exercise.numNotes = 2;
+    exercise.notes[0] = rootNote;
+    exercise.notes[1] = rootNote + exercise.quality;
+
+    while (exercise.notes[1] > HIGHEST_NOTE)
+    {
+        exercise.notes[0] -= 12;
+        exercise.notes[1] -= 12;
+    }
+    return exercise;
+}
+
+ExerciseEngine::Exercise ExerciseEngine::createChord(int rootNote, int chordType, int inversion, Voicing voicing, Style style) const
+{
+    chordType = juce::jlimit(0, NUM_CHORD_TYPES - 1, chordType);
+    const auto& shape = kChordShapes[chordType];
+
+    Exercise exercise;
+    exercise.kind = chord;
+    exercise.rootNote = rootNote;
+    exercise.quality = chordType;
+    exercise.inversion = juce::jlimit(0, shape.numNotes - 1, inversion);
+    exercise.voicing = voicing;
+    exercise.style = style;
+
+    const auto& voiced = kVoicings[chordType][exercise.inversion][voicing];
+    exercise.numNotes = voiced.numNotes;
+
+    int shift = 0;
+    while (rootNote + voiced.offsets[voiced.numNotes - 1] + shift > HIGHEST_NOTE)
+        shift -= 12;
+    while (rootNote + voiced.offsets[0] + shift < LOWEST_NOTE)
+        shift += 12;
+
+    for (int i = 0; i < voiced.numNotes; ++i)
+        exercise.notes[i] = rootNote + voiced.offsets[i] + shift;
+
+    return exercise;
+}
+
+ExerciseEngine::Exercise ExerciseEngine::createRandomInterval(int rootNote, Style style, SessionRandom& random) const
+{
+    return createInterval(rootNote, 1 + random.nextInt(NUM_INTERVALS), style);
+}
+
+ExerciseEngine::Exercise ExerciseEngine::createRandomChord(int rootNote, int chordTypeBegin, int chordTypeEnd,
+                                                           Style style, SessionRandom& random) const
+{
+    const int chordType = chordTypeBegin + random.nextInt(chordTypeEnd - chordTypeBegin);
+    const int inversion = random.nextInt(kChordShapes[chordType].numNotes);
+    const auto voicing = (Voicing) random.nextInt(NUM_VOICINGS);
+    return createChord(rootNote, chordType, inversion, voicing, style);
+}
+
+juce::int64 ExerciseEngine::play(const Exercise& exercise, double noteSpacingMs, double noteLengthMs, float velocity)
+{
+    if (exercise.numNotes <= 0)
+        return -1;
+
+    const double samplesPerMs = audioController->getSampleRate() / 1000.0;
+    const int spacingSamples = exercise.style == harmonic ? 0 : juce::roundToInt(noteSpacingMs * samplesPerMs);
+    const int lengthSamples = juce::jmax(1, juce::roundToInt(noteLengthMs * samplesPerMs));
+
+    // 按演奏顺序一次排队：和声式的各音以同一个时钟读数落在同一块，队列满时整组不发声
+    int notes[MAX_NOTES];
+    for (int i = 0; i < exercise.numNotes; ++i)
+        notes[i] = exercise.notes[exercise.style == melodicDescending ? exercise.numNotes - 1 - i : i];
+    const auto firstOnset = audioController->scheduleNotes(notes, exercise.numNotes, velocity, 0, spacingSamples, lengthSamples);
+
+    {
+        const juce::SpinLock::ScopedLockType sl(lastExerciseLock);
+        lastExercise = exercise;
+    }
+
+    DBG("Exercise: " + juce::String(exercise.kind == chord ? getChordName(exercise.quality) : getIntervalName(exercise.quality))
+        + " root " + juce::String(exercise.rootNote) + ", inversion " + juce::String(exercise.inversion)
+        + ", style " + juce::String(exercise.style));
+    return firstOnset;
+}
+
+ExerciseEngine::Exercise ExerciseEngine::getLastExercise() const
+{
+    const juce::SpinLock::ScopedLockType sl(lastExerciseLock);
+    return lastExercise;
+}
+
+const char* ExerciseEngine::getIntervalName(int semitones)
+{
+    return kIntervalNames[juce::jlimit(0, NUM_INTERVALS, semitones)];
+}
+
+const char* ExerciseEngine::getChordName(int chordType)
+{
+    return kChordShapes[juce::jlimit(0, NUM_CHORD_TYPES - 1, chordType)].name;
+}
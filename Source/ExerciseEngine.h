@@ -0,0 +1,83 @@
+#pragma once
+#include <juce_core/juce_core.h>
+#include "SessionRandom.h"
+#include <array>
+
+class AudioController;
+
+/**
+ * 音程 / 和弦练习引擎
+ * 职责：
+ * - 由编译期常量表给出音程、三和弦与七和弦（含转位与排列方式）的音高
+ * - 以旋律（先后）或和声（同时）方式播放，所有音符在同一渲染块内按样本偏移安排
+ * - 记录最近一次练习，供 Flutter 端判分
+ */
+class ExerciseEngine
+{
+public:
+    enum Kind
+    {
+        interval = 0,
+        chord = 1
+    };
+
+    enum Style
+    {
+        harmonic = 0,           // 同时发声
+        melodicAscending = 1,   // 由低到高依次发声
+        melodicDescending = 2   // 由高到低依次发声
+    };
+
+    enum Voicing
+    {
+        closeVoicing = 0,       // 密集排列
+        openVoicing = 1         // 开放排列（drop-2：次高音降八度）
+    };
+
+    static constexpr int MAX_NOTES = 4;
+    static constexpr int NUM_INTERVALS = 12;    // 小二度 - 纯八度
+    static constexpr int NUM_CHORD_TYPES = 9;   // 前 4 个为三和弦，其余为七和弦
+    static constexpr int NUM_TRIAD_TYPES = 4;
+    static constexpr int NUM_VOICINGS = 2;
+
+    // 练习模式需要的复音数：一个和弦 + 上一个和弦的释音尾巴，并为快速连续出题留余量
+    static constexpr int REQUIRED_POLYPHONY = 24;
+
+    struct Exercise
+    {
+        int kind = interval;
+        int rootNote = -1;      // 根音 MIDI 音符
+        int quality = 0;        // 音程：半音数（1-12）；和弦：和弦类型下标
+        int inversion = 0;
+        int voicing = closeVoicing;
+        int style = harmonic;
+        int numNotes = 0;
+        int notes[MAX_NOTES] = {};  // 由低到高
+    };
+
+    explicit ExerciseEngine(AudioController* audioController);
+
+    Exercise createInterval(int rootNote, int semitones, Style style) const;
+    Exercise createChord(int rootNote, int chordType, int inversion, Voicing voicing, Style style) const;
+
+    // 以给定根音随机生成练习：chordTypeBegin/End 限定和弦类型范围（三和弦或七和弦）
+    Exercise createRandomInterval(int rootNote, Style style, SessionRandom& random) const;
+    Exercise createRandomChord(int rootNote, int chordTypeBegin, int chordTypeEnd, Style style, SessionRandom& random) const;
+
+    // 播放：旋律方式下相邻音符间隔 noteSpacingMs，每个音持续 noteLengthMs
+    // 返回第一个音符在音频时钟上的起始样本（失败返回 -1）
+    juce::int64 play(const Exercise& exercise, double noteSpacingMs, double noteLengthMs, float velocity);
+
+    Exercise getLastExercise() const;
+
+    static const char* getIntervalName(int semitones);
+    static const char* getChordName(int chordType);
+
+private:
+    AudioController* audioController;
+
+    mutable juce::SpinLock lastExerciseLock;
+    Exercise lastExercise;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ExerciseEngine)
+};
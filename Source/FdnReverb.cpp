@@ -0,0 +1,205 @@
+#include "FdnReverb.h"
+
+namespace
+{
+    // 各延迟线长度（毫秒），两两互质的样本数避免共振峰重叠
+    constexpr double kDelayMs[FdnReverb::NUM_LINES] = { 31.3, 37.9, 41.7, 47.3, 53.1, 59.9, 67.7, 73.1 };
+    constexpr float kInputSign[FdnReverb::NUM_LINES]  = { 1.0f, -1.0f, 1.0f, -1.0f, 1.0f, -1.0f, 1.0f, -1.0f };
+    constexpr float kLeftSign[FdnReverb::NUM_LINES]   = { 1.0f, 1.0f, -1.0f, -1.0f, 1.0f, 1.0f, -1.0f, -1.0f };
+    constexpr float kRightSign[FdnReverb::NUM_LINES]  = { 1.0f, -1.0f, -1.0f, 1.0f, 1.0f, -1.0f, -1.0f, 1.0f };
+
+    constexpr float kInputGain = 0.35f;                 // 约 1 / sqrt(NUM_LINES)
+    constexpr float kOutputGain = 0.35f;                // 满湿声时混响与干声的 RMS 比约 0.4
+    constexpr float kSilenceThreshold = 3.16e-5f;       // -90 dB
+    constexpr double kMixSmoothingSeconds = 0.05;
+
+    // 房间大小 0 - 1 对应混响时间 0.2 - 4 秒（按指数分布，小房间一端更细）
+    double getDecaySeconds(float roomSize)
+    {
+        return 0.2 * std::pow(20.0, (double) roomSize);
+    }
+
+    bool isCoprime(int a, int b)
+    {
+        while (b != 0)
+        {
+            const int t = a % b;
+            a = b;
+            b = t;
+        }
+        return a == 1;
+    }
+}
+
+FdnReverb::FdnReverb()
+{
+    alignas(Lanes::SIMDRegisterSize) float values[NUM_LANES];
+    for (int g = 0; g < NUM_GROUPS; ++g)
+    {
+        auto load = [&values, g](const float* source)
+        {
+            std::copy(source + g * NUM_LANES, source + (g + 1) * NUM_LANES, values);
+            return Lanes::fromRawArray(values);
+        };
+        inputSign[g] = load(kInputSign) * kInputGain;
+        outputSignLeft[g] = load(kLeftSign) * kOutputGain;
+        outputSignRight[g] = load(kRightSign) * kOutputGain;
+        lowpass[g] = 0.0f;
+        feedback[g] = 0.0f;
+    }
+}
+
+void FdnReverb::prepare(double sampleRate)
+{
+    currentSampleRate = sampleRate;
+
+    // 延迟长度取互质的样本数
+    longestDelay = 0;
+    for (int l = 0; l < NUM_LINES; ++l)
+    {
+        int frames = juce::roundToInt(kDelayMs[l] * 0.001 * sampleRate);
+        for (int other = 0; other < l; ++other)
+            while (!isCoprime(frames, delayFrames[other]))
+                ++frames;
+        delayFrames[l] = frames;
+        longestDelay = juce::jmax(longestDelay, frames);
+    }
+
+    const int numFrames = juce::nextPowerOfTwo(longestDelay + 1);
+    storage.assign((size_t) (numFrames * NUM_LINES + NUM_LANES), 0.0f);
+    lines = Lanes::getNextSIMDAlignedPtr(storage.data());
+    mask = numFrames - 1;
+    writeFrame = 0;
+
+    mix.reset(sampleRate, kMixSmoothingSeconds);
+    mix.setCurrentAndTargetValue(targetMix.load());
+    appliedRoomSize = appliedDamping = -1.0f;
+    updateCoefficients();
+    clearLines();
+}
+
+void FdnReverb::setRoomSize(float size)
+{
+    roomSize.store(juce::jlimit(0.0f, 1.0f, size));
+}
+
+void FdnReverb::setDamping(float newDamping)
+{
+    damping.store(juce::jlimit(0.0f, 1.0f, newDamping));
+}
+
+void FdnReverb::setMix(float newMix)
+{
+    targetMix.store(juce::jlimit(0.0f, 1.0f, newMix));
+}
+
+void FdnReverb::updateCoefficients()
+{
+    const float size = roomSize.load(std::memory_order_relaxed);
+    const float damp = damping.load(std::memory_order_relaxed);
+    if (size == appliedRoomSize && damp == appliedDamping)
+        return;
+
+    // 每条线的反馈增益使信号每经过 decaySeconds 衰减 60 dB
+    const double decaySeconds = getDecaySeconds(size);
+    alignas(Lanes::SIMDRegisterSize) float gains[NUM_LINES];
+    for (int l = 0; l < NUM_LINES; ++l)
+        gains[l] = (float) std::pow(0.001, (double) delayFrames[l] / (decaySeconds * currentSampleRate));
+    for (int g = 0; g < NUM_GROUPS; ++g)
+        feedback[g] = Lanes::fromRawArray(gains + g * NUM_LANES);
+
+    dampingCoef = 0.8f * damp;
+    appliedRoomSize = size;
+    appliedDamping = damp;
+}
+
+void FdnReverb::clearLines()
+{
+    std::fill(storage.begin(), storage.end(), 0.0f);
+    for (auto& state : lowpass)
+        state = 0.0f;
+    quietSamples = 0;
+}
+
+void FdnReverb::process(juce::AudioBuffer<float>& buffer, int startSample, int numSamples)
+{
+    if (lines == nullptr || buffer.getNumChannels() == 0)
+        return;
+
+    mix.setTargetValue(targetMix.load(std::memory_order_relaxed));
+    if (!mix.isSmoothing() && mix.getCurrentValue() <= 0.0f)
+    {
+        // 湿声为 0：整级旁路，残留尾音直接丢弃
+        if (ringing)
+        {
+            clearLines();
+            ringing = false;
+        }
+        return;
+    }
+
+    const int numChannels = juce::jmin(2, buffer.getNumChannels());
+    if (!ringing)
+    {
+        // 尾音已静音：输入也静音时不做任何运算
+        float inputPeak = 0.0f;
+        for (int ch = 0; ch < numChannels; ++ch)
+            inputPeak = juce::jmax(inputPeak, buffer.getMagnitude(ch, startSample, numSamples));
+        if (inputPeak < kSilenceThreshold)
+        {
+            mix.skip(numSamples);
+            return;
+        }
+        ringing = true;
+        quietSamples = 0;
+    }
+
+    updateCoefficients();
+
+    float* left = buffer.getWritePointer(0, startSample);
+    float* right = numChannels > 1 ? buffer.getWritePointer(1, startSample) : nullptr;
+    const Lanes damp = Lanes::expand(dampingCoef);
+    const float silenceEnergy = kSilenceThreshold * kSilenceThreshold;
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const float input = right != nullptr ? 0.5f * (left[i] + right[i]) : left[i];
+
+        // 按各自的延迟从交错缓冲区取出每条线的输出
+        for (int l = 0; l < NUM_LINES; ++l)
+            tap[l] = lines[(size_t) (((writeFrame - delayFrames[l]) & mask) * NUM_LINES + l)];
+
+        Lanes sum = 0.0f, wetLeft = 0.0f, wetRight = 0.0f, energy = 0.0f;
+        for (int g = 0; g < NUM_GROUPS; ++g)
+        {
+            const auto delayed = Lanes::fromRawArray(tap + g * NUM_LANES);
+            lowpass[g] = delayed + (lowpass[g] - delayed) * damp;
+            sum += lowpass[g];
+            wetLeft += lowpass[g] * outputSignLeft[g];
+            wetRight += lowpass[g] * outputSignRight[g];
+            energy += lowpass[g] * lowpass[g];
+        }
+
+        // Householder 反馈矩阵 I - 2/N · 11ᵀ：减去所有线平均值的两倍，能量守恒且每条线互相混合
+        const auto reflection = Lanes::expand(sum.sum() * (2.0f / (float) NUM_LINES));
+        float* frame = lines + (size_t) writeFrame * NUM_LINES;
+        for (int g = 0; g < NUM_GROUPS; ++g)
+            ((lowpass[g] - reflection) * feedback[g] + inputSign[g] * input).copyToRawArray(frame + g * NUM_LANES);
+        writeFrame = (writeFrame + 1) & mask;
+
+        const float gain = mix.getNextValue();
+        left[i] += wetLeft.sum() * gain;
+        if (right != nullptr)
+            right[i] += wetRight.sum() * gain;
+
+        const bool quiet = std::abs(input) < kSilenceThreshold && energy.sum() < silenceEnergy;
+        quietSamples = quiet ? quietSamples + 1 : 0;
+    }
+
+    // 输入静音且所有线的输出持续低于 -90 dB 超过最长延迟：缓冲区里已没有可闻的能量，自动静音
+    if (quietSamples > longestDelay)
+    {
+        clearLines();
+        ringing = false;
+    }
+}
@@ -0,0 +1,79 @@
+#pragma once
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_dsp/juce_dsp.h>
+
+/**
+ * 反馈延迟网络（FDN）混响 - 主总线上比卷积便宜的算法混响
+ * 职责：
+ * - NUM_LINES 条延迟线存放在同一块预分配的连续缓冲区里，按样本交错（每帧 NUM_LINES 个样本），
+ *   每个样本所有延迟线的写入是一次对齐的 SIMD 存储，读出按各自延迟取样
+ * - 每条延迟线的一阶低通（阻尼）、Householder 反馈矩阵与衰减增益以 SIMD 通道为单位并行计算
+ * - 房间大小只改变反馈增益（混响时间），延迟长度固定，调整参数不会产生不连续
+ * - 湿声电平逐样本平滑；电平为 0 时整级旁路；输入静音且尾音低于 -90 dB 达到最长延迟后自动静音，不再运算
+ *
+ * process 与 prepare 需与渲染串行调用（AudioController 以 synthMutex 保护）；参数设置可在任意线程调用，
+ * 在下一个渲染块开始时生效。
+ */
+class FdnReverb
+{
+public:
+    using Lanes = juce::dsp::SIMDRegister<float>;
+
+    static constexpr int NUM_LINES = 8;
+    static constexpr int NUM_LANES = (int) Lanes::SIMDNumElements;
+    static constexpr int NUM_GROUPS = NUM_LINES / NUM_LANES;
+
+    static_assert(NUM_LINES % NUM_LANES == 0, "delay lines must fill whole SIMD registers");
+
+    FdnReverb();
+
+    // 按采样率分配延迟线缓冲区（不在音频线程调用）
+    void prepare(double sampleRate);
+
+    // 房间大小 0 - 1（混响时间约 0.2 - 4 秒）、阻尼 0 - 1（越大高频衰减越快）、湿声电平 0 - 1（干声不变）
+    void setRoomSize(float size);
+    void setDamping(float damping);
+    void setMix(float mix);
+    float getRoomSize() const { return roomSize.load(); }
+    float getDamping() const { return damping.load(); }
+    float getMix() const { return targetMix.load(); }
+
+    // 把湿声叠加到 buffer 的前两个声道上（干声保持不变）
+    void process(juce::AudioBuffer<float>& buffer, int startSample, int numSamples);
+
+    // 尾音是否仍在衰减（旁路或已自动静音时为 false）
+    bool isRinging() const { return ringing; }
+
+private:
+    void updateCoefficients();
+    void clearLines();
+
+    std::vector<float> storage;         // 所有延迟线的连续缓冲区（含对齐余量）
+    float* lines = nullptr;             // 按 SIMD 对齐后的起点，帧 i 的第 l 条线位于 lines[i * NUM_LINES + l]
+    int mask = 0;                       // 帧数为 2 的幂，写位置按 mask 回绕
+    int writeFrame = 0;
+    int delayFrames[NUM_LINES] = {};
+    int longestDelay = 0;
+
+    // 每条线的状态与系数，每个 SIMD 寄存器对应 NUM_LANES 条线
+    Lanes lowpass[NUM_GROUPS];
+    Lanes feedback[NUM_GROUPS];
+    Lanes inputSign[NUM_GROUPS];
+    Lanes outputSignLeft[NUM_GROUPS];
+    Lanes outputSignRight[NUM_GROUPS];
+    alignas(Lanes::SIMDRegisterSize) float tap[NUM_LINES] = {};
+    float dampingCoef = 0.0f;
+    float appliedRoomSize = -1.0f;
+    float appliedDamping = -1.0f;
+
+    std::atomic<float> roomSize { 0.5f };
+    std::atomic<float> damping { 0.5f };
+    std::atomic<float> targetMix { 0.0f };
+    juce::SmoothedValue<float> mix { 0.0f };
+
+    double currentSampleRate = 0.0;
+    bool ringing = false;
+    int quietSamples = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(FdnReverb)
+};
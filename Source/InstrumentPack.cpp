@@ -0,0 +1,287 @@
+#include "InstrumentPack.h"
+#include <cstring>
+#include <map>
+
+namespace
+{
+    constexpr int kMaxRegions = 4096;
+    constexpr int kMaxChannels = 8;
+
+    juce::int64 alignPayload(juce::int64 position)
+    {
+        const juce::int64 alignment = InstrumentPack::PAYLOAD_ALIGNMENT;
+        return (position + alignment - 1) / alignment * alignment;
+    }
+
+    void writePadding(juce::OutputStream& out, juce::int64 targetPosition)
+    {
+        while (out.getPosition() < targetPosition)
+            out.writeByte(0);
+    }
+
+    // 打包时的载荷：原始样本文件内容，或解码裁切后的浮点样本
+    struct Payload
+    {
+        juce::MemoryBlock fileData;
+        std::shared_ptr<juce::AudioBuffer<float>> samples;
+        double sampleRate = 0.0;
+        int numChannels = 0;
+        int numFrames = 0;
+        juce::int64 offset = 0;
+        juce::int64 bytes = 0;
+    };
+}
+
+std::unique_ptr<InstrumentPack> InstrumentPack::open(const juce::File& packFile)
+{
+    auto mapping = std::make_shared<juce::MemoryMappedFile>(packFile, juce::MemoryMappedFile::readOnly);
+    const auto fileSize = (juce::int64) mapping->getSize();
+    if (mapping->getData() == nullptr || fileSize < HEADER_SIZE)
+    {
+        DBG("Could not map instrument pack: " + packFile.getFullPathName());
+        return nullptr;
+    }
+
+    juce::MemoryInputStream in(mapping->getData(), (size_t) fileSize, false);
+    char magic[8] = {};
+    in.read(magic, sizeof(magic));
+    const int version = in.readInt();
+    const int numRegions = in.readInt();
+    const juce::int64 tableOffset = in.readInt64();
+    in.readInt();   // 载荷对齐（读取时不依赖）
+    in.readInt();
+    const juce::int64 declaredSize = in.readInt64();
+
+    if (std::memcmp(magic, MAGIC, sizeof(magic)) != 0 || version != FORMAT_VERSION || declaredSize != fileSize
+        || numRegions < 0 || numRegions > kMaxRegions
+        || tableOffset < HEADER_SIZE || tableOffset + (juce::int64) numRegions * REGION_ENTRY_SIZE > fileSize)
+    {
+        DBG("Invalid instrument pack header: " + packFile.getFullPathName());
+        return nullptr;
+    }
+
+    std::unique_ptr<InstrumentPack> pack(new InstrumentPack());
+    pack->mapping = mapping;
+
+    for (int i = 0; i < numRegions; ++i)
+    {
+        in.setPosition(tableOffset + (juce::int64) i * REGION_ENTRY_SIZE);
+
+        PianoSound::Region region;
+        region.sampleFile = packFile;
+        region.loKey = in.readInt();
+        region.hiKey = in.readInt();
+        region.rootNote = in.readInt();
+        region.offset = in.readInt();
+
+        Entry entry;
+        entry.sampleRate = in.readDouble();
+        entry.encoding = in.readInt();
+        entry.numChannels = in.readInt();
+        entry.numFrames = in.readInt();
+        in.readInt();
+        entry.payloadOffset = in.readInt64();
+        entry.payloadBytes = in.readInt64();
+
+        const bool validPayload = entry.payloadOffset >= HEADER_SIZE && entry.payloadBytes > 0
+                               && entry.payloadOffset + entry.payloadBytes <= fileSize;
+        const bool validFloat = entry.encoding != encodingFloat32
+                             || (entry.payloadOffset % (juce::int64) sizeof(float) == 0
+                                 && entry.payloadBytes == (juce::int64) entry.numChannels * entry.numFrames * (juce::int64) sizeof(float));
+        if (!validPayload || !validFloat || entry.sampleRate <= 0.0
+            || entry.numChannels < 1 || entry.numChannels > kMaxChannels || entry.numFrames < 1
+            || (entry.encoding != encodingFloat32 && entry.encoding != encodingFile))
+        {
+            DBG("Invalid instrument pack region " + juce::String(i) + ": " + packFile.getFullPathName());
+            return nullptr;
+        }
+
+        pack->regions.add(region);
+        pack->entries.add(entry);
+    }
+
+    DBG("Opened instrument pack: " + packFile.getFullPathName() + " (" + juce::String(numRegions) + " regions, "
+        + juce::String(fileSize / 1024) + " KB)");
+    return pack;
+}
+
+std::shared_ptr<juce::AudioBuffer<float>> InstrumentPack::loadRegionSamples(int regionIndex, double& sampleRate) const
+{
+    if (!juce::isPositiveAndBelow(regionIndex, entries.size()))
+        return nullptr;
+
+    const auto& entry = entries.getReference(regionIndex);
+    sampleRate = entry.sampleRate;
+    const auto* payload = static_cast<const char*>(mapping->getData()) + entry.payloadOffset;
+
+    if (entry.encoding == encodingFloat32)
+    {
+        // 直接引用映射内存：样本加载后只读，缓冲区的删除器持有映射，最后一个使用者释放后才解除映射
+        float* channels[kMaxChannels] = {};
+        for (int ch = 0; ch < entry.numChannels; ++ch)
+            channels[ch] = const_cast<float*>(reinterpret_cast<const float*>(payload) + (size_t) ch * (size_t) entry.numFrames);
+
+        auto keepMapped = mapping;
+        return std::shared_ptr<juce::AudioBuffer<float>>(new juce::AudioBuffer<float>(channels, entry.numChannels, entry.numFrames),
+                                                         [keepMapped](juce::AudioBuffer<float>* buffer) { delete buffer; });
+    }
+
+    juce::AudioFormatManager formatManager;
+    formatManager.registerBasicFormats();
+    std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(
+        std::make_unique<juce::MemoryInputStream>(payload, (size_t) entry.payloadBytes, false)));
+    if (reader == nullptr)
+    {
+        DBG("Could not decode instrument pack payload at " + juce::String(entry.payloadOffset));
+        return nullptr;
+    }
+
+    return PianoSound::decodeSample(*reader, "payload at " + juce::String(entry.payloadOffset));
+}
+
+bool InstrumentPack::write(const juce::File& sfzFile, const juce::File& packFile, Encoding encoding, juce::String& errorMessage)
+{
+    if (!sfzFile.existsAsFile())
+    {
+        errorMessage = "SFZ file not found: " + sfzFile.getFullPathName();
+        return false;
+    }
+
+    auto sfzRegions = PianoSound::parseSFZRegions(sfzFile);
+    if (sfzRegions.isEmpty())
+    {
+        errorMessage = "no regions in " + sfzFile.getFullPathName();
+        return false;
+    }
+
+    // 收集载荷：同一个样本文件只存一次
+    juce::AudioFormatManager formatManager;
+    formatManager.registerBasicFormats();
+    std::vector<Payload> payloads;
+    std::map<juce::String, int> payloadIndices;
+    juce::Array<int> regionPayloads;
+
+    for (const auto& region : sfzRegions)
+    {
+        const auto path = region.sampleFile.getFullPathName();
+        auto existing = payloadIndices.find(path);
+        if (existing != payloadIndices.end())
+        {
+            regionPayloads.add(existing->second);
+            continue;
+        }
+
+        Payload payload;
+        if (encoding == encodingFloat32)
+        {
+            payload.samples = PianoSound::loadSampleFile(region.sampleFile, payload.sampleRate);
+            if (payload.samples == nullptr)
+            {
+                errorMessage = "could not decode " + path;
+                return false;
+            }
+            payload.numChannels = payload.samples->getNumChannels();
+            payload.numFrames = payload.samples->getNumSamples();
+            payload.bytes = (juce::int64) payload.numChannels * payload.numFrames * (juce::int64) sizeof(float);
+        }
+        else
+        {
+            std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(region.sampleFile));
+            if (reader == nullptr || !region.sampleFile.loadFileAsData(payload.fileData))
+            {
+                errorMessage = "could not read " + path;
+                return false;
+            }
+            payload.sampleRate = reader->sampleRate;
+            payload.numChannels = (int) reader->numChannels;
+            payload.numFrames = (int) reader->lengthInSamples;
+            payload.bytes = (juce::int64) payload.fileData.getSize();
+        }
+
+        if (payload.numChannels < 1 || payload.numChannels > kMaxChannels || payload.numFrames < 1)
+        {
+            errorMessage = "unsupported sample layout in " + path;
+            return false;
+        }
+
+        payloadIndices[path] = (int) payloads.size();
+        regionPayloads.add((int) payloads.size());
+        payloads.push_back(std::move(payload));
+    }
+
+    // 布局：文件头 → region 表 → 逐个对齐的载荷
+    const juce::int64 tableOffset = HEADER_SIZE;
+    juce::int64 position = tableOffset + (juce::int64) sfzRegions.size() * REGION_ENTRY_SIZE;
+    for (auto& payload : payloads)
+    {
+        payload.offset = alignPayload(position);
+        position = payload.offset + payload.bytes;
+    }
+    const juce::int64 fileSize = position;
+
+    juce::TemporaryFile temporary(packFile);
+    {
+        juce::FileOutputStream out(temporary.getFile());
+        if (out.failedToOpen())
+        {
+            errorMessage = "could not create " + temporary.getFile().getFullPathName();
+            return false;
+        }
+
+        out.write(MAGIC, 8);
+        out.writeInt(FORMAT_VERSION);
+        out.writeInt(sfzRegions.size());
+        out.writeInt64(tableOffset);
+        out.writeInt(PAYLOAD_ALIGNMENT);
+        out.writeInt(0);
+        out.writeInt64(fileSize);
+        writePadding(out, tableOffset);
+
+        for (int i = 0; i < sfzRegions.size(); ++i)
+        {
+            const auto& region = sfzRegions.getReference(i);
+            const auto& payload = payloads[(size_t) regionPayloads[i]];
+            out.writeInt(region.loKey);
+            out.writeInt(region.hiKey);
+            out.writeInt(region.rootNote);
+            out.writeInt(region.offset);
+            out.writeDouble(payload.sampleRate);
+            out.writeInt(encoding);
+            out.writeInt(payload.numChannels);
+            out.writeInt(payload.numFrames);
+            out.writeInt(0);
+            out.writeInt64(payload.offset);
+            out.writeInt64(payload.bytes);
+            writePadding(out, tableOffset + (juce::int64) (i + 1) * REGION_ENTRY_SIZE);
+        }
+
+        // 浮点载荷按主机字节序写入（所有目标平台均为小端）
+        for (const auto& payload : payloads)
+        {
+            writePadding(out, payload.offset);
+            if (payload.samples != nullptr)
+            {
+                for (int ch = 0; ch < payload.numChannels; ++ch)
+                    out.write(payload.samples->getReadPointer(ch), (size_t) payload.numFrames * sizeof(float));
+            }
+            else
+            {
+                out.write(payload.fileData.getData(), payload.fileData.getSize());
+            }
+        }
+
+        out.flush();
+        if (out.getStatus().failed() || out.getPosition() != fileSize)
+        {
+            errorMessage = "write failed: " + out.getStatus().getErrorMessage();
+            return false;
+        }
+    }
+
+    if (!temporary.overwriteTargetFileWithTemporary())
+    {
+        errorMessage = "could not replace " + packFile.getFullPathName();
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,74 @@
+#pragma once
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_core/juce_core.h>
+#include <memory>
+#include "PianoSound.h"
+
+/**
+ * 打包乐器文件（.earxpack）- 把 SFZ 与其引用的全部样本合成一个文件，加载时只打开、映射一次
+ * 格式（小端）：
+ * - 文件头 HEADER_SIZE 字节：MAGIC、FORMAT_VERSION、region 数、region 表偏移、载荷对齐、文件总长
+ * - region 表：每项 REGION_ENTRY_SIZE 字节，按 SFZ 中的顺序保存键范围、根音、SFZ offset、采样率、
+ *   载荷编码、声道数、帧数、载荷偏移与长度
+ * - 载荷：每个起点按 PAYLOAD_ALIGNMENT 对齐。encodingFloat32 为解码并裁切尾部后的 32 位浮点
+ *   （按声道依次存放），直接引用映射内存，不复制；encodingFile 为原样保存的样本文件（FLAC/WAV 等），
+ *   加载时从映射内存解码并裁切，与 SFZ 加载结果一致
+ *
+ * 多个 region 引用同一个样本文件时载荷只存一次。write 供打包工具（earx_pack）与基准测试使用。
+ */
+class InstrumentPack
+{
+public:
+    static constexpr const char* FILE_EXTENSION = ".earxpack";
+    static constexpr const char* MAGIC = "EARXPACK";
+    static constexpr int FORMAT_VERSION = 1;
+    static constexpr int HEADER_SIZE = 64;
+    static constexpr int REGION_ENTRY_SIZE = 64;
+    static constexpr int PAYLOAD_ALIGNMENT = 4096;      // 与内存页对齐，载荷可单独映射
+
+    enum Encoding
+    {
+        encodingFloat32 = 0,    // 已解码的浮点样本，映射后直接播放
+        encodingFile = 1        // 原始样本文件，加载时解码（体积小）
+    };
+
+    // 按扩展名判断是否为打包文件
+    static bool isPackFile(const juce::File& file) { return file.hasFileExtension(FILE_EXTENSION); }
+
+    // 映射并校验打包文件，失败（文件不存在、格式或版本不符、表项越界）返回 nullptr
+    static std::unique_ptr<InstrumentPack> open(const juce::File& packFile);
+
+    // 把 sfzFile 及其引用的样本写成打包文件；失败时返回 false 并在 errorMessage 中说明原因
+    static bool write(const juce::File& sfzFile, const juce::File& packFile, Encoding encoding, juce::String& errorMessage);
+
+    // region 列表（sampleFile 均为打包文件本身），顺序与 SFZ 一致
+    const juce::Array<PianoSound::Region>& getRegions() const { return regions; }
+
+    // 第 regionIndex 个 region 的样本（尾部已裁切）；浮点载荷引用映射内存，返回的缓冲区持有映射，不可写入
+    std::shared_ptr<juce::AudioBuffer<float>> loadRegionSamples(int regionIndex, double& sampleRate) const;
+
+    // 载荷在文件中的偏移：共用同一样本文件的 region 相同，加载时据此只解码一次
+    juce::int64 getPayloadOffset(int regionIndex) const { return entries[regionIndex].payloadOffset; }
+
+    // 映射的文件大小（字节）
+    size_t getFileSize() const { return mapping != nullptr ? mapping->getSize() : 0; }
+
+private:
+    struct Entry
+    {
+        double sampleRate = 0.0;
+        int encoding = encodingFloat32;
+        int numChannels = 0;
+        int numFrames = 0;
+        juce::int64 payloadOffset = 0;
+        juce::int64 payloadBytes = 0;
+    };
+
+    InstrumentPack() = default;
+
+    std::shared_ptr<juce::MemoryMappedFile> mapping;
+    juce::Array<PianoSound::Region> regions;
+    juce::Array<Entry> entries;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(InstrumentPack)
+};
@@ -0,0 +1,113 @@
+#include "LoudnessTable.h"
+#include "EarxVoice.h"
+
+namespace
+{
+    constexpr int kRenderChunk = 256;
+    constexpr double kSilenceMeanSquare = 1.0e-10;     // -100 dB：按键无声（例如样本缺失）时不补偿
+
+    // 直接 II 型转置的双二阶滤波器
+    struct Biquad
+    {
+        double b0 = 1.0, b1 = 0.0, b2 = 0.0, a1 = 0.0, a2 = 0.0;
+        double z1 = 0.0, z2 = 0.0;
+
+        double process(double x)
+        {
+            const double y = b0 * x + z1;
+            z1 = b1 * x - a1 * y + z2;
+            z2 = b2 * x - a2 * y;
+            return y;
+        }
+    };
+
+    // BS.1770 K 加权的两级滤波器，按任意采样率由模拟原型双线性变换得到
+    void makeKWeighting(double sampleRate, Biquad& shelf, Biquad& highpass)
+    {
+        {
+            const double f0 = 1681.974450955533, gainDb = 3.999843853973347, q = 0.7071752369554196;
+            const double k = std::tan(juce::MathConstants<double>::pi * f0 / sampleRate);
+            const double vh = std::pow(10.0, gainDb / 20.0);
+            const double vb = std::pow(vh, 0.4996667741545416);
+            const double a0 = 1.0 + k / q + k * k;
+            shelf.b0 = (vh + vb * k / q + k * k) / a0;
+            shelf.b1 = 2.0 * (k * k - vh) / a0;
+            shelf.b2 = (vh - vb * k / q + k * k) / a0;
+            shelf.a1 = 2.0 * (k * k - 1.0) / a0;
+            shelf.a2 = (1.0 - k / q + k * k) / a0;
+        }
+        {
+            const double f0 = 38.13547087602444, q = 0.5003270373238773;
+            const double k = std::tan(juce::MathConstants<double>::pi * f0 / sampleRate);
+            const double a0 = 1.0 + k / q + k * k;
+            highpass.b0 = 1.0;
+            highpass.b1 = -2.0;
+            highpass.b2 = 1.0;
+            highpass.a1 = 2.0 * (k * k - 1.0) / a0;
+            highpass.a2 = (1.0 - k / q + k * k) / a0;
+        }
+    }
+}
+
+LoudnessTable LoudnessTable::measure(const NoteRenderer& renderNote, double sampleRate)
+{
+    LoudnessTable table;
+    juce::AudioBuffer<float> buffer(1, juce::roundToInt(ANALYSIS_SECONDS * sampleRate));
+
+    for (int key = LOWEST_MEASURED_KEY; key <= HIGHEST_MEASURED_KEY; ++key)
+    {
+        buffer.clear();
+        renderNote(key, REFERENCE_VELOCITY, buffer);
+
+        Biquad shelf, highpass;
+        makeKWeighting(sampleRate, shelf, highpass);
+        const float* data = buffer.getReadPointer(0);
+        double sum = 0.0;
+        for (int i = 0; i < buffer.getNumSamples(); ++i)
+        {
+            const double y = highpass.process(shelf.process(data[i]));
+            sum += y * y;
+        }
+
+        const double meanSquare = sum / buffer.getNumSamples();
+        if (meanSquare < kSilenceMeanSquare)
+            continue;
+
+        const float offset = juce::jlimit(-MAX_CUT_DB, MAX_BOOST_DB, TARGET_LOUDNESS_DB - (float) (10.0 * std::log10(meanSquare)));
+        table.offsetQuarterDb[key] = (int8_t) juce::roundToInt(offset * 4.0f);
+    }
+
+    for (int key = 0; key < LOWEST_MEASURED_KEY; ++key)
+        table.offsetQuarterDb[key] = table.offsetQuarterDb[LOWEST_MEASURED_KEY];
+    for (int key = HIGHEST_MEASURED_KEY + 1; key < NUM_KEYS; ++key)
+        table.offsetQuarterDb[key] = table.offsetQuarterDb[HIGHEST_MEASURED_KEY];
+
+    return table;
+}
+
+LoudnessTable LoudnessTable::measureVoice(std::unique_ptr<EarxVoice> voice, juce::SynthesiserSound& sound, double sampleRate)
+{
+    // Voice 只有经合成器起音后才处于激活状态；直接起音，绕过 sound 的 appliesToNote（其启用状态）
+    struct MeasurementSynthesiser : public juce::Synthesiser
+    {
+        using juce::Synthesiser::startVoice;
+    };
+
+    voice->setVolume(1.0f);
+    voice->setLoudnessTable(nullptr);
+    MeasurementSynthesiser synth;
+    auto* measuringVoice = synth.addVoice(voice.release());
+    synth.setCurrentPlaybackSampleRate(sampleRate);
+    juce::AudioBuffer<float> discard(1, kRenderChunk);
+
+    return measure([&synth, measuringVoice, &sound, &discard](int midiNote, float velocity, juce::AudioBuffer<float>& buffer)
+    {
+        synth.startVoice(measuringVoice, &sound, 1, midiNote, velocity);
+        for (int offset = 0; offset < buffer.getNumSamples(); offset += kRenderChunk)
+            measuringVoice->renderNextBlock(buffer, offset, juce::jmin(kRenderChunk, buffer.getNumSamples() - offset));
+
+        // 硬停止后的快速释放渲染到丢弃缓冲区，不混进下一个键的测量
+        measuringVoice->stopNote(0.0f, false);
+        measuringVoice->renderNextBlock(discard, 0, kRenderChunk);
+    }, sampleRate);
+}
@@ -0,0 +1,46 @@
+#pragma once
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <functional>
+#include <memory>
+
+class EarxVoice;
+
+/**
+ * 按键响度补偿表 - 让所有音色、所有音区在同样力度下听起来一样响
+ * 职责：
+ * - 逐键渲染一个参考力度的音符，经 ITU-R BS.1770 的 K 加权（高频搁架 + RLB 高通）后
+ *   求起音后 ANALYSIS_SECONDS 内的均方响度，与 TARGET_LOUDNESS_DB 的差值即该键的补偿增益
+ * - 补偿量限制在 -MAX_CUT_DB .. +MAX_BOOST_DB，以 0.25 dB 为步长存成每键一个字节的紧凑表；
+ *   测量范围（钢琴 88 键）之外的键沿用最近的测量值
+ * - 默认构造的表不做补偿（增益 1）
+ *
+ * measure 在调用线程同步渲染（每个音色数十毫秒），不在音频线程调用；
+ * 表本身只是数据，读写由持有者（AudioController 以 synthMutex）串行化。
+ */
+class LoudnessTable
+{
+public:
+    static constexpr int NUM_KEYS = 128;
+    static constexpr int LOWEST_MEASURED_KEY = 21;     // A0
+    static constexpr int HIGHEST_MEASURED_KEY = 108;   // C8
+    static constexpr float REFERENCE_VELOCITY = 0.8f;  // 与 PlaybackEngine 播放音符的力度一致
+    static constexpr double ANALYSIS_SECONDS = 0.25;
+    static constexpr float TARGET_LOUDNESS_DB = -20.0f; // K 加权均方（dB，相对满幅），约为钢琴样本中音区的响度
+    static constexpr float MAX_BOOST_DB = 6.0f;
+    static constexpr float MAX_CUT_DB = 24.0f;
+
+    // 把 midiNote 以 velocity 起音的单声道输出叠加到 buffer（已清零，长度即分析时长）
+    using NoteRenderer = std::function<void(int midiNote, float velocity, juce::AudioBuffer<float>& buffer)>;
+
+    // 逐键测量 renderNote 的响度并生成补偿表
+    static LoudnessTable measure(const NoteRenderer& renderNote, double sampleRate);
+
+    // 用一个独立的 Voice 实例（音量 1、不挂补偿表）渲染 sound 的每个键；不经过 sound 的启用状态，sound 只被读取
+    static LoudnessTable measureVoice(std::unique_ptr<EarxVoice> voice, juce::SynthesiserSound& sound, double sampleRate);
+
+    float getOffsetDb(int midiNote) const { return offsetQuarterDb[juce::jlimit(0, NUM_KEYS - 1, midiNote)] * 0.25f; }
+    float getGain(int midiNote) const { return juce::Decibels::decibelsToGain(getOffsetDb(midiNote)); }
+
+private:
+    int8_t offsetQuarterDb[NUM_KEYS] = {};
+};
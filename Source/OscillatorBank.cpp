@@ -0,0 +1,517 @@
+#include "OscillatorBank.h"
+
+namespace
+{
+    constexpr float kReleaseCoefficient = 0.995f;   // 松开后每样本的衰减（与原 SineVoice 一致）
+    constexpr float kReleaseThreshold = 0.01f;      // 释音包络低于此值时结束
+    constexpr double kAttackSeconds = 0.01;
+    constexpr double kPhaseToRadians = juce::MathConstants<double>::twoPi / 4294967296.0;
+}
+
+OscillatorBank::OscillatorBank()
+{
+    prepare(sampleRate);
+}
+
+void OscillatorBank::prepare(double newSampleRate)
+{
+    sampleRate = newSampleRate;
+    attackStepPerSample = 1.0f / (float) juce::jmax(1, (int) (kAttackSeconds * sampleRate));
+    fastReleaseSamples = juce::jmax(1, juce::roundToInt(sampleRate * EarxVoice::FAST_RELEASE_MS / 1000.0));
+    reset();
+}
+
+void OscillatorBank::setPolyphony(int numVoices)
+{
+    numVoices = juce::jlimit(1, MAX_VOICES, numVoices);
+    for (int v = numVoices; v < polyphony; ++v)
+    {
+        stage[v] = idle;
+        level[v] = 0.0f;
+        tailGain[v] = 0.0f;
+    }
+    polyphony = numVoices;
+}
+
+void OscillatorBank::reset()
+{
+    for (int v = 0; v < MAX_VOICES; ++v)
+    {
+        stage[v] = idle;
+        level[v] = 0.0f;
+        attack[v] = 0.0f;
+        release[v] = 1.0f;
+        releaseCoef[v] = 1.0f;
+        tailGain[v] = 0.0f;
+    }
+}
+
+//==============================================================================
+void OscillatorBank::noteOn(int note, float velocity)
+{
+    // 与 juce::Synthesiser 一致：同一音高仍按住时先松开旧音符
+    for (int v = 0; v < polyphony; ++v)
+        if (stage[v] == held && midiNote[v] == note)
+            releaseVoice(v);
+
+    int voice = findFreeVoice();
+    if (voice < 0)
+    {
+        voice = findVoiceToSteal(note);
+        if (voice < 0)
+            return;
+
+        stopVoiceImmediately(voice);
+        voicesStolen++;
+    }
+
+    startVoice(voice, note, velocity);
+}
+
+void OscillatorBank::noteOff(int note)
+{
+    for (int v = 0; v < polyphony; ++v)
+        if (stage[v] == held && midiNote[v] == note)
+            releaseVoice(v);
+}
+
+void OscillatorBank::allNotesOff(bool allowTailOff)
+{
+    for (int v = 0; v < polyphony; ++v)
+    {
+        if (allowTailOff)
+        {
+            if (stage[v] == held)
+                releaseVoice(v);
+        }
+        else
+        {
+            stopVoiceImmediately(v);
+        }
+    }
+}
+
+int OscillatorBank::findFreeVoice() const
+{
+    for (int v = 0; v < polyphony; ++v)
+        if (stage[v] == idle)
+            return v;
+    return -1;
+}
+
+int OscillatorBank::findVoiceToSteal(int note) const
+{
+    // 同音高重复触发优先；否则刚开始（尚未渲染）的排在最后，已松开的排在按住的之前，
+    // 同组内目标电平低者优先，再按年龄
+    int sameNote = -1;
+    int best = -1;
+    float bestLevel = 0.0f;
+
+    for (int v = 0; v < polyphony; ++v)
+    {
+        if (stage[v] == idle)
+            continue;
+
+        if (midiNote[v] == note && (sameNote < 0 || noteOnOrder[v] < noteOnOrder[sameNote]))
+            sameNote = v;
+
+        const float voiceLevel = getTargetLevel(v);
+        const bool fresh = noteOnOrder[v] > renderedNoteCounter;
+        bool better = best < 0;
+        if (!better && fresh != (noteOnOrder[best] > renderedNoteCounter))
+            better = !fresh;
+        else if (!better && (stage[v] == released) != (stage[best] == released))
+            better = stage[v] == released;
+        else if (!better && voiceLevel != bestLevel)
+            better = voiceLevel < bestLevel;
+        else if (!better)
+            better = noteOnOrder[v] < noteOnOrder[best];
+
+        if (better)
+        {
+            best = v;
+            bestLevel = voiceLevel;
+        }
+    }
+
+    return sameNote >= 0 ? sameNote : best;
+}
+
+float OscillatorBank::getVoiceLevel(int v) const
+{
+    if (stage[v] == idle || release[v] < kReleaseThreshold)
+        return 0.0f;
+    return level[v] * volume * juce::jmin(attack[v], 1.0f) * release[v];
+}
+
+float OscillatorBank::getTargetLevel(int v) const
+{
+    // 抢占排序用：不计起音包络，同一块内刚开始的音符不会因 attack 为 0 而显得最安静
+    if (stage[v] == idle || release[v] < kReleaseThreshold)
+        return 0.0f;
+    return level[v] * volume * release[v];
+}
+
+void OscillatorBank::startVoice(int v, int note, float velocity)
+{
+    // 定点相位增量：频率分辨率 sampleRate / 2^32（约 1e-5 Hz）
+    const double cycles = juce::MidiMessage::getMidiNoteInHertz(note) / sampleRate;
+    phase[v] = 0;
+    phaseIncrement[v] = (uint32_t) std::llround(juce::jlimit(0.0, 0.5, cycles) * 4294967296.0);
+    const double radiansPerSample = phaseIncrement[v] * kPhaseToRadians;
+    rotationCos[v] = (float) std::cos(radiansPerSample);
+    rotationSin[v] = (float) std::sin(radiansPerSample);
+    const double radiansPerStep = (uint32_t) (phaseIncrement[v] * (uint32_t) VOICE_STEP) * kPhaseToRadians;
+    stepCos[v] = (float) std::cos(radiansPerStep);
+    stepSin[v] = (float) std::sin(radiansPerStep);
+    level[v] = loudnessTable != nullptr ? velocity * loudnessTable->getGain(note) : velocity;
+    attack[v] = 0.0f;
+    release[v] = 1.0f;
+    releaseCoef[v] = 1.0f;
+    stage[v] = held;
+    midiNote[v] = note;
+    noteOnOrder[v] = ++noteCounter;
+}
+
+void OscillatorBank::releaseVoice(int v)
+{
+    stage[v] = released;
+    releaseCoef[v] = kReleaseCoefficient;
+}
+
+void OscillatorBank::stopVoiceImmediately(int v)
+{
+    if (stage[v] == idle)
+        return;
+
+    // 接管当前相位与电平做快速释放，Voice 立即空出
+    tailPhase[v] = phase[v];
+    tailPhaseIncrement[v] = phaseIncrement[v];
+    tailGain[v] = getVoiceLevel(v);
+    tailStep[v] = tailGain[v] / (float) fastReleaseSamples;
+
+    stage[v] = idle;
+    level[v] = 0.0f;
+    release[v] = 1.0f;
+    releaseCoef[v] = 1.0f;
+}
+
+int OscillatorBank::getNumActiveVoices() const
+{
+    int count = 0;
+    for (int v = 0; v < polyphony; ++v)
+        if (stage[v] != idle)
+            ++count;
+    return count;
+}
+
+bool OscillatorBank::isNoteActive(int note) const
+{
+    for (int v = 0; v < polyphony; ++v)
+        if (stage[v] != idle && midiNote[v] == note)
+            return true;
+    return false;
+}
+
+//==============================================================================
+void OscillatorBank::handleMidiEvent(const juce::MidiMessage& message)
+{
+    if (message.isNoteOn())
+        noteOn(message.getNoteNumber(), message.getFloatVelocity());
+    else if (message.isNoteOff())
+        noteOff(message.getNoteNumber());
+    else if (message.isAllNotesOff() || message.isAllSoundOff())
+        allNotesOff(true);
+}
+
+void OscillatorBank::renderNextBlock(juce::AudioBuffer<float>& buffer, const juce::MidiBuffer& midi,
+                                     int startSample, int numSamples)
+{
+    const int endSample = startSample + numSamples;
+    int position = startSample;
+
+    for (auto it = midi.findNextSamplePosition(startSample); it != midi.cend(); ++it)
+    {
+        const auto metadata = *it;
+        if (metadata.samplePosition >= endSample)
+            break;
+
+        // 事件之前的部分先渲染，事件在其样本位置生效
+        if (metadata.samplePosition > position)
+        {
+            renderVoices(buffer, position, metadata.samplePosition - position);
+            position = metadata.samplePosition;
+        }
+        handleMidiEvent(metadata.getMessage());
+    }
+
+    if (position < endSample)
+        renderVoices(buffer, position, endSample - position);
+}
+
+bool OscillatorBank::isGroupSilent(int group) const
+{
+    const int first = group * NUM_LANES;
+    for (int v = first; v < first + NUM_LANES; ++v)
+        if (stage[v] != idle || tailGain[v] > 0.0f)
+            return false;
+    return true;
+}
+
+bool OscillatorBank::isVoiceSteady(int v) const
+{
+    return stage[v] == held && attack[v] >= 1.0f;
+}
+
+bool OscillatorBank::shouldRenderGroupInLanes(int group) const
+{
+    // 组内 Voice 全部发声、且有 Voice 处于起音或释音（逐样本包络）时整组并行更省；
+    // 否则逐个 Voice 按时间展开：空通道不参与运算，稳态 Voice 每样本只需旋转
+    const int first = group * NUM_LANES;
+    bool anyTransient = false;
+    for (int v = first; v < first + NUM_LANES; ++v)
+    {
+        if (stage[v] == idle)
+            return false;
+        anyTransient = anyTransient || !isVoiceSteady(v);
+    }
+    return anyTransient;
+}
+
+void OscillatorBank::renderVoices(juce::AudioBuffer<float>& buffer, int startSample, int numSamples)
+{
+    const int numGroups = (polyphony + NUM_LANES - 1) / NUM_LANES;
+    renderedNoteCounter = noteCounter;
+
+    while (numSamples > 0)
+    {
+        const int chunk = juce::jmin(numSamples, CHUNK_SIZE);
+        bool anyOutput = false;
+        bool anyLaneMix = false;
+
+        for (int group = 0; group < numGroups; ++group)
+        {
+            if (isGroupSilent(group))
+                continue;
+
+            if (!anyOutput)
+            {
+                // 按时间展开的 Voice 每步写入 VOICE_STEP 个样本，清零到其整数倍
+                juce::FloatVectorOperations::clear(mixBuffer, (chunk + VOICE_STEP - 1) / VOICE_STEP * VOICE_STEP);
+                anyOutput = true;
+            }
+
+            if (shouldRenderGroupInLanes(group))
+            {
+                if (!anyLaneMix)
+                {
+                    juce::FloatVectorOperations::clear(laneMix, chunk * NUM_LANES);
+                    anyLaneMix = true;
+                }
+                renderGroup(group, chunk);
+            }
+            else
+            {
+                for (int v = group * NUM_LANES; v < (group + 1) * NUM_LANES; ++v)
+                    if (stage[v] != idle)
+                        renderVoice(v, chunk);
+            }
+        }
+
+        if (anyLaneMix)
+            for (int i = 0; i < chunk; ++i)
+                mixBuffer[i] += Lanes::fromRawArray(laneMix + i * NUM_LANES).sum();
+
+        if (anyOutput)
+        {
+            for (int v = 0; v < numGroups * NUM_LANES; ++v)
+                if (tailGain[v] > 0.0f)
+                    renderFastRelease(v, mixBuffer, chunk);
+
+            // 单声道混音写入所有声道
+            for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+                buffer.addFrom(ch, startSample, mixBuffer, chunk);
+        }
+
+        startSample += chunk;
+        numSamples -= chunk;
+    }
+}
+
+void OscillatorBank::renderGroup(int group, int numSamples)
+{
+    const int first = group * NUM_LANES;
+
+    // 由定点相位求片段起点的 (cos, sin)，并把相位直接推进到片段末尾（整数回绕，无累积误差）
+    alignas(Lanes::SIMDRegisterSize) float startSin[NUM_LANES];
+    alignas(Lanes::SIMDRegisterSize) float startCos[NUM_LANES];
+    bool anyActive = false;
+
+    for (int k = 0; k < NUM_LANES; ++k)
+    {
+        const int v = first + k;
+        if (stage[v] == idle)
+        {
+            startSin[k] = startCos[k] = 0.0f;
+            continue;
+        }
+        const double radians = phase[v] * kPhaseToRadians;
+        startSin[k] = (float) std::sin(radians);
+        startCos[k] = (float) std::cos(radians);
+        phase[v] += phaseIncrement[v] * (uint32_t) numSamples;
+        anyActive = true;
+    }
+
+    if (!anyActive)
+        return;
+
+    // 振荡器、包络与电平在寄存器中逐样本推进，NUM_LANES 个 Voice 并行
+    const auto gain = Lanes::fromRawArray(level + first) * volume;
+    const auto coef = Lanes::fromRawArray(releaseCoef + first);
+    const auto rotCos = Lanes::fromRawArray(rotationCos + first);
+    const auto rotSin = Lanes::fromRawArray(rotationSin + first);
+    const auto attackStep = Lanes::expand(attackStepPerSample);
+    const auto one = Lanes::expand(1.0f);
+    const auto threshold = Lanes::expand(kReleaseThreshold);
+    auto attackEnv = Lanes::fromRawArray(attack + first);
+    auto releaseEnv = Lanes::fromRawArray(release + first);
+    auto sinState = Lanes::fromRawArray(startSin);
+    auto cosState = Lanes::fromRawArray(startCos);
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        releaseEnv = releaseEnv * coef;
+        const auto envelope = Lanes::min(attackEnv, one) * releaseEnv;
+        const auto out = (sinState * gain * envelope) & Lanes::greaterThanOrEqual(releaseEnv, threshold);
+
+        float* lanes = laneMix + i * NUM_LANES;
+        (Lanes::fromRawArray(lanes) + out).copyToRawArray(lanes);
+
+        // 正交旋转：(cos, sin) 每样本转过一个相位增量
+        const auto nextSin = sinState * rotCos + cosState * rotSin;
+        cosState = cosState * rotCos - sinState * rotSin;
+        sinState = nextSin;
+        attackEnv = Lanes::min(attackEnv + attackStep, one);
+    }
+
+    attackEnv.copyToRawArray(attack + first);
+    releaseEnv.copyToRawArray(release + first);
+
+    for (int v = first; v < first + NUM_LANES; ++v)
+        finishVoiceIfSilent(v);
+}
+
+void OscillatorBank::renderVoice(int v, int numSamples)
+{
+    // 单个 Voice 按时间展开：两个寄存器分别从片段的第 0 与第 NUM_LANES 个样本开始（通道 k 再偏移 k），
+    // 每步推进 VOICE_STEP 个样本；两条旋转递推相互独立，乘加延迟得以重叠。
+    // 结果按时间顺序连续，直接累加到 mixBuffer（末尾多算的样本落在已清零的填充区）
+    alignas(Lanes::SIMDRegisterSize) float startSin[VOICE_STEP];
+    alignas(Lanes::SIMDRegisterSize) float startCos[VOICE_STEP];
+
+    // 片段起点由定点相位求出，其余通道逐样本旋转得到（只需一次 sin / cos）；
+    // 电平并入振荡器幅度，旋转不改变幅度
+    const double radians = phase[v] * kPhaseToRadians;
+    const float gain = level[v] * volume;
+    startSin[0] = (float) std::sin(radians) * gain;
+    startCos[0] = (float) std::cos(radians) * gain;
+
+    for (int k = 1; k < VOICE_STEP; ++k)
+    {
+        startSin[k] = startSin[k - 1] * rotationCos[v] + startCos[k - 1] * rotationSin[v];
+        startCos[k] = startCos[k - 1] * rotationCos[v] - startSin[k - 1] * rotationSin[v];
+    }
+
+    const auto rotCos = Lanes::expand(stepCos[v]);
+    const auto rotSin = Lanes::expand(stepSin[v]);
+    auto sinFirst = Lanes::fromRawArray(startSin), sinSecond = Lanes::fromRawArray(startSin + NUM_LANES);
+    auto cosFirst = Lanes::fromRawArray(startCos), cosSecond = Lanes::fromRawArray(startCos + NUM_LANES);
+
+    const auto rotate = [&rotCos, &rotSin](Lanes& sinState, Lanes& cosState)
+    {
+        const auto nextSin = sinState * rotCos + cosState * rotSin;
+        cosState = cosState * rotCos - sinState * rotSin;
+        sinState = nextSin;
+    };
+
+    if (isVoiceSteady(v))
+    {
+        // 起音结束且仍按住：包络恒为 1，每样本只剩旋转与累加
+        for (int i = 0; i < numSamples; i += VOICE_STEP)
+        {
+            float* samples = mixBuffer + i;
+            (Lanes::fromRawArray(samples) + sinFirst).copyToRawArray(samples);
+            (Lanes::fromRawArray(samples + NUM_LANES) + sinSecond).copyToRawArray(samples + NUM_LANES);
+            rotate(sinFirst, cosFirst);
+            rotate(sinSecond, cosSecond);
+        }
+    }
+    else
+    {
+        alignas(Lanes::SIMDRegisterSize) float startAttack[VOICE_STEP];
+        alignas(Lanes::SIMDRegisterSize) float startRelease[VOICE_STEP];
+        float releaseStep = 1.0f;   // releaseCoef 的 VOICE_STEP 次方
+
+        for (int k = 0; k < VOICE_STEP; ++k)
+        {
+            startAttack[k] = attack[v] + attackStepPerSample * (float) k;
+            releaseStep *= releaseCoef[v];
+            startRelease[k] = release[v] * releaseStep;
+        }
+
+        const auto coef = Lanes::expand(releaseStep);
+        const auto attackStep = Lanes::expand(attackStepPerSample * (float) VOICE_STEP);
+        const auto one = Lanes::expand(1.0f);
+        const auto threshold = Lanes::expand(kReleaseThreshold);
+
+        // 一步：输出 NUM_LANES 个连续样本并把通道状态推进 VOICE_STEP 个样本
+        const auto step = [&](Lanes& sinState, Lanes& cosState, Lanes& attackEnv, Lanes& releaseEnv, float* samples)
+        {
+            const auto envelope = Lanes::min(attackEnv, one) * releaseEnv;
+            const auto out = (sinState * envelope) & Lanes::greaterThanOrEqual(releaseEnv, threshold);
+            (Lanes::fromRawArray(samples) + out).copyToRawArray(samples);
+
+            rotate(sinState, cosState);
+            attackEnv = Lanes::min(attackEnv + attackStep, one);
+            releaseEnv = releaseEnv * coef;
+        };
+
+        auto attackFirst = Lanes::fromRawArray(startAttack), attackSecond = Lanes::fromRawArray(startAttack + NUM_LANES);
+        auto releaseFirst = Lanes::fromRawArray(startRelease), releaseSecond = Lanes::fromRawArray(startRelease + NUM_LANES);
+
+        for (int i = 0; i < numSamples; i += VOICE_STEP)
+        {
+            step(sinFirst, cosFirst, attackFirst, releaseFirst, mixBuffer + i);
+            step(sinSecond, cosSecond, attackSecond, releaseSecond, mixBuffer + i + NUM_LANES);
+        }
+    }
+
+    // 状态直接推进到片段末尾（与逐样本递推的结果只差舍入）
+    phase[v] += phaseIncrement[v] * (uint32_t) numSamples;
+    attack[v] = juce::jmin(attack[v] + attackStepPerSample * (float) numSamples, 1.0f);
+    release[v] *= std::pow(releaseCoef[v], (float) numSamples);
+    finishVoiceIfSilent(v);
+}
+
+void OscillatorBank::finishVoiceIfSilent(int v)
+{
+    // 释音结束的 Voice 空出
+    if (stage[v] == released && release[v] < kReleaseThreshold)
+    {
+        stage[v] = idle;
+        level[v] = 0.0f;
+        release[v] = 1.0f;
+        releaseCoef[v] = 1.0f;
+    }
+}
+
+void OscillatorBank::renderFastRelease(int v, float* mix, int numSamples)
+{
+    for (int i = 0; i < numSamples && tailGain[v] > 0.0f; ++i)
+    {
+        mix[i] += (float) std::sin(tailPhase[v] * kPhaseToRadians) * tailGain[v];
+        tailPhase[v] += tailPhaseIncrement[v];
+        tailGain[v] -= tailStep[v];
+    }
+    tailGain[v] = juce::jmax(0.0f, tailGain[v]);
+}
@@ -0,0 +1,133 @@
+#pragma once
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_dsp/juce_dsp.h>
+#include "EarxSynthesiser.h"
+#include "LoudnessTable.h"
+
+/**
+ * 振荡器 Voice 组 - 正弦音色的专用轻量 Voice 引擎，替代 juce::Synthesiser 的逐 Voice 虚函数分发
+ * 职责：
+ * - 固定容量的结构数组（SoA）保存所有 Voice 的状态：相位、相位增量、电平、包络阶段与包络值
+ * - 渲染时以 SIMD 通道为单位一次处理多个 Voice，混成单声道后写入所有声道
+ * - 振荡器：相位以 32 位定点数累加（自然回绕，长时间会话不损失精度），每个渲染片段开始时
+ *   由定点相位求出 (cos, sin)，片段内以正交旋转递推（每样本 4 次乘法）
+ * - 满组且有 Voice 处于起音 / 释音时整组 Voice 在寄存器中并行；其余情况逐个 Voice 按时间展开
+ *   （通道 k 计算第 i + k 个样本）：空通道不参与运算，输出按时间连续、无需横向求和，
+ *   稳态 Voice 每样本只需旋转，常见的 1 - 4 个音符只付出与发声 Voice 数成正比的开销
+ * - 提供与 AudioController 一致的控制：noteOn / noteOff / allNotesOff、复音数、音量，
+ *   MIDI 事件按样本偏移切分渲染（样本精度，不受 juce::Synthesiser 最小子块限制）
+ * - 抢占策略与 EarxSynthesiser 一致：已松开且最安静的优先（按目标电平比较，不计起音包络），
+ *   上次渲染之后才开始的音符最后才抢，被抢占的音符做快速释放
+ *
+ * 只承担正弦音色。钢琴等样本回放音色仍由 EarxSynthesiser 的 Voice 渲染：每个 Voice 读取各自的样本缓冲
+ * （按键选区、插值读取），读取位置与长度各不相同，无法在 SIMD 通道间并行，
+ * 且渲染开销以样本读取为主，逐 Voice 虚函数分发只占很小一部分。
+ *
+ * 所有方法需与渲染串行调用（AudioController 以 synthMutex 保护）。
+ */
+class OscillatorBank
+{
+public:
+    using Lanes = juce::dsp::SIMDRegister<float>;
+
+    static constexpr int MAX_VOICES = EarxSynthesiser::MAX_POLYPHONY;
+    static constexpr int NUM_LANES = (int) Lanes::SIMDNumElements;
+    static constexpr int NUM_GROUPS = MAX_VOICES / NUM_LANES;
+    static constexpr int CHUNK_SIZE = 256;     // 内部渲染块（也是旋转递推的最长距离），混音缓冲区预分配
+    static constexpr int VOICE_STEP = 2 * NUM_LANES;  // 单个 Voice 按时间展开时每步的样本数（两个寄存器）
+
+    static_assert(MAX_VOICES % NUM_LANES == 0, "voice capacity must fill whole SIMD registers");
+    static_assert(CHUNK_SIZE % VOICE_STEP == 0, "time-unrolled voices write whole steps into the mix buffer");
+
+    OscillatorBank();
+
+    void prepare(double sampleRate);
+
+    // 可用的 Voice 数（1 - MAX_VOICES），缩小时超出部分的音符直接结束
+    void setPolyphony(int numVoices);
+    int getPolyphony() const { return polyphony; }
+
+    // 所有 Voice 共用的输出增益，在下一个渲染块开始时生效
+    void setVolume(float newVolume) { volume = newVolume; }
+
+    // 按键响度补偿表（起音时取用，为空时不补偿）
+    void setLoudnessTable(const LoudnessTable* table) { loudnessTable = table; }
+
+    void noteOn(int midiNote, float velocity);
+    void noteOff(int midiNote);
+    void allNotesOff(bool allowTailOff);
+
+    // 立即清空所有 Voice 与快速释放尾音（音色切换时调用，此时输出已淡出到静音）
+    void reset();
+
+    // 把 Voice 组的输出叠加到 buffer 上，midi 中的事件按样本偏移生效
+    void renderNextBlock(juce::AudioBuffer<float>& buffer, const juce::MidiBuffer& midi, int startSample, int numSamples);
+
+    int getNumActiveVoices() const;
+    bool isNoteActive(int midiNote) const;    // 是否有 Voice 正在演奏该音高（含释音中）
+    juce::int64 getNumVoicesStolen() const { return voicesStolen; }
+
+private:
+    enum Stage : uint8_t
+    {
+        idle = 0,
+        held = 1,       // 按住（含起音）
+        released = 2    // 松开后指数衰减
+    };
+
+    void handleMidiEvent(const juce::MidiMessage& message);
+    void renderVoices(juce::AudioBuffer<float>& buffer, int startSample, int numSamples);
+    void renderGroup(int group, int numSamples);
+    void renderVoice(int voice, int numSamples);
+    void renderFastRelease(int voice, float* mix, int numSamples);
+
+    int findFreeVoice() const;
+    int findVoiceToSteal(int midiNote) const;
+    float getVoiceLevel(int voice) const;
+    float getTargetLevel(int voice) const;
+    void startVoice(int voice, int midiNote, float velocity);
+    void releaseVoice(int voice);
+    void stopVoiceImmediately(int voice);
+    bool isGroupSilent(int group) const;
+    bool isVoiceSteady(int voice) const;   // 起音结束且仍按住：包络恒为 1
+    bool shouldRenderGroupInLanes(int group) const;
+    void finishVoiceIfSilent(int voice);
+
+    double sampleRate = 44100.0;
+    int polyphony = MAX_VOICES;
+    float volume = 0.2f;
+    const LoudnessTable* loudnessTable = nullptr;
+    float attackStepPerSample = 0.0f;
+    int fastReleaseSamples = 1;
+    juce::int64 noteCounter = 0;
+    juce::int64 renderedNoteCounter = 0;   // 上次渲染时的 noteCounter，之后开始的音符尚未发声
+    juce::int64 voicesStolen = 0;
+
+    // Voice 状态（SoA）：参与运算的字段按 SIMD 对齐，逐组加载到寄存器
+    uint32_t phase[MAX_VOICES] = {};                                        // 定点相位，2^32 为一周
+    uint32_t phaseIncrement[MAX_VOICES] = {};
+    alignas(Lanes::SIMDRegisterSize) float rotationCos[MAX_VOICES] = {};  // 每样本旋转角的 cos / sin
+    alignas(Lanes::SIMDRegisterSize) float rotationSin[MAX_VOICES] = {};
+    float stepCos[MAX_VOICES] = {};                                        // VOICE_STEP 个样本旋转角的 cos / sin（按时间展开用）
+    float stepSin[MAX_VOICES] = {};
+    alignas(Lanes::SIMDRegisterSize) float level[MAX_VOICES] = {};        // 力度
+    alignas(Lanes::SIMDRegisterSize) float attack[MAX_VOICES] = {};       // 起音包络值（线性上升，截至 1）
+    alignas(Lanes::SIMDRegisterSize) float release[MAX_VOICES] = {};      // 释音包络值（按住时为 1）
+    alignas(Lanes::SIMDRegisterSize) float releaseCoef[MAX_VOICES] = {};  // 释音每样本衰减系数（按住时为 1）
+    Stage stage[MAX_VOICES] = {};
+    int midiNote[MAX_VOICES] = {};
+    juce::int64 noteOnOrder[MAX_VOICES] = {};
+
+    // 快速释放尾音：被抢占 / 硬停止的音符保留相位与电平线性淡出
+    uint32_t tailPhase[MAX_VOICES] = {};
+    uint32_t tailPhaseIncrement[MAX_VOICES] = {};
+    float tailGain[MAX_VOICES] = {};
+    float tailStep[MAX_VOICES] = {};
+
+    // 满组按通道累加，片段结束时再横向求和，避免每样本每组一次横向加法；
+    // 按时间展开的 Voice 与快速释放尾音直接累加到 mixBuffer
+    alignas(Lanes::SIMDRegisterSize) float laneMix[CHUNK_SIZE * NUM_LANES] = {};
+    alignas(Lanes::SIMDRegisterSize) float mixBuffer[CHUNK_SIZE] = {};
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(OscillatorBank)
+};
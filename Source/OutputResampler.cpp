@@ -0,0 +1,174 @@
+#include "OutputResampler.h"
+#include <numeric>
+
+namespace
+{
+    // 第一类零阶修正贝塞尔函数（Kaiser 窗），级数展开到收敛
+    double besselI0(double x)
+    {
+        double sum = 1.0, term = 1.0;
+        for (int k = 1; k < 64 && term > sum * 1.0e-12; ++k)
+        {
+            const double t = x / (2.0 * k);
+            term *= t * t;
+            sum += term;
+        }
+        return sum;
+    }
+}
+
+void OutputResampler::prepare(double inputSampleRate, double outputSampleRate)
+{
+    inputRate = inputSampleRate;
+    outputRate = outputSampleRate;
+
+    const int in = juce::roundToInt(inputSampleRate);
+    const int out = juce::roundToInt(outputSampleRate);
+    bypassed = in == out || in <= 0 || out <= 0;
+    if (bypassed)
+    {
+        line.setSize(0, 0);
+        coefficients.clear();
+        latencySamples.store(0, std::memory_order_relaxed);
+        return;
+    }
+
+    const int divisor = std::gcd(in, out);
+    step = in / divisor;
+    den = out / divisor;
+    phase = 0;
+
+    // 截止频率（相对输入端奈奎斯特频率）；降采样时滤波器按比例加长，过零点数保持不变
+    const double cutoff = PASSBAND * juce::jmin(1.0, outputSampleRate / inputSampleRate);
+    halfTaps = (int) std::ceil(ZERO_CROSSINGS / cutoff);
+    numTaps = halfTaps * 2;
+
+    // 第 p 相的输出位于第 halfTaps - 1 个抽头之后 p / PHASES 个样本处；每相归一化到直流增益 1
+    coefficients.assign((size_t) ((PHASES + 1) * numTaps), 0.0f);
+    interpolated.assign((size_t) numTaps, 0.0f);
+    const double windowNorm = besselI0(KAISER_BETA);
+    for (int p = 0; p <= PHASES; ++p)
+    {
+        const double fraction = (double) p / PHASES;
+        float* row = coefficients.data() + (size_t) (p * numTaps);
+        double sum = 0.0;
+        for (int k = 0; k < numTaps; ++k)
+        {
+            const double t = (double) (k - (halfTaps - 1)) - fraction;
+            const double x = juce::jlimit(-1.0, 1.0, t / halfTaps);
+            const double arg = juce::MathConstants<double>::pi * cutoff * t;
+            const double sinc = t == 0.0 ? 1.0 : std::sin(arg) / arg;
+            const double value = sinc * besselI0(KAISER_BETA * std::sqrt(1.0 - x * x)) / windowNorm;
+            row[k] = (float) value;
+            sum += value;
+        }
+        for (int k = 0; k < numTaps; ++k)
+            row[k] = (float) (row[k] / sum);
+    }
+
+    maxInputSamples = (int) ((juce::int64) MAX_OUTPUT_BLOCK * step / den) + numTaps + 2;
+    line.setSize(MAX_CHANNELS, maxInputSamples + numTaps + 2);
+    line.clear();
+
+    // 预置 halfTaps - 1 个零：第一个输出正好对齐第一个输入样本
+    base = 0;
+    available = halfTaps - 1;
+    silentTail = available;
+    latencySamples.store(halfTaps, std::memory_order_relaxed);
+
+    DBG("Output resampler: " + juce::String(in) + " Hz -> " + juce::String(out) + " Hz, "
+        + juce::String(numTaps) + " taps, ratio " + juce::String(step) + "/" + juce::String(den));
+}
+
+int OutputResampler::getInputSamplesNeeded(int numOutputSamples) const
+{
+    if (bypassed || numOutputSamples <= 0)
+        return juce::jmax(0, numOutputSamples);
+
+    // 最后一个输出的第一个抽头位置 + numTaps 个抽头都必须已在延迟线中
+    const int lastBase = base + (int) ((phase + (juce::int64) (numOutputSamples - 1) * step) / den);
+    return juce::jmax(0, lastBase + numTaps - available);
+}
+
+void OutputResampler::process(const juce::AudioBuffer<float>& input, int numInputSamples,
+                              juce::AudioBuffer<float>& output, int startSample, int numOutputSamples)
+{
+    const int numChannels = juce::jmin((int) MAX_CHANNELS, output.getNumChannels());
+    const int inputChannels = input.getNumChannels();
+    if (bypassed || inputChannels == 0)
+    {
+        for (int ch = 0; ch < numChannels; ++ch)
+            output.copyFrom(ch, startSample, input, juce::jmin(ch, inputChannels - 1), 0, juce::jmin(numInputSamples, numOutputSamples));
+        return;
+    }
+
+    jassert(numInputSamples == getInputSamplesNeeded(numOutputSamples) && numOutputSamples <= MAX_OUTPUT_BLOCK);
+
+    // 追加新输入，并统计末尾连续为零的样本数
+    int zeros = 0;
+    for (int ch = 0; ch < MAX_CHANNELS; ++ch)
+        line.copyFrom(ch, available, input, juce::jmin(ch, inputChannels - 1), 0, numInputSamples);
+    while (zeros < numInputSamples
+           && line.getSample(0, available + numInputSamples - 1 - zeros) == 0.0f
+           && line.getSample(1, available + numInputSamples - 1 - zeros) == 0.0f)
+        ++zeros;
+    silentTail = zeros == numInputSamples ? silentTail + numInputSamples : zeros;
+    available += numInputSamples;
+
+    if (silentTail >= available - base)
+    {
+        // 所有会用到的输入都是零：输出静音，只推进相位
+        for (int ch = 0; ch < numChannels; ++ch)
+            output.clear(ch, startSample, numOutputSamples);
+        const juce::int64 total = phase + (juce::int64) numOutputSamples * step;
+        base += (int) (total / den);
+        phase = total % den;
+    }
+    else
+    {
+        const float* lines[MAX_CHANNELS] = { line.getReadPointer(0), line.getReadPointer(1) };
+        float* outputs[MAX_CHANNELS] = {};
+        for (int ch = 0; ch < numChannels; ++ch)
+            outputs[ch] = output.getWritePointer(ch, startSample);
+
+        for (int i = 0; i < numOutputSamples; ++i)
+        {
+            // 相邻两相的系数按分数相位线性插值，左右声道共用
+            const double position = (double) phase * PHASES / (double) den;
+            const int p = (int) position;
+            const float w = (float) (position - p);
+            const float* c0 = coefficients.data() + (size_t) (p * numTaps);
+            const float* c1 = c0 + numTaps;
+            for (int k = 0; k < numTaps; ++k)
+                interpolated[(size_t) k] = c0[k] + w * (c1[k] - c0[k]);
+
+            for (int ch = 0; ch < numChannels; ++ch)
+            {
+                const float* x = lines[ch] + base;
+                float sum = 0.0f;
+                for (int k = 0; k < numTaps; ++k)
+                    sum += interpolated[(size_t) k] * x[k];
+                outputs[ch][i] = sum;
+            }
+
+            phase += step;
+            base += (int) (phase / den);
+            phase %= den;
+        }
+    }
+
+    for (int ch = numChannels; ch < output.getNumChannels(); ++ch)
+        output.clear(ch, startSample, numOutputSamples);
+
+    // 丢弃已不再需要的输入，剩余部分移到延迟线开头
+    jassert(base <= available);
+    const int keep = available - base;
+    for (int ch = 0; ch < MAX_CHANNELS; ++ch)
+    {
+        float* data = line.getWritePointer(ch);
+        std::memmove(data, data + base, (size_t) keep * sizeof(float));
+    }
+    available = keep;
+    base = 0;
+    silentTail = juce::jmin(silentTail, keep);
+}
@@ -0,0 +1,68 @@
+#pragma once
+#include <juce_audio_basics/juce_audio_basics.h>
+
+/**
+ * 输出采样率转换 - 主总线最后一级，把引擎内部的固定采样率转换为设备采样率
+ * 职责：
+ * - 多相 FIR 插值：Kaiser 窗 sinc 按 PHASES 个分数相位制表，相位之间线性插值；
+ *   截止频率取两侧中较低的奈奎斯特频率的 PASSBAND 倍，降采样时按比例加长滤波器，抑制混叠
+ * - 采样率按整数比（约分后）推进相位，长时间运行没有累计漂移
+ * - 流式处理：调用方先用 getInputSamplesNeeded 查询本块需要的新输入样本数，渲染后交给 process
+ * - 历史与新输入全为零时直接输出静音（空闲时不做卷积）
+ * - 两侧采样率相同时旁路（isBypassed），不引入延迟
+ *
+ * 缓冲区在 prepare 中按 MAX_OUTPUT_BLOCK 分配，process 中不分配内存。
+ * prepare 与 process 需串行调用（设备重新启动时重新配置）；延迟查询可在任意线程调用。
+ */
+class OutputResampler
+{
+public:
+    static constexpr int MAX_CHANNELS = 2;
+    static constexpr int MAX_OUTPUT_BLOCK = 1024;       // 单次 process 的最大输出样本数
+    static constexpr int ZERO_CROSSINGS = 16;           // 滤波器每侧的过零点数（按截止频率计）
+    static constexpr int PHASES = 256;                  // 系数表的分数相位数
+    static constexpr double PASSBAND = 0.92;            // 截止频率 / 较低一侧的奈奎斯特频率
+    static constexpr double KAISER_BETA = 9.0;          // 约 90 dB 阻带衰减
+
+    // 按输入（引擎内部）与输出（设备）采样率设计滤波器并分配缓冲区（不在音频线程调用）
+    void prepare(double inputSampleRate, double outputSampleRate);
+
+    bool isBypassed() const { return bypassed; }
+    double getInputSampleRate() const { return inputRate; }
+    double getOutputSampleRate() const { return outputRate; }
+
+    // 产生 numOutputSamples 个输出样本所需的新输入样本数（不超过 getMaxInputSamples）
+    int getInputSamplesNeeded(int numOutputSamples) const;
+    int getMaxInputSamples() const { return maxInputSamples; }
+
+    // 群延迟（输入样本）：输出端第 m 个样本对应输入端 m × 输入/输出采样率 处，比已渲染的输入晚这么多
+    int getLatencyInputSamples() const { return latencySamples.load(std::memory_order_relaxed); }
+
+    // 输入 numInputSamples（== getInputSamplesNeeded(numOutputSamples)）个新样本，
+    // 转换结果写入 output 的 [startSample, startSample + numOutputSamples)，声道数取两者较小值
+    void process(const juce::AudioBuffer<float>& input, int numInputSamples,
+                 juce::AudioBuffer<float>& output, int startSample, int numOutputSamples);
+
+private:
+    bool bypassed = true;
+    double inputRate = 0.0, outputRate = 0.0;
+
+    // 系数表：(PHASES + 1) 行 × numTaps，第 p 行为分数相位 p / PHASES；最后一行供插值使用
+    std::vector<float> coefficients;
+    std::vector<float> interpolated;
+    int numTaps = 0;
+    int halfTaps = 0;
+
+    // 每个输出样本输入位置前进 step / den（约分后的整数比），相位分子 phase 在 [0, den)
+    juce::int64 step = 1, den = 1;
+    juce::int64 phase = 0;
+
+    // 输入延迟线：[base, available) 为尚未丢弃的样本，base 为下一个输出的第一个抽头
+    juce::AudioBuffer<float> line;
+    int base = 0;
+    int available = 0;
+    int silentTail = 0;     // 延迟线末尾连续为零的样本数
+    int maxInputSamples = 0;
+
+    std::atomic<int> latencySamples { 0 };
+};
@@ -0,0 +1,121 @@
+#include "PartialOscillator.h"
+
+namespace
+{
+    constexpr double kPhaseToRadians = juce::MathConstants<double>::twoPi / 4294967296.0;
+}
+
+void PartialOscillator::start(const Profile& profile, double fundamentalHz, double sampleRate)
+{
+    numPartials = 0;
+    const double nyquist = 0.5 * sampleRate;
+
+    for (int h = 1; h <= juce::jmin(profile.numPartials, MAX_PARTIALS); ++h)
+    {
+        // 超过奈奎斯特频率（会混叠）或听不到的谐波直接跳过
+        const float amp = profile.amplitude[h - 1];
+        if (h * fundamentalHz >= nyquist || std::abs(amp) < CULL_THRESHOLD)
+            continue;
+
+        const int p = numPartials++;
+        const double cycles = h * fundamentalHz / sampleRate;
+        phase[p] = 0;
+        phaseIncrement[p] = (uint32_t) std::llround(cycles * 4294967296.0);
+        const double radiansPerSample = phaseIncrement[p] * kPhaseToRadians;
+        rotationCos[p] = (float) std::cos(radiansPerSample);
+        rotationSin[p] = (float) std::sin(radiansPerSample);
+        amplitude[p] = amp;
+
+        const float decaySeconds = profile.decaySeconds[h - 1];
+        decay[p] = decaySeconds > 0.0f ? (float) std::pow(0.001, 1.0 / (decaySeconds * sampleRate)) : 1.0f;
+    }
+
+    for (int p = numPartials; p < MAX_PARTIALS; ++p)
+        amplitude[p] = 0.0f;
+}
+
+float PartialOscillator::getAmplitudeSum() const
+{
+    float sum = 0.0f;
+    for (int p = 0; p < numPartials; ++p)
+        sum += std::abs(amplitude[p]);
+    return sum;
+}
+
+void PartialOscillator::render(float* dest, int numSamples)
+{
+    jassert(numSamples <= CHUNK_SIZE);
+
+    if (numPartials == 0)
+    {
+        juce::FloatVectorOperations::clear(dest, numSamples);
+        return;
+    }
+
+    juce::FloatVectorOperations::clear(laneMix, numSamples * NUM_LANES);
+    const int numGroups = (numPartials + NUM_LANES - 1) / NUM_LANES;
+
+    for (int group = 0; group < numGroups; ++group)
+    {
+        const int first = group * NUM_LANES;
+
+        // 由定点相位求片段起点的 (cos, sin)，相位直接推进到片段末尾
+        alignas(Lanes::SIMDRegisterSize) float startSin[NUM_LANES];
+        alignas(Lanes::SIMDRegisterSize) float startCos[NUM_LANES];
+        for (int k = 0; k < NUM_LANES; ++k)
+        {
+            const int p = first + k;
+            const double radians = phase[p] * kPhaseToRadians;
+            startSin[k] = (float) std::sin(radians);
+            startCos[k] = (float) std::cos(radians);
+            phase[p] += phaseIncrement[p] * (uint32_t) numSamples;
+        }
+
+        const auto rotCos = Lanes::fromRawArray(rotationCos + first);
+        const auto rotSin = Lanes::fromRawArray(rotationSin + first);
+        const auto coef = Lanes::fromRawArray(decay + first);
+        auto amp = Lanes::fromRawArray(amplitude + first);
+        auto sinState = Lanes::fromRawArray(startSin);
+        auto cosState = Lanes::fromRawArray(startCos);
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            float* lanes = laneMix + i * NUM_LANES;
+            (Lanes::fromRawArray(lanes) + sinState * amp).copyToRawArray(lanes);
+
+            const auto nextSin = sinState * rotCos + cosState * rotSin;
+            cosState = cosState * rotCos - sinState * rotSin;
+            sinState = nextSin;
+            amp = amp * coef;
+        }
+
+        amp.copyToRawArray(amplitude + first);
+    }
+
+    for (int i = 0; i < numSamples; ++i)
+        dest[i] = Lanes::fromRawArray(laneMix + i * NUM_LANES).sum();
+
+    cullInaudiblePartials();
+}
+
+void PartialOscillator::cullInaudiblePartials()
+{
+    // 衰减到阈值以下的分音与末尾的交换后移出，保持数组紧凑（求和与顺序无关）
+    for (int p = 0; p < numPartials;)
+    {
+        if (std::abs(amplitude[p]) >= CULL_THRESHOLD)
+        {
+            ++p;
+            continue;
+        }
+
+        const int last = --numPartials;
+        phase[p] = phase[last];
+        phaseIncrement[p] = phaseIncrement[last];
+        rotationCos[p] = rotationCos[last];
+        rotationSin[p] = rotationSin[last];
+        amplitude[p] = amplitude[last];
+        decay[p] = decay[last];
+        amplitude[last] = 0.0f;
+    }
+}
@@ -0,0 +1,64 @@
+#pragma once
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_dsp/juce_dsp.h>
+
+/**
+ * 谐波分音振荡器 - 一个音符的加法合成内核
+ * 职责：
+ * - 按分音表（各次谐波的振幅与衰减时间）生成单声道信号，分音状态以结构数组（SoA）保存
+ * - 以 SIMD 通道为单位一次处理多个分音：定点相位 + 片段内正交旋转（与 OscillatorBank 相同），
+ *   振幅按各自的衰减系数逐样本指数下降
+ * - 听不到的分音不参与计算：起音时剔除超过奈奎斯特频率或振幅过小的谐波，
+ *   渲染中衰减到阈值以下的分音随即移出数组
+ *
+ * 不处理力度与包络（由调用方的 Voice 叠加），可按值复制（快速释放时保留旧音符状态）。
+ */
+class PartialOscillator
+{
+public:
+    using Lanes = juce::dsp::SIMDRegister<float>;
+
+    static constexpr int MAX_PARTIALS = 32;
+    static constexpr int NUM_LANES = (int) Lanes::SIMDNumElements;
+    static constexpr int CHUNK_SIZE = 128;      // 单次 render 的最大样本数（也是旋转递推的最长距离）
+
+    static_assert(MAX_PARTIALS % NUM_LANES == 0, "partial capacity must fill whole SIMD registers");
+
+    // 分音表：amplitude[i] / decaySeconds[i] 对应第 i + 1 次谐波，decaySeconds <= 0 表示不衰减
+    struct Profile
+    {
+        int numPartials = 0;
+        float amplitude[MAX_PARTIALS] = {};
+        float decaySeconds[MAX_PARTIALS] = {};  // 衰减 60 dB 所需时间
+    };
+
+    // 振幅低于此值（约 -80 dB）的分音视为听不到
+    static constexpr float CULL_THRESHOLD = 1.0e-4f;
+
+    void start(const Profile& profile, double fundamentalHz, double sampleRate);
+    void stop() { numPartials = 0; }
+
+    bool isActive() const { return numPartials > 0; }
+    int getNumPartials() const { return numPartials; }
+
+    // 当前各分音振幅之和（输出峰值的上界）
+    float getAmplitudeSum() const;
+
+    // 生成 numSamples（<= CHUNK_SIZE）个样本写入 dest（覆盖）；分音全部衰减完后输出静音
+    void render(float* dest, int numSamples);
+
+private:
+    void cullInaudiblePartials();
+
+    int numPartials = 0;
+
+    uint32_t phase[MAX_PARTIALS] = {};                                      // 定点相位，2^32 为一周
+    uint32_t phaseIncrement[MAX_PARTIALS] = {};
+    alignas(Lanes::SIMDRegisterSize) float rotationCos[MAX_PARTIALS] = {};
+    alignas(Lanes::SIMDRegisterSize) float rotationSin[MAX_PARTIALS] = {};
+    alignas(Lanes::SIMDRegisterSize) float amplitude[MAX_PARTIALS] = {};   // 未使用的通道为 0
+    alignas(Lanes::SIMDRegisterSize) float decay[MAX_PARTIALS] = {};       // 每样本衰减系数
+
+    // 各组按通道累加，片段结束时再横向求和
+    alignas(Lanes::SIMDRegisterSize) float laneMix[CHUNK_SIZE * NUM_LANES] = {};
+};
@@ -1,9 +1,12 @@
 #include "PianoSound.h"
+#include "InstrumentPack.h"
+#include <algorithm>
 #include <unordered_map>
 
 // 全局样本缓存：按绝对路径缓存已解码的音频数据，避免重复解码导致切换时卡顿/爆音
 static std::unordered_map<std::string, std::shared_ptr<juce::AudioBuffer<float>>> gSampleCache;
 static std::unordered_map<std::string, double> gSampleRateCache;
+static juce::CriticalSection gSampleCacheLock;
 
 PianoSound::PianoSound()
 {
@@ -15,16 +18,24 @@ PianoSound::PianoSound()
 
 PianoSound::~PianoSound()
 {
+    stopLoading();
+}
+
+void PianoSound::stopLoading()
+{
+    // 加载线程在每个 region 之间检查退出标志，必须等它真正结束：超时返回会让它继续写已释放的成员
     if (loadingThread && loadingThread->isThreadRunning())
     {
         loadingThread->signalThreadShouldExit();
-        loadingThread->waitForThreadToExit(2000);
+        loadingThread->waitForThreadToExit(-1);
     }
 }
 
 bool PianoSound::appliesToNote(int midiNoteNumber)
 {
-    return enabled.load() && samplesLoaded.load() && midiNoteNumber >= 21 && midiNoteNumber <= 108; // 钢琴音域
+    // 钢琴音域；加载过程中只接受样本已发布的键，加载完成后没有 region 的键由 PianoVoice 合成
+    return enabled.load() && midiNoteNumber >= 21 && midiNoteNumber <= 108
+        && (samplesLoaded.load() || findSampleData(midiNoteNumber) != nullptr);
 }
 
 bool PianoSound::appliesToChannel(int midiChannelNumber)
@@ -32,39 +43,24 @@ bool PianoSound::appliesToChannel(int midiChannelNumber)
     return enabled.load();
 }
 
-bool PianoSound::loadSFZ(const juce::File& sfzFile)
+juce::Array<PianoSound::Region> PianoSound::parseSFZRegions(const juce::File& sfzFile)
 {
-    if (!sfzFile.exists())
-    {
-        DBG("SFZ file does not exist: " + sfzFile.getFullPathName());
-        return false;
-    }
-    
-    DBG("Starting SFZ file parsing: " + sfzFile.getFullPathName());
-    
-    samples.clear();
+    juce::Array<Region> regions;
     
     // 解析SFZ文件 - 支持新格式 (key= 和 region 内联属性)
     juce::String content = sfzFile.loadFileAsString();
     
-    DBG("SFZ file content length: " + juce::String(content.length()));
-    
     // 逐行扫描 <region>，不能用字符集切分（fromTokens 会把 "<region>" 拆成单字符分隔）
     juce::StringArray lines = juce::StringArray::fromLines(content);
-    int regionCount = 0;
+    juce::File basePath = sfzFile.getParentDirectory();
     
-    // 使用全局缓存，避免重复解码
-
     for (const auto& lineRegionHack : lines)
     {
         juce::String regionContent = lineRegionHack.trim();
-        if (regionContent.isEmpty()) continue;
-        if (! regionContent.startsWith("<region>")) continue;
-        
-        regionCount++;
+        if (regionContent.isEmpty() || !regionContent.startsWith("<region>")) continue;
         
         // 解析每行的参数
-        int currentLoKey = -1, currentHiKey = -1, currentRootNote = -1;
+        int currentLoKey = -1, currentHiKey = -1, currentRootNote = -1, currentOffset = 0;
         juce::String currentSamplePath;
         
         juce::StringArray regionLines = juce::StringArray::fromLines(regionContent);
@@ -81,10 +77,8 @@ bool PianoSound::loadSFZ(const juce::File& sfzFile)
             {
                 if (token.startsWith("sample="))
                 {
-                    currentSamplePath = token.substring(7);
                     // 规范化路径：去掉引号并将反斜杠改为正斜杠
-                    currentSamplePath = currentSamplePath.unquoted();
-                    currentSamplePath = currentSamplePath.replaceCharacters("\\", "/");
+                    currentSamplePath = token.substring(7).unquoted().replaceCharacters("\\", "/");
                 }
                 else if (token.startsWith("key="))
                 {
@@ -103,156 +97,392 @@ bool PianoSound::loadSFZ(const juce::File& sfzFile)
                 {
                     currentRootNote = token.substring(16).getIntValue();
                 }
+                else if (token.startsWith("offset="))
+                {
+                    currentOffset = juce::jmax(0, token.substring(7).getIntValue());
+                }
             }
         }
         
-        // 加载样本
-        if (currentLoKey >= 0 && currentHiKey >= 0 && currentRootNote >= 0 && currentSamplePath.isNotEmpty())
+        if (currentLoKey < 0 || currentHiKey < 0 || currentRootNote < 0 || currentSamplePath.isEmpty())
+            continue;
+        
+        // 处理相对路径：../ 前缀（Windows 风格 ..\ 已被替换为 ../）
+        juce::File sampleFile;
+        if (currentSamplePath.startsWith("../"))
+            sampleFile = basePath.getParentDirectory().getChildFile(currentSamplePath.substring(3));
+        else
+            sampleFile = basePath.getChildFile(currentSamplePath);
+        
+        // 若未找到，兼容“扁平化复制资源”的情况：按文件名在 SFZ 所在目录直接查找
+        if (! sampleFile.exists())
         {
-            // 处理相对路径
-            juce::File basePath = sfzFile.getParentDirectory();
-            juce::File sampleFile;
-            
-            // 处理 ../ 前缀（Windows 风格 ..\ 已被替换为 ../）
-            if (currentSamplePath.startsWith("../"))
-            {
-                sampleFile = basePath.getParentDirectory().getChildFile(currentSamplePath.substring(3));
-            }
-            else
+            auto fallback = basePath.getChildFile(juce::File(currentSamplePath).getFileName());
+            if (fallback.exists())
             {
-                sampleFile = basePath.getChildFile(currentSamplePath);
-            }
-            
-            // 若未找到，兼容“扁平化复制资源”的情况：按文件名在 SFZ 所在目录直接查找
-            if (! sampleFile.exists())
-            {
-                auto fileNameOnly = juce::File(currentSamplePath).getFileName();
-                auto fallback = basePath.getChildFile(fileNameOnly);
-                if (fallback.exists()) {
-                    DBG("Fallback sample path hit (flattened bundle): " + fallback.getFullPathName());
-                    sampleFile = fallback;
-                }
-            }
-            
-            DBG("Trying to load sample: " + sampleFile.getFullPathName() + 
-                " (lokey=" + juce::String(currentLoKey) + 
-                ", hikey=" + juce::String(currentHiKey) + 
-                ", root=" + juce::String(currentRootNote) + ")");
-            
-            if (sampleFile.exists())
-            {
-                auto absPath = sampleFile.getFullPathName().toStdString();
-                std::shared_ptr<juce::AudioBuffer<float>> bufferPtr;
-                double loadedSampleRate = 0.0;
-
-                auto it = gSampleCache.find(absPath);
-                if (it != gSampleCache.end())
-                {
-                    bufferPtr = it->second;
-                }
-                else
-                {
-                    juce::AudioFormatManager formatManager;
-                    formatManager.registerBasicFormats();
-                    // 基础格式已包含 FLAC（若启用）。不重复注册以避免断言。
-
-                    std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(sampleFile));
-                    if (reader != nullptr)
-                    {
-                        bufferPtr = std::make_shared<juce::AudioBuffer<float>>((int)reader->numChannels,
-                                                                               (int)reader->lengthInSamples);
-                        reader->read(bufferPtr.get(), 0, (int)reader->lengthInSamples, 0, true, true);
-                        gSampleCache.emplace(absPath, bufferPtr);
-                        loadedSampleRate = reader->sampleRate;
-                        gSampleRateCache.emplace(absPath, loadedSampleRate);
-                        DBG("Loaded sample file: " + sampleFile.getFileName() +
-                            " (sr=" + juce::String(reader->sampleRate) +
-                            ", len=" + juce::String(reader->lengthInSamples) + ")");
-                    }
-                    else
-                    {
-                        DBG("Could not create audio reader for: " + sampleFile.getFileName());
-                    }
-                }
-
-                if (bufferPtr != nullptr)
-                {
-                    auto sampleData = new SampleData();
-                    sampleData->audioBuffer = bufferPtr;
-                    sampleData->rootNote = currentRootNote;
-                    sampleData->loKey = currentLoKey;
-                    sampleData->hiKey = currentHiKey;
-                    // 采样率从缓存中读取，找不到则回退到48k
-                    if (loadedSampleRate <= 0.0)
-                    {
-                        auto itSR = gSampleRateCache.find(absPath);
-                        if (itSR != gSampleRateCache.end())
-                            loadedSampleRate = itSR->second;
-                        else
-                            loadedSampleRate = 48000.0;
-                    }
-                    sampleData->sampleRate = loadedSampleRate;
-                    samples.add(sampleData);
-                }
-            }
-            else
-            {
-                DBG("Sample file does not exist: " + sampleFile.getFullPathName());
+                DBG("Fallback sample path hit (flattened bundle): " + fallback.getFullPathName());
+                sampleFile = fallback;
             }
         }
+        
+        Region region;
+        region.sampleFile = sampleFile;
+        region.loKey = currentLoKey;
+        region.hiKey = currentHiKey;
+        region.rootNote = currentRootNote;
+        region.offset = currentOffset;
+        regions.add(region);
     }
     
-    samplesLoaded.store(samples.size() > 0);
-    DBG("SFZ loading completed. Processed " + juce::String(regionCount) + " regions, successfully loaded " + juce::String(samples.size()) + " samples");
-    return samplesLoaded.load();
+    return regions;
 }
 
-juce::AudioBuffer<float>* PianoSound::getSampleForNote(int midiNote)
+std::shared_ptr<juce::AudioBuffer<float>> PianoSound::loadSampleFile(const juce::File& sampleFile, double& sampleRate)
 {
-    for (auto* sample : samples)
+    auto absPath = sampleFile.getFullPathName().toStdString();
+    
     {
-        if (midiNote >= sample->loKey && midiNote <= sample->hiKey)
+        const juce::ScopedLock sl(gSampleCacheLock);
+        auto it = gSampleCache.find(absPath);
+        if (it != gSampleCache.end())
         {
-            return sample->audioBuffer.get();
+            // 采样率从缓存中读取，找不到则回退到48k
+            auto itSR = gSampleRateCache.find(absPath);
+            sampleRate = itSR != gSampleRateCache.end() ? itSR->second : 48000.0;
+            return it->second;
         }
     }
-    return nullptr;
+    
+    auto bufferPtr = decodeSampleFile(sampleFile, sampleRate);
+    if (bufferPtr == nullptr)
+        return nullptr;
+    
+    const juce::ScopedLock sl(gSampleCacheLock);
+    gSampleCache.emplace(absPath, bufferPtr);
+    gSampleRateCache.emplace(absPath, sampleRate);
+    return bufferPtr;
 }
 
-int PianoSound::getRootNoteForMidiNote(int midiNote)
+std::shared_ptr<juce::AudioBuffer<float>> PianoSound::decodeSampleFile(const juce::File& sampleFile, double& sampleRate)
 {
-    for (auto* sample : samples)
+    juce::AudioFormatManager formatManager;
+    formatManager.registerBasicFormats();
+    // 基础格式已包含 FLAC（若启用）。不重复注册以避免断言。
+    
+    std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(sampleFile));
+    if (reader == nullptr)
     {
-        if (midiNote >= sample->loKey && midiNote <= sample->hiKey)
-        {
-            return sample->rootNote;
-        }
+        DBG("Could not create audio reader for: " + sampleFile.getFileName());
+        return nullptr;
     }
-    return 60; // 默认返回C4 (MIDI note 60)
+    
+    sampleRate = reader->sampleRate;
+    return decodeSample(*reader, sampleFile.getFileName());
 }
 
-double PianoSound::getSampleRateForMidiNote(int midiNote)
+std::shared_ptr<juce::AudioBuffer<float>> PianoSound::decodeSample(juce::AudioFormatReader& reader, const juce::String& name)
 {
-    for (auto* sample : samples)
+    auto bufferPtr = std::make_shared<juce::AudioBuffer<float>>((int)reader.numChannels,
+                                                                (int)reader.lengthInSamples);
+    reader.read(bufferPtr.get(), 0, (int)reader.lengthInSamples, 0, true, true);
+    const double sampleRate = reader.sampleRate;
+    
+    // 裁掉尾部低于峰值 TRIM_THRESHOLD_DB 的部分：保留到最后一个超过阈值的样本，并在其前 TRIM_FADE_MS 内淡出
+    auto& buffer = *bufferPtr;
+    const float threshold = buffer.getMagnitude(0, buffer.getNumSamples()) * juce::Decibels::decibelsToGain(TRIM_THRESHOLD_DB);
+    int length = buffer.getNumSamples();
+    while (length > 0)
+    {
+        float magnitude = 0.0f;
+        for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+            magnitude = juce::jmax(magnitude, std::abs(buffer.getSample(ch, length - 1)));
+        if (magnitude > threshold)
+            break;
+        --length;
+    }
+    if (length < buffer.getNumSamples())
     {
-        if (midiNote >= sample->loKey && midiNote <= sample->hiKey)
+        const int fadeLength = juce::jmin(length, juce::roundToInt(TRIM_FADE_MS * 0.001 * sampleRate));
+        buffer.applyGainRamp(length - fadeLength, fadeLength, 1.0f, 0.0f);
+        buffer.setSize(buffer.getNumChannels(), juce::jmax(1, length), true, false, false);
+    }
+    
+    DBG("Loaded sample file: " + name +
+        " (sr=" + juce::String(sampleRate) +
+        ", len=" + juce::String(reader.lengthInSamples) + ", trimmed to " + juce::String(buffer.getNumSamples()) + ")");
+    juce::ignoreUnused(name);
+    return bufferPtr;
+}
+
+int PianoSound::findOnset(const juce::AudioBuffer<float>& buffer, int searchFrom)
+{
+    const int numSamples = buffer.getNumSamples();
+    const float threshold = buffer.getMagnitude(0, numSamples) * juce::Decibels::decibelsToGain(ONSET_THRESHOLD_DB);
+    for (int i = juce::jmax(0, searchFrom); i < numSamples; ++i)
+        for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+            if (std::abs(buffer.getSample(ch, i)) > threshold)
+                return i;
+    return juce::jlimit(0, numSamples - 1, searchFrom);
+}
+
+std::vector<float> PianoSound::computeEnvelope(const juce::AudioBuffer<float>& buffer)
+{
+    const int numSamples = buffer.getNumSamples();
+    std::vector<float> envelope((size_t) ((numSamples + ENVELOPE_BLOCK - 1) / ENVELOPE_BLOCK), 0.0f);
+    for (size_t b = 0; b < envelope.size(); ++b)
+    {
+        const int start = (int) b * ENVELOPE_BLOCK;
+        const int length = juce::jmin(ENVELOPE_BLOCK, numSamples - start);
+        for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+            envelope[b] = juce::jmax(envelope[b], buffer.getMagnitude(ch, start, length));
+    }
+    
+    // 从后往前取最大值：任意位置读到的值都是之后不会再超过的上界
+    for (size_t b = envelope.size(); b-- > 1;)
+        envelope[b - 1] = juce::jmax(envelope[b - 1], envelope[b]);
+    return envelope;
+}
+
+PianoSound::SampleData* PianoSound::createSampleData(const Region& region, int regionIndex,
+                                                     std::shared_ptr<juce::AudioBuffer<float>> buffer, double sampleRate)
+{
+    auto* sampleData = new SampleData();
+    sampleData->regionIndex = regionIndex;
+    sampleData->rootNote = region.rootNote;
+    sampleData->loKey = region.loKey;
+    sampleData->hiKey = region.hiKey;
+    sampleData->sampleRate = sampleRate;
+    
+    // 起音前的噪声与静音长度各键不同：播放起点统一放在起音前 ONSET_PRE_ROLL_MS，不早于 SFZ offset
+    const int offset = juce::jmin(region.offset, buffer->getNumSamples() - 1);
+    sampleData->onset = findOnset(*buffer, offset);
+    sampleData->startOffset = juce::jmax(offset, sampleData->onset - juce::roundToInt(ONSET_PRE_ROLL_MS * 0.001 * sampleRate));
+    sampleData->envelope = computeEnvelope(*buffer);
+    sampleData->audioBuffer = std::move(buffer);
+    
+    DBG("Region " + juce::String(region.loKey) + "-" + juce::String(region.hiKey) + ": onset at "
+        + juce::String(sampleData->onset * 1000.0 / sampleRate, 2) + " ms, playback starts at "
+        + juce::String(sampleData->startOffset * 1000.0 / sampleRate, 2) + " ms");
+    return sampleData;
+}
+
+juce::Array<PianoSound::Region> PianoSound::openInstrument(const juce::File& file, std::unique_ptr<InstrumentPack>& pack)
+{
+    if (!InstrumentPack::isPackFile(file))
+        return parseSFZRegions(file);
+    
+    pack = InstrumentPack::open(file);
+    return pack != nullptr ? pack->getRegions() : juce::Array<Region>();
+}
+
+juce::String PianoSound::getSourceKey(InstrumentPack* pack, const Region& region, int regionIndex)
+{
+    return pack != nullptr ? "payload:" + juce::String(pack->getPayloadOffset(regionIndex))
+                           : region.sampleFile.getFullPathName();
+}
+
+PianoSound::SourceMap PianoSound::collectSources(InstrumentPack* pack, const juce::Array<Region>& regions)
+{
+    SourceMap sources;
+    for (int regionIndex = 0; regionIndex < regions.size(); ++regionIndex)
+        ++sources[getSourceKey(pack, regions.getReference(regionIndex), regionIndex)].remainingRegions;
+    return sources;
+}
+
+PianoSound::SampleData* PianoSound::loadRegion(InstrumentPack* pack, const Region& region, int regionIndex, SourceMap& sources)
+{
+    auto& source = sources[getSourceKey(pack, region, regionIndex)];
+    if (!source.loaded)
+    {
+        const bool compressed = storageMode.load() == storageCompressed;
+        source.loaded = true;
+        if (pack != nullptr)
+            source.buffer = pack->loadRegionSamples(regionIndex, source.sampleRate);
+        else if (!region.sampleFile.exists())
+            DBG("Sample file does not exist: " + region.sampleFile.getFullPathName());
+        else if (compressed)
+            source.buffer = decodeSampleFile(region.sampleFile, source.sampleRate);   // 不进全局缓存，浮点数据用完即释放
+        else
+            source.buffer = loadSampleFile(region.sampleFile, source.sampleRate);
+        
+        // 起音与包络按实际播放的（解码后的）样本分析
+        if (compressed && source.buffer != nullptr)
         {
-            return sample->sampleRate;
+            source.compressed = CompressedSample::encode(*source.buffer);
+            source.buffer = source.compressed->decode();
         }
     }
-    return 44100.0; // 默认返回标准采样率
+    
+    SampleData* sampleData = nullptr;
+    if (source.buffer != nullptr)
+    {
+        sampleData = createSampleData(region, regionIndex, source.buffer, source.sampleRate);
+        if (source.compressed != nullptr)
+        {
+            sampleData->audioBuffer.reset();
+            sampleData->compressed = source.compressed;
+        }
+    }
+    
+    if (--source.remainingRegions <= 0)
+        source.buffer.reset();
+    return sampleData;
 }
 
-void PianoSound::loadSFZAsync(const juce::File& sfzFile, std::function<void(bool, int, int)> callback)
+void PianoSound::clearSampleCache()
 {
-    // 停止之前的加载任务
-    if (loadingThread && loadingThread->isThreadRunning())
+    // 仅释放缓存自身的引用，已被 SampleData 持有的缓冲区仍然有效
+    const juce::ScopedLock sl(gSampleCacheLock);
+    gSampleCache.clear();
+    gSampleRateCache.clear();
+}
+
+bool PianoSound::loadSFZ(const juce::File& sfzFile)
+{
+    if (!sfzFile.exists())
     {
-        loadingThread->signalThreadShouldExit();
-        loadingThread->waitForThreadToExit(1000);
+        DBG("SFZ file does not exist: " + sfzFile.getFullPathName());
+        return false;
+    }
+    
+    DBG("Starting SFZ file parsing: " + sfzFile.getFullPathName());
+    
+    beginLoading();
+    
+    std::unique_ptr<InstrumentPack> pack;
+    auto regions = openInstrument(sfzFile, pack);
+    auto sources = collectSources(pack.get(), regions);
+    
+    for (int regionIndex = 0; regionIndex < regions.size(); ++regionIndex)
+    {
+        const auto& region = regions.getReference(regionIndex);
+
+        DBG("Trying to load sample: " + region.sampleFile.getFullPathName() + 
+            " (lokey=" + juce::String(region.loKey) + 
+            ", hikey=" + juce::String(region.hiKey) + 
+            ", root=" + juce::String(region.rootNote) + ")");
+        
+        if (auto* sampleData = loadRegion(pack.get(), region, regionIndex, sources))
+            publishSampleData(sampleData);
+    }
+    
+    samplesLoaded.store(samples.size() > 0);
+    DBG("SFZ loading completed. Processed " + juce::String(regions.size()) + " regions, successfully loaded " + juce::String(samples.size()) + " samples");
+    return samplesLoaded.load();
+}
+
+PianoSound::SampleData* PianoSound::findSampleData(int midiNote) const
+{
+    if (midiNote < 0 || midiNote > 127)
+        return nullptr;
+    return keySamples[midiNote].load(std::memory_order_acquire);
+}
+
+void PianoSound::beginLoading()
+{
+    samplesLoaded.store(false);
+    for (auto& key : keySamples)
+        key.store(nullptr, std::memory_order_release);
+    loadedRegions.store(0);
+    sampleMemoryBytes.store(0);
+    
+    // 音频线程可能刚取到旧的 SampleData，旧数据保留到析构时释放（重新加载很少发生）
+    while (samples.size() > 0)
+        retiredSamples.add(samples.removeAndReturn(samples.size() - 1));
+}
+
+void PianoSound::publishSampleData(SampleData* sampleData)
+{
+    // 多个 region 共享的缓冲区只计一次（samples 只由加载线程修改，这里可以直接遍历）
+    const auto* buffer = sampleData->audioBuffer.get();
+    const auto* compressed = sampleData->compressed.get();
+    bool bufferCounted = buffer == nullptr, compressedCounted = compressed == nullptr;
+    for (auto* sample : samples)
+    {
+        bufferCounted = bufferCounted || sample->audioBuffer.get() == buffer;
+        compressedCounted = compressedCounted || sample->compressed.get() == compressed;
     }
     
+    size_t bytes = 0;
+    if (!bufferCounted)
+        bytes += (size_t) buffer->getNumChannels() * (size_t) buffer->getNumSamples() * sizeof(float);
+    if (!compressedCounted)
+        bytes += compressed->getMemoryBytes();
+    sampleMemoryBytes.fetch_add(bytes);
+    
+    samples.add(sampleData);
+    
+    // 先于它加载的 region 若在文件中更靠后，让出重叠的键（与按文件顺序查找的结果一致）
+    for (int key = juce::jmax(0, sampleData->loKey); key <= juce::jmin(127, sampleData->hiKey); ++key)
+    {
+        auto* existing = keySamples[key].load(std::memory_order_relaxed);
+        if (existing == nullptr || existing->regionIndex > sampleData->regionIndex)
+            keySamples[key].store(sampleData, std::memory_order_release);
+    }
+    loadedRegions.fetch_add(1);
+}
+
+juce::AudioBuffer<float>* PianoSound::getSampleForNote(int midiNote)
+{
+    auto* sample = findSampleData(midiNote);
+    return sample != nullptr ? sample->audioBuffer.get() : nullptr;
+}
+
+const CompressedSample* PianoSound::getCompressedSampleForNote(int midiNote)
+{
+    auto* sample = findSampleData(midiNote);
+    return sample != nullptr ? sample->compressed.get() : nullptr;
+}
+
+int PianoSound::getRootNoteForMidiNote(int midiNote)
+{
+    auto* sample = findSampleData(midiNote);
+    return sample != nullptr ? sample->rootNote : 60; // 默认返回C4 (MIDI note 60)
+}
+
+double PianoSound::getSampleRateForMidiNote(int midiNote)
+{
+    auto* sample = findSampleData(midiNote);
+    return sample != nullptr ? sample->sampleRate : 44100.0; // 默认返回标准采样率
+}
+
+int PianoSound::getStartOffsetForMidiNote(int midiNote)
+{
+    auto* sample = findSampleData(midiNote);
+    return sample != nullptr ? sample->startOffset : 0;
+}
+
+int PianoSound::getOnsetForMidiNote(int midiNote)
+{
+    auto* sample = findSampleData(midiNote);
+    return sample != nullptr ? sample->onset : 0;
+}
+
+double PianoSound::getOnsetLatencyMsForMidiNote(int midiNote)
+{
+    auto* sample = findSampleData(midiNote);
+    return sample != nullptr ? (sample->onset - sample->startOffset) * 1000.0 / sample->sampleRate : 0.0;
+}
+
+const std::vector<float>* PianoSound::getEnvelopeForMidiNote(int midiNote)
+{
+    auto* sample = findSampleData(midiNote);
+    return sample != nullptr ? &sample->envelope : nullptr;
+}
+
+size_t PianoSound::getSampleMemoryBytes() const
+{
+    return sampleMemoryBytes.load();
+}
+
+void PianoSound::loadSFZAsync(const juce::File& sfzFile, std::function<void(bool, int, int)> callback,
+                              const juce::Array<int>& priorityKeys)
+{
+    // 停止之前的加载任务（线程未退出时无法重新启动）
+    stopLoading();
+    
     pendingSFZFile = sfzFile;
+    pendingPriorityKeys = priorityKeys;
     progressCallback = callback;
     loadingProgress = 0;
     
@@ -272,163 +502,69 @@ void PianoSound::runLoadingThread()
     
     DBG("[Async] Starting SFZ file parsing: " + pendingSFZFile.getFullPathName());
     
-    // 暂时清空现有样本
-    juce::OwnedArray<SampleData> tempSamples;
+    beginLoading();
     
-    // 解析SFZ文件
-    juce::String content = pendingSFZFile.loadFileAsString();
-    juce::StringArray lines = juce::StringArray::fromLines(content);
-    int regionCount = 0;
+    std::unique_ptr<InstrumentPack> pack;
+    auto regions = openInstrument(pendingSFZFile, pack);
+    auto sources = collectSources(pack.get(), regions);
+    int regionCount = regions.size();
     int processedRegions = 0;
     
-    // 首先统计总数
-    for (const auto& line : lines)
+    DBG("[Async] Found " + juce::String(regionCount) + " regions to process");
+    
+    // 加载顺序：按 region 覆盖的优先键中最靠前的位置排序，不覆盖任何优先键的 region 保持文件顺序排在最后
+    juce::Array<int> loadOrder;
+    juce::Array<int> ranks;
+    for (int regionIndex = 0; regionIndex < regionCount; ++regionIndex)
     {
-        if (line.trim().startsWith("<region>")) regionCount++;
+        const auto& region = regions.getReference(regionIndex);
+        int rank = pendingPriorityKeys.size();
+        for (int i = 0; i < pendingPriorityKeys.size(); ++i)
+        {
+            if (pendingPriorityKeys[i] >= region.loKey && pendingPriorityKeys[i] <= region.hiKey)
+            {
+                rank = i;
+                break;
+            }
+        }
+        loadOrder.add(regionIndex);
+        ranks.add(rank);
     }
-    
-    DBG("[Async] Found " + juce::String(regionCount) + " regions to process");
+    std::stable_sort(loadOrder.begin(), loadOrder.end(), [&ranks](int a, int b) { return ranks[a] < ranks[b]; });
 
-    for (const auto& lineRegionHack : lines)
+    for (int regionIndex : loadOrder)
     {
         if (loadingThread->threadShouldExit()) return;
         
-        juce::String regionContent = lineRegionHack.trim();
-        if (regionContent.isEmpty() || !regionContent.startsWith("<region>")) continue;
-        
+        const auto& region = regions.getReference(regionIndex);
         processedRegions++;
         
-        // 解析每行的参数
-        int currentLoKey = -1, currentHiKey = -1, currentRootNote = -1;
-        juce::String currentSamplePath;
+        DBG("[Async] Processing sample " + juce::String(processedRegions) + "/" + 
+            juce::String(regionCount) + ": " + region.sampleFile.getFileName());
         
-        juce::StringArray regionLines = juce::StringArray::fromLines(regionContent);
-        
-        for (const auto& line : regionLines)
-        {
-            juce::String trimmedLine = line.trim();
-            if (trimmedLine.isEmpty() || trimmedLine.startsWith("//")) continue;
-            
-            juce::StringArray tokens = juce::StringArray::fromTokens(trimmedLine, " ", "");
-            
-            for (const auto& token : tokens)
-            {
-                if (token.startsWith("sample="))
-                {
-                    currentSamplePath = token.substring(7).unquoted().replaceCharacters("\\", "/");
-                }
-                else if (token.startsWith("key="))
-                {
-                    int keyValue = token.substring(4).getIntValue();
-                    currentLoKey = currentHiKey = keyValue;
-                }
-                else if (token.startsWith("lokey="))
-                {
-                    currentLoKey = token.substring(6).getIntValue();
-                }
-                else if (token.startsWith("hikey="))
-                {
-                    currentHiKey = token.substring(6).getIntValue();
-                }
-                else if (token.startsWith("pitch_keycenter="))
-                {
-                    currentRootNote = token.substring(16).getIntValue();
-                }
-            }
-        }
-        
-        // 加载样本
-        if (currentLoKey >= 0 && currentHiKey >= 0 && currentRootNote >= 0 && currentSamplePath.isNotEmpty())
-        {
-            juce::File basePath = pendingSFZFile.getParentDirectory();
-            juce::File sampleFile;
-            
-            if (currentSamplePath.startsWith("../"))
-            {
-                sampleFile = basePath.getParentDirectory().getChildFile(currentSamplePath.substring(3));
-            }
-            else
-            {
-                sampleFile = basePath.getChildFile(currentSamplePath);
-            }
-            
-            if (!sampleFile.exists())
-            {
-                auto fileNameOnly = juce::File(currentSamplePath).getFileName();
-                auto fallback = basePath.getChildFile(fileNameOnly);
-                if (fallback.exists()) sampleFile = fallback;
-            }
-            
-            DBG("[Async] Processing sample " + juce::String(processedRegions) + "/" + 
-                juce::String(regionCount) + ": " + sampleFile.getFileName());
-            
-            if (sampleFile.exists())
-            {
-                auto absPath = sampleFile.getFullPathName().toStdString();
-                std::shared_ptr<juce::AudioBuffer<float>> bufferPtr;
-                double loadedSampleRate = 0.0;
-
-                auto it = gSampleCache.find(absPath);
-                if (it != gSampleCache.end())
-                {
-                    bufferPtr = it->second;
-                    auto itSR = gSampleRateCache.find(absPath);
-                    if (itSR != gSampleRateCache.end())
-                        loadedSampleRate = itSR->second;
-                    else
-                        loadedSampleRate = 48000.0;
-                }
-                else
-                {
-                    juce::AudioFormatManager formatManager;
-                    formatManager.registerBasicFormats();
-
-                    std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(sampleFile));
-                    if (reader != nullptr)
-                    {
-                        bufferPtr = std::make_shared<juce::AudioBuffer<float>>((int)reader->numChannels,
-                                                                               (int)reader->lengthInSamples);
-                        reader->read(bufferPtr.get(), 0, (int)reader->lengthInSamples, 0, true, true);
-                        gSampleCache.emplace(absPath, bufferPtr);
-                        loadedSampleRate = reader->sampleRate;
-                        gSampleRateCache.emplace(absPath, loadedSampleRate);
-                        DBG("[Async] Loaded: " + sampleFile.getFileName() + " (sr=" + 
-                            juce::String(reader->sampleRate) + ", len=" + juce::String(reader->lengthInSamples) + ")");
-                    }
-                }
-
-                if (bufferPtr != nullptr)
-                {
-                    auto sampleData = new SampleData();
-                    sampleData->audioBuffer = bufferPtr;
-                    sampleData->rootNote = currentRootNote;
-                    sampleData->loKey = currentLoKey;
-                    sampleData->hiKey = currentHiKey;
-                    sampleData->sampleRate = loadedSampleRate;
-                    tempSamples.add(sampleData);
-                }
-            }
-        }
+        // 解码完成立即发布，对应的键从此可以发声
+        if (auto* sampleData = loadRegion(pack.get(), region, regionIndex, sources))
+            publishSampleData(sampleData);
         
         // 更新进度
         int progress = (processedRegions * 100) / regionCount;
         loadingProgress = progress;
         
-        // 为了避免真机上MessageManager::callAsync引起的问题，暂时移除进度回调
-        // 加载完成后会有最终回调
-        if (progressCallback && processedRegions % 10 == 0)  // 每10个样本输出一次日志
+        // 直接在后台线程回调（避免真机上 MessageManager::callAsync 的问题）
+        if (progressCallback)
+            progressCallback(false, progress, loadedRegions.load());
+        
+        if (processedRegions % 10 == 0)  // 每10个样本输出一次日志
         {
-            DBG("[Async] Progress: " + juce::String(progress) + "% (" + juce::String(tempSamples.size()) + " samples)");
+            DBG("[Async] Progress: " + juce::String(progress) + "% (" + juce::String(loadedRegions.load()) + " samples)");
         }
         
         // 给主线程一些喘息时间
         juce::Thread::sleep(2);
     }
     
-    // 原子性地替换样本数据
     if (!loadingThread->threadShouldExit())
     {
-        samples.swapWith(tempSamples);
         samplesLoaded.store(samples.size() > 0);
         loadingProgress = 100;
         
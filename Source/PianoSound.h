@@ -3,12 +3,35 @@
 #include <juce_audio_formats/juce_audio_formats.h>
 #include <juce_core/juce_core.h>
 #include <juce_events/juce_events.h>
+#include <map>
 #include <memory>
+#include "CompressedSample.h"
+
+class InstrumentPack;
 
 // 钢琴音色类
+// 加载时逐 region 分析样本：检测真实起音位置，播放从起音前 ONSET_PRE_ROLL_MS 开始（SFZ offset 语义），
+// 各键的起音延迟因此一致且最小；解码时裁掉低于峰值 TRIM_THRESHOLD_DB 的尾部以节省内存。
+// 每个 region 另存一条粗粒度的幅度包络（每 ENVELOPE_BLOCK 个样本一个值），供 Voice 判断剩余部分是否还可闻。
+// 异步加载按调用方给出的键优先级排序 region，每个 region 解码完成即按键发布（appliesToNote 逐键变为 true），
+// 不必等全部 region 加载完。
+// 加载入口同时接受 SFZ 与打包乐器文件（InstrumentPack，扩展名 .earxpack），后者只打开、映射一个文件。
+// 样本以浮点（storageFloat）或压缩块（storageCompressed，见 CompressedSample）存放，后者由 Voice 播放时逐块解码
 class PianoSound : public juce::SynthesiserSound
 {
 public:
+    static constexpr float ONSET_THRESHOLD_DB = -30.0f;     // 首次超过样本峰值的这么多 dB 处视为起音
+    static constexpr double ONSET_PRE_ROLL_MS = 1.0;        // 播放起点在起音之前的时长（渐入在此期间完成）
+    static constexpr float TRIM_THRESHOLD_DB = -60.0f;      // 尾部低于样本峰值这么多 dB 的部分被裁掉
+    static constexpr double TRIM_FADE_MS = 10.0;            // 裁切点之前的淡出，避免截断处的爆音
+    static constexpr int ENVELOPE_BLOCK = 256;              // 幅度包络的粒度（样本）
+    
+    enum StorageMode
+    {
+        storageFloat,       // 解码后的 32 位浮点，播放时直接读取
+        storageCompressed   // CompressedSample（约 1/4 内存），播放时按块解码
+    };
+    
     PianoSound();
     ~PianoSound() override;
     
@@ -17,23 +40,39 @@ public:
     void setEnabled(bool e) { enabled = e; }
     bool isEnabled() const { return enabled; }
     
-    // 加载SFZ音色
+    // 样本存储方式，对之后开始的加载生效
+    void setStorageMode(StorageMode mode) { storageMode = mode; }
+    StorageMode getStorageMode() const { return storageMode.load(); }
+    
+    // 加载SFZ音色（或打包乐器文件）
     bool loadSFZ(const juce::File& sfzFile);
     
-    // 异步加载SFZ音色
-    void loadSFZAsync(const juce::File& sfzFile, std::function<void(bool, int, int)> progressCallback = nullptr);
+    // 异步加载SFZ音色：覆盖 priorityKeys 中的键的 region 按该顺序先加载，其余 region 随后按文件顺序加载；
+    // progressCallback(completed, progress, loadedRegions) 在加载线程中调用，每发布一个 region 调用一次（completed 为 false），
+    // 全部完成后以 completed == true 调用
+    void loadSFZAsync(const juce::File& sfzFile, std::function<void(bool, int, int)> progressCallback = nullptr,
+                      const juce::Array<int>& priorityKeys = {});
+    
+    // 停止异步加载：等当前 region（或完成回调）处理完，线程真正退出后返回
+    void stopLoading();
     
     // 检查是否正在加载
     bool isLoading() const { return loadingThread && loadingThread->isThreadRunning(); }
     
-    // 检查是否已加载完成
+    // 检查是否已加载完成（全部 region）
     bool isLoaded() const { return samplesLoaded.load(); }
     
+    // 指定键的样本是否已发布（加载过程中逐键变为 true）；已发布的 region 数
+    bool isNoteLoaded(int midiNote) const { return findSampleData(midiNote) != nullptr; }
+    int getNumLoadedRegions() const { return loadedRegions.load(); }
+    
     // 获取加载进度 (0-100)
     int getLoadingProgress() const { return loadingProgress.load(); }
     
-    // 获取指定音符的音频数据
+    // 获取指定音符的音频数据：浮点存储时为解码后的样本，压缩存储时 getSampleForNote 为空，样本由
+    // getCompressedSampleForNote 给出
     juce::AudioBuffer<float>* getSampleForNote(int midiNote);
+    const CompressedSample* getCompressedSampleForNote(int midiNote);
     
     // 获取指定MIDI音符对应样本的根音符
     int getRootNoteForMidiNote(int midiNote);
@@ -41,19 +80,107 @@ public:
     // 获取指定MIDI音符对应样本的采样率
     double getSampleRateForMidiNote(int midiNote);
     
+    // 指定MIDI音符对应 region 的播放起点与检测到的起音位置（样本，按样本自身的采样率）
+    int getStartOffsetForMidiNote(int midiNote);
+    int getOnsetForMidiNote(int midiNote);
+    
+    // 从播放起点到起音的延迟（毫秒，未计变调），即该 region 的起音延迟
+    double getOnsetLatencyMsForMidiNote(int midiNote);
+    
+    // 指定MIDI音符对应 region 的幅度包络：第 b 个值为样本从第 b 块（b * ENVELOPE_BLOCK）起到结尾的峰值，
+    // 因此单调不增；没有样本时返回 nullptr。指针在音色重新加载前有效
+    const std::vector<float>* getEnvelopeForMidiNote(int midiNote);
+    
+    // 样本占用的内存（字节，浮点缓冲区或压缩数据，多个 region 共享的只计一次）；
+    // 随 region 发布累加，加载过程中可在任意线程调用
+    size_t getSampleMemoryBytes() const;
+    
+    // SFZ region 描述（仅解析结果，不含音频数据）
+    struct Region
+    {
+        juce::File sampleFile;
+        int loKey = -1;
+        int hiKey = -1;
+        int rootNote = -1;
+        int offset = 0;         // SFZ offset：起音检测从这里开始，播放起点不早于此
+    };
+    
+    // 解析SFZ文件中的全部 region（同步加载、异步加载与基准测试共用）
+    static juce::Array<Region> parseSFZRegions(const juce::File& sfzFile);
+    
+    // 解码单个样本文件（尾部已裁切），命中全局缓存时直接返回共享缓冲区
+    static std::shared_ptr<juce::AudioBuffer<float>> loadSampleFile(const juce::File& sampleFile, double& sampleRate);
+    
+    // 解码单个样本文件（尾部已裁切），不经过缓存
+    static std::shared_ptr<juce::AudioBuffer<float>> decodeSampleFile(const juce::File& sampleFile, double& sampleRate);
+    
+    // 读出 reader 的全部样本并裁掉低于峰值 TRIM_THRESHOLD_DB 的尾部（不经过缓存；name 仅用于日志）
+    static std::shared_ptr<juce::AudioBuffer<float>> decodeSample(juce::AudioFormatReader& reader, const juce::String& name);
+    
+    // 从 searchFrom 开始检测起音位置（样本）：首个超过全样本峰值 ONSET_THRESHOLD_DB 的样本
+    static int findOnset(const juce::AudioBuffer<float>& buffer, int searchFrom);
+    
+    // 计算 buffer 的剩余峰值包络（见 getEnvelopeForMidiNote）
+    static std::vector<float> computeEnvelope(const juce::AudioBuffer<float>& buffer);
+    
+    // 清空全局样本缓存（基准测试测量冷解码时使用）
+    static void clearSampleCache();
+    
 private:
     struct SampleData
     {
-        std::shared_ptr<juce::AudioBuffer<float>> audioBuffer; // 共享底层样本缓存，避免重复加载
+        std::shared_ptr<juce::AudioBuffer<float>> audioBuffer; // 共享底层样本缓存，避免重复加载（压缩存储时为空）
+        std::shared_ptr<const CompressedSample> compressed;    // 压缩存储时的样本
         int rootNote;
         int loKey;
         int hiKey;
         double sampleRate;
+        int startOffset;    // 播放起点（起音前 ONSET_PRE_ROLL_MS，不早于 SFZ offset）
+        int onset;          // 检测到的起音位置
+        std::vector<float> envelope;    // 剩余峰值包络，每 ENVELOPE_BLOCK 个样本一个值
+        int regionIndex;    // 在 SFZ 文件中的顺序，多个 region 覆盖同一个键时靠前的生效
     };
     
+    static SampleData* createSampleData(const Region& region, int regionIndex, std::shared_ptr<juce::AudioBuffer<float>> buffer,
+                                        double sampleRate);
+    SampleData* findSampleData(int midiNote) const;
+    
+    // 按文件类型取得 region 列表：打包文件同时打开映射（pack 非空），SFZ 时 pack 为空
+    static juce::Array<Region> openInstrument(const juce::File& file, std::unique_ptr<InstrumentPack>& pack);
+    // 一次加载内已取得的样本源（样本文件或打包载荷），多个 region 共用时只解码、压缩一次
+    // 压缩存储时 buffer 为压缩数据解码后的样本，只供起音与包络分析，最后一个使用它的 region 加载后释放
+    struct LoadedSource
+    {
+        std::shared_ptr<juce::AudioBuffer<float>> buffer;
+        std::shared_ptr<const CompressedSample> compressed; // 压缩存储
+        double sampleRate = 0.0;
+        int remainingRegions = 0;   // 尚未加载的引用该样本源的 region 数
+        bool loaded = false;
+    };
+    using SourceMap = std::map<juce::String, LoadedSource>;
+    
+    // 按 region 统计各样本源的引用数（加载开始前调用）
+    static SourceMap collectSources(InstrumentPack* pack, const juce::Array<Region>& regions);
+    static juce::String getSourceKey(InstrumentPack* pack, const Region& region, int regionIndex);
+    
+    // 第 regionIndex 个 region 的 SampleData（按当前存储方式）：打包文件从映射读取，否则解码 region 引用的样本文件；
+    // 样本不可用时返回 nullptr
+    SampleData* loadRegion(InstrumentPack* pack, const Region& region, int regionIndex, SourceMap& sources);
+    
+    // 开始新的加载：清空按键索引，已有数据移入 retiredSamples（正在发声的 Voice 可能仍在读取）
+    void beginLoading();
+    // 加入 samples 并按键发布（加载线程调用）
+    void publishSampleData(SampleData* sampleData);
+    
+    // samples 只由加载线程追加；音频线程经 keySamples 按键查找，发布后的 SampleData 在 PianoSound 析构前不会释放
     juce::OwnedArray<SampleData> samples;
+    juce::OwnedArray<SampleData> retiredSamples;
+    std::atomic<SampleData*> keySamples[128] = {};
+    std::atomic<int> loadedRegions { 0 };
+    std::atomic<size_t> sampleMemoryBytes { 0 };
     std::atomic<bool> samplesLoaded { false };
     std::atomic<bool> enabled { true };
+    std::atomic<StorageMode> storageMode { storageFloat };
     
     // 异步加载支持
     class LoadingThread : public juce::Thread
@@ -69,6 +196,7 @@ private:
     std::atomic<int> loadingProgress { 0 };
     std::function<void(bool, int, int)> progressCallback;
     juce::File pendingSFZFile;
+    juce::Array<int> pendingPriorityKeys;
     
     // 加载线程实现
     void runLoadingThread();
@@ -1,5 +1,23 @@
 #include "PianoVoice.h"
 
+namespace
+{
+    // 合成音色回退的分音表（不衰减，包络由 PianoVoice 自己叠加）
+    const PartialOscillator::Profile& getSyntheticProfile()
+    {
+        static const PartialOscillator::Profile profile = []
+        {
+            PartialOscillator::Profile p;
+            p.numPartials = 3;
+            p.amplitude[0] = 0.6f;
+            p.amplitude[1] = 0.3f;
+            p.amplitude[2] = 0.15f;
+            return p;
+        }();
+        return profile;
+    }
+}
+
 PianoVoice::PianoVoice()
 {
 }
@@ -15,12 +33,16 @@ void PianoVoice::startNote(int midiNoteNumber, float velocity, juce::Synthesiser
     
     if (auto* pianoSound = dynamic_cast<PianoSound*>(sound))
     {
-        currentSample = pianoSound->getSampleForNote(midiNoteNumber);
-        if (currentSample != nullptr)
+        noteReader->setSource(pianoSound->getSampleForNote(midiNoteNumber),
+                              pianoSound->getCompressedSampleForNote(midiNoteNumber));
+        if (noteReader->hasSource())
         {
-            // 使用 SFZ 样本
-            currentPosition = 0.0;
-            level = velocity;
+            // 使用 SFZ 样本：从起音前的预卷位置开始播放，渐入在到达起音时完成
+            startPosition = (double) pianoSound->getStartOffsetForMidiNote(midiNoteNumber);
+            attackLength = (double) juce::jmax(1, pianoSound->getOnsetForMidiNote(midiNoteNumber) - (int) startPosition);
+            currentPosition = startPosition;
+            amplitudeEnvelope = pianoSound->getEnvelopeForMidiNote(midiNoteNumber);
+            level = velocity * getLoudnessGain(midiNoteNumber);
             tailOff = 0.0f;
             isPlaying = true;
             
@@ -33,19 +55,23 @@ void PianoVoice::startNote(int midiNoteNumber, float velocity, juce::Synthesiser
             
             pitchRatio = (noteFreq / sampleFreq) * (sampleSampleRate / currentSampleRate);
             
+            // 刚起音的 Voice 按目标电平报告（不计预卷段渐入），同一块内的后续音符不会把它当作最安静的抢走
+            currentLevel = level * volume;
+            
             DBG("SFZ sample loaded - pitch ratio: " + juce::String(pitchRatio));
         }
         else
         {
             // 回退到合成音色
-            currentSample = nullptr;
+            amplitudeEnvelope = nullptr;
             currentPosition = 0.0;
-            level = velocity * 0.4f;
+            level = velocity * 0.4f * getLoudnessGain(midiNoteNumber);
             tailOff = 0.0f;
             isPlaying = true;
             
             frequency = juce::MidiMessage::getMidiNoteInHertz(midiNoteNumber);
-            pitchRatio = frequency * 2.0 * juce::MathConstants<double>::pi / getSampleRate();
+            syntheticPartials.start(getSyntheticProfile(), frequency, getSampleRate());
+            currentLevel = level * volume;
             
             DBG("Using synthetic piano fallback");
         }
@@ -65,18 +91,154 @@ void PianoVoice::stopNote(float, bool allowTailOff)
     }
     else
     {
+        // 硬停止：接管当前播放位置与电平做快速释放，Voice 立即空出
+        if (isVoiceActive() && isPlaying)
+        {
+            fastRelease.sample = noteReader->hasSource() ? noteReader : nullptr;
+            if (fastRelease.sample == nullptr)
+                fastRelease.synthetic = syntheticPartials;
+            fastRelease.position = currentPosition;
+            fastRelease.pitchRatio = pitchRatio;
+            fastRelease.gain = level * volume * getEnvelopeGain();
+            fastRelease.step = fastRelease.gain / (float) getFastReleaseSamples();
+            
+            // 读取器交给快速释放，之后的音符使用另一个
+            if (fastRelease.sample != nullptr)
+                noteReader = noteReader == &readers[0] ? &readers[1] : &readers[0];
+        }
         clearCurrentNote();
         isPlaying = false;
+        currentLevel = fastRelease.gain;
+    }
+}
+
+float PianoVoice::getEnvelopeGain() const
+{
+    float envGain = tailOff > 0.0f ? tailOff : 1.0f;
+    
+    if (noteReader->hasSource())
+    {
+        if (currentPosition < startPosition + attackLength)
+            envGain *= (float) ((currentPosition - startPosition) / attackLength);
+    }
+    else
+    {
+        // 与合成音色回退的包络一致（该路径下包络覆盖 tailOff）
+        const double attackTime = getSampleRate() * 0.01;
+        const double decayTime = getSampleRate() * 2.0;
+        if (currentPosition < attackTime)
+            envGain = (float) (currentPosition / attackTime);
+        else
+            envGain = juce::jmax(0.3f, 1.0f - (float) ((currentPosition - attackTime) / decayTime));
+    }
+    
+    return envGain;
+}
+
+float PianoVoice::getRemainingPeak() const
+{
+    if (amplitudeEnvelope == nullptr || amplitudeEnvelope->empty())
+        return 1.0f;
+    
+    const size_t block = (size_t) currentPosition / (size_t) PianoSound::ENVELOPE_BLOCK;
+    return block < amplitudeEnvelope->size() ? (*amplitudeEnvelope)[block] : 0.0f;
+}
+
+void PianoVoice::renderFastRelease(juce::AudioBuffer<float>& outputBuffer, int startSample, int numSamples)
+{
+    auto& r = fastRelease;
+    const int outChans = outputBuffer.getNumChannels();
+    
+    if (r.sample == nullptr)
+    {
+        // 合成音色回退：接管的分音状态按块渲染后线性淡出
+        while (numSamples > 0 && r.gain > 0.0f)
+        {
+            const int chunk = juce::jmin(numSamples, PartialOscillator::CHUNK_SIZE);
+            r.synthetic.render(scratch, chunk);
+            for (int i = 0; i < chunk; ++i)
+            {
+                scratch[i] *= juce::jmax(0.0f, r.gain);
+                r.gain -= r.step;
+            }
+            for (int ch = 0; ch < outChans; ++ch)
+                outputBuffer.addFrom(ch, startSample, scratch, chunk);
+            
+            startSample += chunk;
+            numSamples -= chunk;
+        }
+        r.gain = juce::jmax(0.0f, r.gain);
+        return;
+    }
+    
+    int readableEnd = -1;
+    while (--numSamples >= 0 && r.gain > 0.0f)
+    {
+        const int idx = (int) r.position;
+        if (idx + 1 > readableEnd)
+            readableEnd = r.sample->prepare(idx, idx + 1 + (int) ((numSamples + 1) * r.pitchRatio));
+        if (idx + 1 > readableEnd)
+        {
+            r.gain = 0.0f;
+            break;
+        }
+        const float frac = (float) (r.position - (double) idx);
+        const float s0L = r.sample->getSample(0, idx);
+        float sampleL = s0L + frac * (r.sample->getSample(0, idx + 1) - s0L);
+        float sampleR = sampleL;
+        if (r.sample->getNumChannels() > 1)
+        {
+            const float s0R = r.sample->getSample(1, idx);
+            sampleR = s0R + frac * (r.sample->getSample(1, idx + 1) - s0R);
+        }
+        r.position += r.pitchRatio;
+        
+        sampleL *= r.gain;
+        sampleR *= r.gain;
+        if (outChans > 0)
+            outputBuffer.addSample(0, startSample, sampleL);
+        if (outChans > 1)
+            outputBuffer.addSample(1, startSample, sampleR);
+        for (int ch = 2; ch < outChans; ++ch)
+            outputBuffer.addSample(ch, startSample, 0.5f * (sampleL + sampleR));
+        
+        r.gain -= r.step;
+        ++startSample;
     }
+    
+    r.gain = juce::jmax(0.0f, r.gain);
 }
 
 void PianoVoice::renderNextBlock(juce::AudioBuffer<float>& outputBuffer, int startSample, int numSamples)
 {
+    if (fastRelease.gain > 0.0f)
+        renderFastRelease(outputBuffer, startSample, numSamples);
+    
     if (!isVoiceActive() || !isPlaying)
+    {
+        currentLevel = fastRelease.gain;
         return;
+    }
+    
+    if (!noteReader->hasSource())
+    {
+        renderSynthetic(outputBuffer, startSample, numSamples);
+        return;
+    }
     
     auto localLevel = level * volume;
     
+    // 样本剩余部分的峰值乘以当前增益已低于可闻下限：之后的输出都听不见，直接结束（tailOff 只会继续减小）
+    if (getRemainingPeak() * localLevel * (tailOff > 0.0f ? tailOff : 1.0f) < getAudibilityFloor())
+    {
+        clearCurrentNote();
+        isPlaying = false;
+        currentLevel = 0.0f;
+        return;
+    }
+    
+    auto& reader = *noteReader;
+    int readableEnd = -1;   // 已 prepare 的最后一帧，读取位置越过时再解码下一段
     while (--numSamples >= 0)
     {
         float envGain = 1.0f;
@@ -94,79 +256,45 @@ void PianoVoice::renderNextBlock(juce::AudioBuffer<float>& outputBuffer, int sta
             }
         }
         
+        // 使用 SFZ 样本（带线性插值 + 立体声）
         float sampleL = 0.0f;
         float sampleR = 0.0f;
-
-        if (currentSample != nullptr)
+        int idx = (int) currentPosition;
+        if (idx + 1 > readableEnd)
+            readableEnd = reader.prepare(idx, idx + 1 + (int) ((numSamples + 1) * pitchRatio));
+        if (idx + 1 <= readableEnd)
         {
-            // 使用 SFZ 样本（带线性插值 + 立体声）
-            const int totalSamples = currentSample->getNumSamples();
-            int idx = (int) currentPosition;
-            if (idx + 1 < totalSamples)
+            float frac = (float) (currentPosition - (double) idx);
+            // 左声道
+            float s0L = reader.getSample(0, idx);
+            float s1L = reader.getSample(0, idx + 1);
+            sampleL = s0L + frac * (s1L - s0L);
+            // 右声道（若无则复用左声道）
+            if (reader.getNumChannels() > 1)
             {
-                float frac = (float) (currentPosition - (double) idx);
-                // 左声道
-                float s0L = currentSample->getSample(0, idx);
-                float s1L = currentSample->getSample(0, idx + 1);
-                sampleL = s0L + frac * (s1L - s0L);
-                // 右声道（若无则复用左声道）
-                if (currentSample->getNumChannels() > 1)
-                {
-                    float s0R = currentSample->getSample(1, idx);
-                    float s1R = currentSample->getSample(1, idx + 1);
-                    sampleR = s0R + frac * (s1R - s0R);
-                }
-                else
-                {
-                    sampleR = sampleL;
-                }
-                // 简单攻击避免起始点击（5ms 渐入）
-                const double attackSamples = getSampleRate() * 0.005;
-                if (currentPosition < attackSamples)
-                {
-                    float attackGain = (float) (currentPosition / attackSamples);
-                    envGain *= attackGain;
-                }
-                sampleL *= (localLevel * envGain);
-                sampleR *= (localLevel * envGain);
-                currentPosition += pitchRatio;
+                float s0R = reader.getSample(1, idx);
+                float s1R = reader.getSample(1, idx + 1);
+                sampleR = s0R + frac * (s1R - s0R);
             }
             else
             {
-                clearCurrentNote();
-                isPlaying = false;
-                break;
+                sampleR = sampleL;
+            }
+            // 预卷段渐入避免起始点击，到达起音时增益为 1
+            if (currentPosition < startPosition + attackLength)
+            {
+                float attackGain = (float) ((currentPosition - startPosition) / attackLength);
+                envGain *= attackGain;
             }
+            sampleL *= (localLevel * envGain);
+            sampleR *= (localLevel * envGain);
+            currentPosition += pitchRatio;
         }
         else
         {
-            // 合成音色回退
-            float attackTime = getSampleRate() * 0.01f;
-            float decayTime = getSampleRate() * 2.0f;
-            
-            if (currentPosition < attackTime)
-            {
-                envGain = (float)currentPosition / attackTime;
-            }
-            else
-            {
-                float decay = 1.0f - ((float)(currentPosition - attackTime) / decayTime);
-                envGain = juce::jmax(0.3f, decay);
-            }
-            
-            float osc = 0.0f;
-            osc += std::sin(currentPosition * pitchRatio) * 0.6f;
-            osc += std::sin(currentPosition * pitchRatio * 2.0) * 0.3f;
-            osc += std::sin(currentPosition * pitchRatio * 3.0) * 0.15f;
-            osc *= localLevel * envGain;
-            sampleL = sampleR = osc;
-            
-            currentPosition += 1.0;
-            
-            if (tailOff == 0.0f && currentPosition > getSampleRate() * 5.0)
-            {
-                tailOff = 1.0f;
-            }
+            clearCurrentNote();
+            isPlaying = false;
+            break;
         }
         
         // 写入输出（立体声优先，多通道则复制左右）
@@ -180,6 +308,65 @@ void PianoVoice::renderNextBlock(juce::AudioBuffer<float>& outputBuffer, int sta
         
         ++startSample;
     }
+    
+    // 样本自身会衰减：按包络预估接下来的输出峰值（不受起音前渐入的影响）
+    currentLevel = isPlaying ? getRemainingPeak() * localLevel * (tailOff > 0.0f ? tailOff : 1.0f) : 0.0f;
+}
+
+void PianoVoice::renderSynthetic(juce::AudioBuffer<float>& outputBuffer, int startSample, int numSamples)
+{
+    // 合成音色回退：分音按块生成，包络逐样本叠加（该路径下包络覆盖 tailOff）
+    const float localLevel = level * volume;
+    const double attackTime = getSampleRate() * 0.01;
+    const double decayTime = getSampleRate() * 2.0;
+    const int outChans = outputBuffer.getNumChannels();
+    float blockPeak = 0.0f;
+    
+    while (numSamples > 0 && isPlaying)
+    {
+        const int chunk = juce::jmin(numSamples, PartialOscillator::CHUNK_SIZE);
+        syntheticPartials.render(scratch, chunk);
+        
+        int rendered = chunk;
+        for (int i = 0; i < chunk; ++i)
+        {
+            if (tailOff > 0.0f)
+            {
+                tailOff *= 0.998f;
+                if (tailOff < 0.01f)
+                {
+                    clearCurrentNote();
+                    isPlaying = false;
+                    rendered = i;
+                    break;
+                }
+            }
+            
+            const float envGain = currentPosition < attackTime
+                                    ? (float) (currentPosition / attackTime)
+                                    : juce::jmax(0.3f, 1.0f - (float) ((currentPosition - attackTime) / decayTime));
+            scratch[i] *= localLevel * envGain;
+            currentPosition += 1.0;
+            
+            if (tailOff == 0.0f && currentPosition > getSampleRate() * 5.0)
+                tailOff = 1.0f;
+        }
+        
+        for (int ch = 0; ch < outChans; ++ch)
+            outputBuffer.addFrom(ch, startSample, scratch, rendered);
+        
+        if (rendered > 0)
+        {
+            const auto range = juce::FloatVectorOperations::findMinAndMax(scratch, rendered);
+            blockPeak = juce::jmax(blockPeak, -range.getStart(), range.getEnd());
+        }
+        
+        startSample += chunk;
+        numSamples -= chunk;
+    }
+    
+    // 起音渐入期间按目标电平报告
+    currentLevel = isPlaying ? (currentPosition <= attackTime ? localLevel : blockPeak) : 0.0f;
 }
 
 void PianoVoice::pitchWheelMoved(int)
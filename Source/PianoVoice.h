@@ -2,8 +2,11 @@
 #include <juce_audio_basics/juce_audio_basics.h>
 #include <juce_core/juce_core.h>
 #include "PianoSound.h"
+#include "EarxVoice.h"
+#include "PartialOscillator.h"
+#include "SampleReader.h"
 
-class PianoVoice : public juce::SynthesiserVoice
+class PianoVoice : public EarxVoice
 {
 public:
     PianoVoice();
@@ -15,17 +18,46 @@ public:
     void pitchWheelMoved(int newPitchWheelValue) override;
     void controllerMoved(int controllerNumber, int newControllerValue) override;
     
-    void setVolume(float newVolume) { volume = newVolume; }
+    void setVolume(float newVolume) override { volume = newVolume; }
+    float getCurrentLevel() const override { return currentLevel; }
     
 private:
-    juce::AudioBuffer<float>* currentSample = nullptr;
+    float getEnvelopeGain() const;
+    float getRemainingPeak() const;
+    void renderFastRelease(juce::AudioBuffer<float>& outputBuffer, int startSample, int numSamples);
+    void renderSynthetic(juce::AudioBuffer<float>& outputBuffer, int startSample, int numSamples);
+    
+
+    // 两个读取器轮流使用：硬停止时快速释放接管当前读取器（连同已解码的窗口），新音符用另一个
+    SampleReader readers[2];
+    SampleReader* noteReader = &readers[0];  // 没有样本（合成音色回退）时 hasSource() 为 false
     double currentPosition = 0.0;
+    double startPosition = 0.0;     // 样本中的播放起点（region 的起音预卷位置）
+    double attackLength = 1.0;      // 起点到起音的样本数，渐入在此期间完成
+    const std::vector<float>* amplitudeEnvelope = nullptr;  // region 的剩余峰值包络（PianoSound 持有）
     double pitchRatio = 1.0;
     double frequency = 440.0;
     float level = 0.0f;
     float tailOff = 0.0f;
     float volume = 0.2f;
     bool isPlaying = false;
+    float currentLevel = 0.0f;
+    
+    // 没有 SFZ 样本时的合成音色回退：三个谐波的加法合成
+    PartialOscillator syntheticPartials;
+    float scratch[PartialOscillator::CHUNK_SIZE] = {};
+    
+    // 硬停止 / 被抢占时保留的旧音符状态，线性淡出 FAST_RELEASE_MS
+    struct FastRelease
+    {
+        SampleReader* sample = nullptr;     // 为空时按合成音色回退渲染
+        PartialOscillator synthetic;
+        double position = 0.0;
+        double pitchRatio = 1.0;
+        float gain = 0.0f;
+        float step = 0.0f;
+    };
+    FastRelease fastRelease;
     
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PianoVoice)
 }; 
\ No newline at end of file
@@ -2,6 +2,12 @@
 #include "AppState.h"
 #include "AudioController.h"
 
+namespace
+{
+    // 当前线程正在发出“正在播放的音符”通知（自动播放时在音频线程），监听回调据此跳过参数比较与记录
+    thread_local bool notifyingPlayingNote = false;
+}
+
 // 音符名称常量定义 - 现在通过 AppState 动态获取
 const char* PlaybackEngine::NOTE_NAMES[12] = {
     "C", "C#/Db", "D", "D#/Eb", "E", "F", "F#/Gb",
@@ -9,8 +15,13 @@ const char* PlaybackEngine::NOTE_NAMES[12] = {
 };
 
 PlaybackEngine::PlaybackEngine(AppState* state, AudioController* audio)
-    : appState(state), audioController(audio)
+    : appState(state), audioController(audio), exerciseEngine(audio)
 {
+    // 未指定种子时使用基于时间的种子，行为与之前的系统随机一致
+    const uint64_t seed = SessionRandom::createSeedFromTime();
+    random.setSeed(seed);
+    currentSeed = seed;
+    
     appState->addListener(this);
     DBG("PlaybackEngine initialized");
 }
@@ -32,54 +43,15 @@ void PlaybackEngine::playNextNote(const juce::Array<int>& onIndices)
     if (onIndices.isEmpty())
         return;
     
-    int semitone = selectNextNote(onIndices);
+    applyPendingSeed();
+    
+    int octaveIndex = -1;
+    int semitone = selectNextNote(onIndices, octaveIndex);
     if (semitone == -1)
         return;
     
-    // 智能八度选择：避免重复相同的音符
-    int baseOctave;
-    
-    if (onIndices.size() == 1)
-    {
-        // 只有一个音符激活时，通过不同八度来制造变化
-        int availableOctaves[] = {4, 5, 6};
-        int numOctaves = 3;
-        
-        // 如果上一个音符存在且是相同半音，选择不同的八度
-        if (appState->playback.lastSemitone == semitone && 
-            appState->playback.lastMidiNote != -1)
-        {
-            int lastOctave = appState->playback.lastMidiNote / 12;
-            
-            // 从可用八度中排除上一个八度
-            juce::Array<int> differentOctaves;
-            for (int i = 0; i < numOctaves; ++i)
-            {
-                if (availableOctaves[i] != lastOctave)
-                    differentOctaves.add(availableOctaves[i]);
-            }
-            
-            if (!differentOctaves.isEmpty())
-            {
-                baseOctave = differentOctaves[juce::Random::getSystemRandom().nextInt(differentOctaves.size())];
-            }
-            else
-            {
-                baseOctave = availableOctaves[juce::Random::getSystemRandom().nextInt(numOctaves)];
-            }
-        }
-        else
-        {
-            // 第一次播放或不同半音，随机选择八度
-            baseOctave = availableOctaves[juce::Random::getSystemRandom().nextInt(numOctaves)];
-        }
-    }
-    else
-    {
-        // 有多个音符激活时，随机选择八度（因为音符本身已经不同了）
-        int availableOctaves[] = {4, 5, 6};
-        baseOctave = availableOctaves[juce::Random::getSystemRandom().nextInt(3)];
-    }
+    int baseOctave = octaveIndex >= 0 ? MIN_OCTAVE + octaveIndex
+                                      : selectOctave(semitone, onIndices.size());
     
     int note = baseOctave * 12 + semitone;
     
@@ -90,22 +62,29 @@ void PlaybackEngine::playNextNote(const juce::Array<int>& onIndices)
     // 设置播放状态
     setCurrentPlayingNote(semitone);
     
-    // 播放音符
-    audioController->playNote(note, 0.8f);
-    
     // 计算音符持续时间
     double durationMs = (60000.0 / appState->playback.bpm) *
                         (appState->playback.noteDuration / 100.0);
     double endTime = juce::Time::getMillisecondCounterHiRes() + durationMs;
     
-    // 添加到活跃音符列表
+    // 播放音符（练习模式下以该音为根音播放音程 / 和弦），并以音频时钟上的起始样本记录题目
+    const bool isExercise = appState->playback.exerciseMode != 0;
+    const auto onsetSample = isExercise ? playExercise(note, durationMs)
+                                        : audioController->playNote(note, 0.8f);
+    answerScorer.noteStarted(note, onsetSample);
+    sessionLog.logNoteOn(note, semitone, appState->playback.bpm, juce::Time::getMillisecondCounterHiRes(), onsetSample);
+    
+    // 添加到活跃音符列表（练习的音符已按样本安排好松开，这里只负责显示）
     AppState::PlaybackState::ActiveNote activeNote;
-    activeNote.note = note;
+    activeNote.note = isExercise ? -1 : note;
     activeNote.semitone = semitone;
     activeNote.endTime = endTime;
     appState->playback.activeNotes.add(activeNote);
     
-    appState->notifyPlaybackStateChanged();
+    {
+        const juce::ScopedValueSetter<bool> playingNote(notifyingPlayingNote, true);
+        appState->notifyPlaybackStateChanged();
+    }
     
     // 使用选择的音名进行调试输出
     juce::String selectedNoteNames = appState->getSelectedNoteNamesDisplayForSemitone(semitone);
@@ -137,7 +116,8 @@ void PlaybackEngine::updateActiveNotes(double currentTime)
         if (currentTime >= activeNote.endTime)
         {
             // 音符结束，停止播放
-            stopNote(activeNote.note);
+            if (activeNote.note >= 0)
+                stopNote(activeNote.note);
             clearCurrentPlayingNote(activeNote.semitone);
             appState->playback.activeNotes.remove(i);
         }
@@ -185,10 +165,205 @@ void PlaybackEngine::setNoteDuration(float duration)
     appState->notifyPlaybackStateChanged();
 }
 
+void PlaybackEngine::setExerciseMode(int mode)
+{
+    mode = juce::jlimit(0, 3, mode);
+    if (mode != 0)
+        audioController->ensurePolyphony(ExerciseEngine::REQUIRED_POLYPHONY);
+    
+    appState->playback.exerciseMode = mode;
+    appState->notifyPlaybackStateChanged();
+}
+
+void PlaybackEngine::setExerciseStyle(int style)
+{
+    appState->playback.exerciseStyle = juce::jlimit(0, 2, style);
+    appState->notifyPlaybackStateChanged();
+}
+
+juce::int64 PlaybackEngine::playExercise(int rootNote, double durationMs)
+{
+    const auto style = (ExerciseEngine::Style) juce::jlimit(0, 2, appState->playback.exerciseStyle);
+    
+    ExerciseEngine::Exercise exercise;
+    switch (appState->playback.exerciseMode)
+    {
+        case 1:
+            exercise = exerciseEngine.createRandomInterval(rootNote, style, random);
+            break;
+        case 2:
+            exercise = exerciseEngine.createRandomChord(rootNote, 0, ExerciseEngine::NUM_TRIAD_TYPES, style, random);
+            break;
+        default:
+            exercise = exerciseEngine.createRandomChord(rootNote, ExerciseEngine::NUM_TRIAD_TYPES,
+                                                        ExerciseEngine::NUM_CHORD_TYPES, style, random);
+            break;
+    }
+    
+    // 和声方式：同时发声并持续整个时值；旋律方式：在时值内依次发声
+    const bool harmonic = style == ExerciseEngine::harmonic;
+    const double spacingMs = harmonic ? 0.0 : durationMs / exercise.numNotes;
+    const double lengthMs = harmonic ? durationMs : spacingMs;
+    
+    return exerciseEngine.play(exercise, spacingMs, lengthMs, 0.8f);
+}
+
+void PlaybackEngine::setRandomSeed(uint64_t seed)
+{
+    pendingSeed = seed;
+    currentSeed = seed;
+    seedPending = true;
+}
+
+void PlaybackEngine::applyPendingSeed()
+{
+    if (!seedPending.exchange(false))
+        return;
+    
+    random.setSeed(pendingSeed.load());
+    
+    // 新种子代表新会话：清除上一个音符，保证同一种子得到同一序列
+    appState->playback.lastMidiNote = -1;
+    appState->playback.lastSemitone = -1;
+    
+    DBG("Session random seed set: " + juce::String((juce::int64) random.getSeed()));
+}
+
+bool PlaybackEngine::reportAnswerResult(int midiNote, bool correct)
+{
+    const int octaveIndex = midiNote / 12 - MIN_OCTAVE;
+    if (midiNote < 0 || octaveIndex < 0 || octaveIndex >= NUM_OCTAVES)
+        return false;
+    
+    noteSelector.recordResult(midiNote % 12, octaveIndex, correct);
+    return true;
+}
+
+void PlaybackEngine::resetNoteStatistics()
+{
+    noteSelector.resetStatistics();
+}
+
+bool PlaybackEngine::submitAnswer(int semitone, double answerHostMs, AnswerScorer::Result& result)
+{
+    if (!answerScorer.submitAnswer(semitone, answerHostMs, *audioController, result))
+        return false;
+    
+    reportAnswerResult(result.midiNote, result.correct);
+    sessionLog.logAnswer(result.midiNote, result.expectedSemitone, result.answeredSemitone, result.correct,
+                         (float) result.reactionMs, appState->playback.bpm, answerHostMs);
+    return true;
+}
+
+bool PlaybackEngine::startSessionLog(const juce::File& directory)
+{
+    if (!sessionLog.startSession(directory, getRandomSeed(), audioController->getSampleRate()))
+        return false;
+    
+    // 新日志以当前全部参数开头，之后只记录变化
+    {
+        const juce::SpinLock::ScopedLockType sl(loggedParametersLock);
+        loggedParameters = LoggedParameters();
+    }
+    logParameterChanges();
+    return true;
+}
+
+void PlaybackEngine::stopSessionLog()
+{
+    sessionLog.stopSession();
+}
+
+void PlaybackEngine::logParameterChanges()
+{
+    if (!sessionLog.isActive())
+        return;
+    
+    // 多个线程的通知可能同时到达：比较与更新在同一把锁内完成，每次变化只记录一次
+    const juce::SpinLock::ScopedLockType sl(loggedParametersLock);
+    const double bpm = appState->playback.bpm;
+    const double now = juce::Time::getMillisecondCounterHiRes();
+    auto& logged = loggedParameters;
+    
+    if (logged.bpm != bpm)
+    {
+        logged.bpm = bpm;
+        sessionLog.logParameterChange(SessionLog::parameterBpm, (float) bpm, bpm, now);
+    }
+    if (logged.noteDuration != appState->playback.noteDuration)
+    {
+        logged.noteDuration = appState->playback.noteDuration;
+        sessionLog.logParameterChange(SessionLog::parameterNoteDuration, logged.noteDuration, bpm, now);
+    }
+    if (logged.masterVolume != appState->audio.masterVolume)
+    {
+        logged.masterVolume = appState->audio.masterVolume;
+        sessionLog.logParameterChange(SessionLog::parameterMasterVolume, logged.masterVolume, bpm, now);
+    }
+    
+    const int timbre = (int) appState->audio.timbre;
+    if (logged.timbre != timbre)
+    {
+        logged.timbre = timbre;
+        sessionLog.logParameterChange(SessionLog::parameterTimbre, (float) timbre, bpm, now);
+    }
+    
+    const int mask = getActiveNoteMask();
+    if (logged.semitoneMask != mask)
+    {
+        logged.semitoneMask = mask;
+        sessionLog.logParameterChange(SessionLog::parameterSemitoneMask, (float) mask, bpm, now);
+    }
+    
+    const int centerTone = appState->interaction.longPressedButtonIndex;
+    if (logged.centerTone != centerTone)
+    {
+        logged.centerTone = centerTone;
+        sessionLog.logParameterChange(SessionLog::parameterCenterTone, (float) centerTone, bpm, now);
+    }
+    
+    const int autoPlay = appState->playback.autoPlayEnabled ? 1 : 0;
+    if (logged.autoPlay != autoPlay)
+    {
+        logged.autoPlay = autoPlay;
+        sessionLog.logParameterChange(SessionLog::parameterAutoPlay, (float) autoPlay, bpm, now);
+    }
+    
+    if (logged.exerciseMode != appState->playback.exerciseMode)
+    {
+        logged.exerciseMode = appState->playback.exerciseMode;
+        sessionLog.logParameterChange(SessionLog::parameterExerciseMode, (float) logged.exerciseMode, bpm, now);
+    }
+    if (logged.exerciseStyle != appState->playback.exerciseStyle)
+    {
+        logged.exerciseStyle = appState->playback.exerciseStyle;
+        sessionLog.logParameterChange(SessionLog::parameterExerciseStyle, (float) logged.exerciseStyle, bpm, now);
+    }
+}
+
 void PlaybackEngine::playbackStateChanged()
 {
+    if (notifyingPlayingNote)
+        return;
+    
     DBG("Playback state changed - BPM: " + juce::String(appState->playback.bpm) + 
         ", Duration: " + juce::String(appState->playback.noteDuration) + "%");
+    logParameterChanges();
+}
+
+void PlaybackEngine::interactionStateChanged()
+{
+    // 激活半音变化时在通知线程中重建采样表；掩码未变时为空操作
+    noteSelector.setActiveMask(getActiveNoteMask());
+    
+    // 正在播放的音符由音频线程更新，不涉及记录的参数，不在音频线程上比较与记录
+    if (!notifyingPlayingNote)
+        logParameterChanges();
+}
+
+void PlaybackEngine::audioStateChanged()
+{
+    logParameterChanges();
 }
 
 juce::Array<int> PlaybackEngine::getActiveNoteIndices()
@@ -206,7 +381,19 @@ juce::Array<int> PlaybackEngine::getActiveNoteIndices()
     return onIndices;
 }
 
-int PlaybackEngine::selectNextNote(const juce::Array<int>& onIndices)
+uint16_t PlaybackEngine::getActiveNoteMask() const
+{
+    uint16_t mask = 0;
+    for (int i = 0; i < 12; ++i)
+    {
+        if (i < appState->interaction.customSemitones.size() &&
+            appState->interaction.customSemitones[i])
+            mask |= (uint16_t) (1 << i);
+    }
+    return mask;
+}
+
+int PlaybackEngine::selectNextNote(const juce::Array<int>& onIndices, int& octaveIndex)
 {
     if (onIndices.isEmpty())
         return -1;
@@ -223,12 +410,31 @@ int PlaybackEngine::selectNextNote(const juce::Array<int>& onIndices)
     }
     else
     {
-        // 播放随机音，避免重复
-        do
+        // 播放随机音，避免重复：按自适应权重同时选出半音与八度（排除上一个半音）
+        const int numCandidates = onIndices.size();
+        const int lastIndex = onIndices.indexOf(appState->playback.lastSemitone);
+        
+        uint16_t mask = 0;
+        for (int index : onIndices)
+            mask |= (uint16_t) (1 << index);
+        
+        if (numCandidates > 1 &&
+            noteSelector.selectCell(mask, appState->playback.lastSemitone, random, semitone, octaveIndex))
+        {
+            // 已由采样表选出
+        }
+        // 采样表暂不可用时退回均匀随机：在去掉上一个半音后的 n-1 个候选中直接取值（O(1)，无拒绝循环）
+        else if (numCandidates > 1 && lastIndex >= 0)
+        {
+            int pick = random.nextInt(numCandidates - 1);
+            if (pick >= lastIndex)
+                ++pick;
+            semitone = onIndices[pick];
+        }
+        else
         {
-            semitone = onIndices[juce::Random::getSystemRandom().nextInt(onIndices.size())];
+            semitone = onIndices[random.nextInt(numCandidates)];
         }
-        while (semitone == appState->playback.lastSemitone && onIndices.size() > 1);
         
         // 如果有中心音，下次播放中心音
         if (appState->interaction.longPressedButtonIndex != -1)
@@ -240,9 +446,41 @@ int PlaybackEngine::selectNextNote(const juce::Array<int>& onIndices)
     return semitone;
 }
 
+int PlaybackEngine::selectOctave(int semitone, int numActive)
+{
+    // 只有一个音符激活且与上一个半音相同时，通过不同八度来制造变化
+    int lastOctave = -1;
+    if (numActive == 1 &&
+        appState->playback.lastSemitone == semitone &&
+        appState->playback.lastMidiNote != -1)
+    {
+        const int octave = appState->playback.lastMidiNote / 12;
+        if (octave >= MIN_OCTAVE && octave < MIN_OCTAVE + NUM_OCTAVES)
+            lastOctave = octave;
+    }
+    
+    // 按该半音各八度的自适应权重选择
+    const int weighted = noteSelector.selectOctave(semitone, lastOctave >= 0 ? lastOctave - MIN_OCTAVE : -1, random);
+    if (weighted >= 0)
+        return MIN_OCTAVE + weighted;
+    
+    if (lastOctave >= 0)
+    {
+        // 从其余两个八度中直接取值
+        int octave = MIN_OCTAVE + random.nextInt(NUM_OCTAVES - 1);
+        if (octave >= lastOctave)
+            ++octave;
+        return octave;
+    }
+    
+    // 第一次播放、不同半音或多个音符激活时，随机选择八度
+    return MIN_OCTAVE + random.nextInt(NUM_OCTAVES);
+}
+
 void PlaybackEngine::setCurrentPlayingNote(int semitone)
 {
     appState->interaction.currentPlayingButtonIndex = semitone;
+    const juce::ScopedValueSetter<bool> playingNote(notifyingPlayingNote, true);
     appState->notifyInteractionStateChanged();
 }
 
@@ -251,6 +489,7 @@ void PlaybackEngine::clearCurrentPlayingNote(int semitone)
     if (appState->interaction.currentPlayingButtonIndex == semitone)
     {
         appState->interaction.currentPlayingButtonIndex = -1;
+        const juce::ScopedValueSetter<bool> playingNote(notifyingPlayingNote, true);
         appState->notifyInteractionStateChanged();
     }
 } 
\ No newline at end of file
@@ -2,6 +2,12 @@
 #include <juce_core/juce_core.h>
 #include <juce_gui_basics/juce_gui_basics.h>
 #include "AppState.h"  // 完整包含而不是前向声明
+#include "SessionRandom.h"
+#include "AdaptiveNoteSelector.h"
+#include "AnswerScorer.h"
+#include "SessionLog.h"
+#include "ExerciseEngine.h"
+#include <atomic>
 
 class AudioController;
 
@@ -16,6 +22,10 @@ class AudioController;
 class PlaybackEngine : public AppState::Listener
 {
 public:
+    // 可选八度范围（4-6）
+    static constexpr int MIN_OCTAVE = 4;
+    static constexpr int NUM_OCTAVES = 3;
+    
     PlaybackEngine(AppState* appState, AudioController* audioController);
     virtual ~PlaybackEngine() override;
     
@@ -33,8 +43,37 @@ public:
     void setBPM(double bpm);
     void setNoteDuration(float duration);
     
+    // 练习模式（0=单音, 1=音程, 2=三和弦, 3=七和弦）与播放方式（ExerciseEngine::Style）
+    // 非单音模式会提高复音数，不在音频线程调用
+    void setExerciseMode(int mode);
+    void setExerciseStyle(int style);
+    ExerciseEngine& getExerciseEngine() { return exerciseEngine; }
+    
+    // 会话随机种子：设置后从新会话开始（清除上一个音符记录），同一种子与设置可复现同一组练习
+    // 可在任意线程调用，新种子在下一次出题时生效
+    void setRandomSeed(uint64_t seed);
+    uint64_t getRandomSeed() const { return currentSeed.load(); }
+    
+    // 自适应出题：上报答题结果（midiNote 为所出的音），答错的音之后出现得更频繁
+    // 不在音频线程调用；统计与权重通过 getNoteSelector() 查询
+    bool reportAnswerResult(int midiNote, bool correct);
+    void resetNoteStatistics();
+    const AdaptiveNoteSelector& getNoteSelector() const { return noteSelector; }
+    
+    // 作答：对最近一次出题的音符评分（反应时间以音符被听到的时刻为起点），结果同时计入自适应统计
+    // answerHostMs 使用 juce::Time::getMillisecondCounterHiRes() 时基；没有待作答题目时返回 false
+    bool submitAnswer(int semitone, double answerHostMs, AnswerScorer::Result& result);
+    AnswerScorer& getAnswerScorer() { return answerScorer; }
+    
+    // 会话日志：每次开始都会在 directory 中新建一个日志文件，并清空会话统计
+    bool startSessionLog(const juce::File& directory);
+    void stopSessionLog();
+    const SessionLog& getSessionLog() const { return sessionLog; }
+    
     // AppState::Listener 实现
     virtual void playbackStateChanged() override;
+    virtual void interactionStateChanged() override;
+    virtual void audioStateChanged() override;
     
 private:
     AppState* appState;
@@ -43,9 +82,47 @@ private:
     // 音符名称常量
     static const char* NOTE_NAMES[12];
     
+    // 会话随机数：仅在出题线程中访问，跨线程设置的种子经 pendingSeed 传递
+    SessionRandom random;
+    std::atomic<uint64_t> currentSeed { 0 };
+    std::atomic<uint64_t> pendingSeed { 0 };
+    std::atomic<bool> seedPending { false };
+    
+    // 半音 x 八度的加权采样表（激活半音变化时在通知线程中重建）
+    AdaptiveNoteSelector noteSelector;
+    static_assert(NUM_OCTAVES == AdaptiveNoteSelector::NUM_OCTAVES, "octave range mismatch");
+    
+    // 音程 / 和弦练习
+    ExerciseEngine exerciseEngine;
+    
+    // 作答评分（题目起始时刻取自音频时钟）
+    AnswerScorer answerScorer;
+    
+    // 会话日志与已记录的参数值（参数变化时追加记录）；比较与记录在 loggedParametersLock 内进行，
+    // 只由 FFI / 消息线程的状态通知触发，音频线程更新正在播放的音符时不记录
+    SessionLog sessionLog;
+    juce::SpinLock loggedParametersLock;
+    struct LoggedParameters
+    {
+        double bpm = -1.0;
+        float noteDuration = -1.0f;
+        float masterVolume = -1.0f;
+        int timbre = -1;
+        int semitoneMask = -1;
+        int centerTone = -2;
+        int autoPlay = -1;
+        int exerciseMode = -1;
+        int exerciseStyle = -1;
+    } loggedParameters;
+    
     // 辅助方法
     juce::Array<int> getActiveNoteIndices();
-    int selectNextNote(const juce::Array<int>& onIndices);
+    uint16_t getActiveNoteMask() const;
+    int selectNextNote(const juce::Array<int>& onIndices, int& octaveIndex);
+    int selectOctave(int semitone, int numActive);
+    void applyPendingSeed();
+    juce::int64 playExercise(int rootNote, double durationMs);
+    void logParameterChanges();
     void setCurrentPlayingNote(int semitone);
     void clearCurrentPlayingNote(int semitone);
     
@@ -0,0 +1,159 @@
+#include "RoomConvolution.h"
+#include <juce_audio_formats/juce_audio_formats.h>
+
+namespace
+{
+    constexpr double kDefaultLengthSeconds = 0.7;
+    constexpr double kDefaultDecaySeconds = 0.5;     // 内置脉冲响应衰减 60 dB 的时间
+    constexpr double kPreDelaySeconds = 0.005;
+    constexpr double kCostSmoothing = 0.05;          // 耗时统计的指数滑动平均系数
+}
+
+RoomConvolution::RoomConvolution()
+{
+    wetLevel.setCurrentAndTargetValue(0.0f);
+}
+
+void RoomConvolution::prepare(double sampleRate, int numChannels)
+{
+    currentSampleRate = sampleRate;
+    const int channels = juce::jlimit(1, 2, numChannels);
+    wetBuffer.setSize(channels, MAX_BLOCK_SIZE);
+    gainRamp.allocate((size_t) MAX_BLOCK_SIZE, true);
+
+    convolution.prepare({ sampleRate, (juce::uint32) MAX_BLOCK_SIZE, (juce::uint32) channels });
+    wetLevel.reset(sampleRate, WET_SMOOTHING_SECONDS);
+    wetLevel.setCurrentAndTargetValue(targetWetLevel.load());
+    active = false;
+
+    // 内置脉冲响应只生成一次；已加载外部脉冲响应时由 Convolution 按新采样率重新处理
+    if (!defaultLoaded)
+    {
+        convolution.loadImpulseResponse(createDefaultImpulseResponse(sampleRate), sampleRate,
+                                        juce::dsp::Convolution::Stereo::yes,
+                                        juce::dsp::Convolution::Trim::no,
+                                        juce::dsp::Convolution::Normalise::yes);
+        defaultLoaded = true;
+    }
+}
+
+juce::AudioBuffer<float> RoomConvolution::createDefaultImpulseResponse(double sampleRate)
+{
+    // 小房间：几次离散早期反射 + 指数衰减的低通噪声尾音，左右声道噪声不相关
+    const int length = (int) (kDefaultLengthSeconds * sampleRate);
+    const int preDelay = (int) (kPreDelaySeconds * sampleRate);
+    juce::AudioBuffer<float> ir(2, length);
+    ir.clear();
+
+    const double decayPerSample = std::pow(0.001, 1.0 / (kDefaultDecaySeconds * sampleRate));
+    const float reflectionMs[] = { 7.0f, 11.0f, 17.0f, 23.0f, 31.0f };
+    const float reflectionGain[] = { 0.7f, 0.55f, 0.45f, 0.35f, 0.3f };
+
+    for (int ch = 0; ch < 2; ++ch)
+    {
+        juce::Random random(0x5eed + ch);
+        auto* data = ir.getWritePointer(ch);
+
+        double envelope = 1.0;
+        float state = 0.0f;
+        for (int i = preDelay; i < length; ++i)
+        {
+            state += 0.35f * (random.nextFloat() * 2.0f - 1.0f - state);
+            data[i] = state * (float) envelope * 0.5f;
+            envelope *= decayPerSample;
+        }
+
+        for (int r = 0; r < (int) std::size(reflectionMs); ++r)
+        {
+            // 左右声道的反射时刻略有错开，增加空间感
+            const int index = preDelay + (int) ((reflectionMs[r] + (ch == 0 ? 0.0f : 1.3f)) * 0.001 * sampleRate);
+            if (index < length)
+                data[index] += (r % 2 == 0 ? 1.0f : -1.0f) * reflectionGain[r];
+        }
+    }
+
+    return ir;
+}
+
+void RoomConvolution::setWetLevel(float level)
+{
+    targetWetLevel.store(juce::jlimit(0.0f, 1.0f, level));
+}
+
+bool RoomConvolution::loadImpulseResponse(const juce::File& file)
+{
+    if (!file.existsAsFile())
+        return false;
+
+    juce::AudioFormatManager formatManager;
+    formatManager.registerBasicFormats();
+    std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(file));
+    if (reader == nullptr || reader->lengthInSamples <= 0)
+    {
+        DBG("RoomConvolution: unreadable impulse response " + file.getFullPathName());
+        return false;
+    }
+    reader.reset();
+
+    // 读取、重采样与分区都在 Convolution 的后台线程完成，准备好后在音频线程交叉淡化切换
+    convolution.loadImpulseResponse(file, juce::dsp::Convolution::Stereo::yes,
+                                    juce::dsp::Convolution::Trim::yes, 0,
+                                    juce::dsp::Convolution::Normalise::yes);
+    DBG("RoomConvolution: loading impulse response " + file.getFileName());
+    return true;
+}
+
+int RoomConvolution::getTailSamples() const
+{
+    return active ? convolution.getCurrentIRSize() : 0;
+}
+
+void RoomConvolution::process(juce::AudioBuffer<float>& buffer, int startSample, int numSamples)
+{
+    wetLevel.setTargetValue(targetWetLevel.load(std::memory_order_relaxed));
+    if (!wetLevel.isSmoothing() && wetLevel.getCurrentValue() <= 0.0f)
+    {
+        // 湿声为 0：整级旁路；重新启用时先清空旧的卷积状态，不会放出过时的尾音
+        active = false;
+        cpuLoad.store(0.0, std::memory_order_relaxed);
+        return;
+    }
+    if (!active)
+    {
+        convolution.reset();
+        active = true;
+    }
+
+    const auto startTicks = juce::Time::getHighResolutionTicks();
+    const int numChannels = juce::jmin(buffer.getNumChannels(), wetBuffer.getNumChannels());
+
+    for (int offset = 0; offset < numSamples; offset += MAX_BLOCK_SIZE)
+    {
+        const int count = juce::jmin(MAX_BLOCK_SIZE, numSamples - offset);
+        for (int ch = 0; ch < numChannels; ++ch)
+            wetBuffer.copyFrom(ch, 0, buffer, ch, startSample + offset, count);
+
+        juce::dsp::AudioBlock<float> block(wetBuffer.getArrayOfWritePointers(), (size_t) numChannels, (size_t) count);
+        convolution.process(juce::dsp::ProcessContextReplacing<float>(block));
+
+        if (wetLevel.isSmoothing())
+        {
+            for (int i = 0; i < count; ++i)
+                gainRamp[i] = wetLevel.getNextValue();
+            for (int ch = 0; ch < numChannels; ++ch)
+                juce::FloatVectorOperations::addWithMultiply(buffer.getWritePointer(ch, startSample + offset),
+                                                             wetBuffer.getReadPointer(ch), gainRamp.get(), count);
+        }
+        else
+        {
+            const float gain = wetLevel.getCurrentValue();
+            for (int ch = 0; ch < numChannels; ++ch)
+                buffer.addFrom(ch, startSample + offset, wetBuffer, ch, 0, count, gain);
+        }
+    }
+
+    const double seconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks);
+    const double load = seconds * currentSampleRate / juce::jmax(1, numSamples);
+    const double previous = cpuLoad.load(std::memory_order_relaxed);
+    cpuLoad.store(previous <= 0.0 ? load : previous + kCostSmoothing * (load - previous), std::memory_order_relaxed);
+}
@@ -0,0 +1,62 @@
+#pragma once
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_dsp/juce_dsp.h>
+
+/**
+ * 房间 / 氛围卷积 - 主总线上可选的卷积混响级
+ * 职责：
+ * - 以 juce::dsp::Convolution 的非均匀分区模式（首段 HEAD_SIZE 样本直接卷积，其余分区逐级加长）做零延迟卷积
+ * - 脉冲响应在 Convolution 自带的后台线程中加载并重采样到当前采样率，新旧脉冲响应在音频线程交叉淡化切换
+ * - 湿声电平逐样本平滑；电平为 0 且平滑结束后整级旁路，不做任何卷积运算
+ * - 统计每块的卷积耗时（占实时预算的比例），供调用方决定是否在当前设备上启用
+ *
+ * 未加载外部脉冲响应时使用内置的小房间脉冲响应（prepare 时生成，可复现）。
+ * process 与 prepare 需与渲染串行调用（AudioController 以 synthMutex 保护）；
+ * setWetLevel、loadImpulseResponse 与统计查询可在任意非音频线程调用。
+ */
+class RoomConvolution
+{
+public:
+    static constexpr int HEAD_SIZE = 256;           // 非均匀分区的首段长度
+    static constexpr int MAX_BLOCK_SIZE = 512;      // 内部处理块，湿声缓冲区按此预分配
+    static constexpr double WET_SMOOTHING_SECONDS = 0.05;
+
+    RoomConvolution();
+
+    // 分配缓冲区并生成内置脉冲响应（不在音频线程调用）
+    void prepare(double sampleRate, int numChannels);
+
+    // 湿声电平 0 - 1，在下一个渲染块开始时生效
+    void setWetLevel(float level);
+    float getWetLevel() const { return targetWetLevel.load(); }
+
+    // 单声道或立体声 WAV/AIFF；文件无法读取时返回 false，成功时在后台完成加载后无缝切换
+    bool loadImpulseResponse(const juce::File& file);
+
+    // 把湿声叠加到 buffer 上（干声保持不变）
+    void process(juce::AudioBuffer<float>& buffer, int startSample, int numSamples);
+
+    // 当前是否在做卷积运算（旁路时为 false）
+    bool isActive() const { return active; }
+
+    // 停止输入后尾音还会持续的样本数（旁路时为 0）
+    int getTailSamples() const;
+
+    // 卷积耗时占实时预算的比例（指数滑动平均，旁路时为 0）
+    double getCpuLoad() const { return cpuLoad.load(std::memory_order_relaxed); }
+
+private:
+    static juce::AudioBuffer<float> createDefaultImpulseResponse(double sampleRate);
+
+    juce::dsp::Convolution convolution { juce::dsp::Convolution::NonUniform { HEAD_SIZE } };
+    juce::AudioBuffer<float> wetBuffer;
+    juce::HeapBlock<float> gainRamp;
+    juce::SmoothedValue<float> wetLevel { 0.0f };
+    std::atomic<float> targetWetLevel { 0.0f };
+    double currentSampleRate = 0.0;
+    bool defaultLoaded = false;
+    bool active = false;
+    std::atomic<double> cpuLoad { 0.0 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(RoomConvolution)
+};
@@ -0,0 +1,51 @@
+#include "SampleReader.h"
+
+void SampleReader::setSource(const juce::AudioBuffer<float>* samples, const CompressedSample* compressedSample)
+{
+    compressed = nullptr;
+    numChannels = 0;
+    numFrames = 0;
+    frameMask = -1;
+    decodedFirst = decodedEnd = 0;
+
+    if (samples != nullptr && samples->getNumChannels() > 0)
+    {
+        numChannels = juce::jmin((int) MAX_CHANNELS, samples->getNumChannels());
+        numFrames = samples->getNumSamples();
+        for (int ch = 0; ch < MAX_CHANNELS; ++ch)
+            channels[ch] = samples->getReadPointer(juce::jmin(ch, numChannels - 1));
+    }
+    else if (compressedSample != nullptr && compressedSample->getNumChannels() > 0)
+    {
+        compressed = compressedSample;
+        numChannels = juce::jmin((int) MAX_CHANNELS, compressedSample->getNumChannels());
+        numFrames = compressedSample->getNumFrames();
+        frameMask = WINDOW_FRAMES - 1;
+        for (int ch = 0; ch < MAX_CHANNELS; ++ch)
+            channels[ch] = window[juce::jmin(ch, numChannels - 1)];
+    }
+}
+
+int SampleReader::prepare(int firstFrame, int lastFrame)
+{
+    if (compressed == nullptr)
+        return numFrames - 1;
+
+    constexpr int blockFrames = CompressedSample::BLOCK_FRAMES;
+    const int firstBlock = juce::jmax(0, firstFrame) / blockFrames;
+    const int endBlock = juce::jmin(juce::jmax(firstFrame + 1, lastFrame) / blockFrames + 1,
+                                    firstBlock + WINDOW_BLOCKS, compressed->getNumBlocks());
+
+    // 已解码且仍在窗口内的块保留，只解码新进入窗口的块（窗口内各块占用不同的槽位）
+    const bool contiguous = firstBlock >= decodedFirst && firstBlock <= decodedEnd;
+    for (int block = contiguous ? decodedEnd : firstBlock; block < endBlock; ++block)
+    {
+        const int slot = (block % WINDOW_BLOCKS) * blockFrames;
+        for (int ch = 0; ch < numChannels; ++ch)
+            compressed->decodeBlock(ch, block, window[ch] + slot);
+    }
+
+    decodedFirst = firstBlock;
+    decodedEnd = contiguous ? juce::jmax(decodedEnd, endBlock) : endBlock;
+    return juce::jmin(decodedEnd * blockFrames, numFrames) - 1;
+}
@@ -0,0 +1,44 @@
+#pragma once
+#include <juce_audio_basics/juce_audio_basics.h>
+#include "CompressedSample.h"
+
+/**
+ * Voice 读取样本的窗口 - 让 PianoVoice 以同一种方式读浮点样本与压缩样本
+ * - 浮点样本：直接读 AudioBuffer，整个样本都可读
+ * - 压缩样本：按需把读取位置之后的块解码进 Voice 自有的小环形缓冲区（WINDOW_BLOCKS 块），
+ *   每块只解码一次；帧号与缓冲区下标的换算只是一次按位与
+ * 调用方先用 prepare 取得可读范围，再用 getSample 读取；不分配内存，可在音频线程使用。
+ */
+class SampleReader
+{
+public:
+    static constexpr int MAX_CHANNELS = 2;
+    static constexpr int WINDOW_BLOCKS = 4;
+    static constexpr int WINDOW_FRAMES = WINDOW_BLOCKS * CompressedSample::BLOCK_FRAMES;
+    static_assert((WINDOW_FRAMES & (WINDOW_FRAMES - 1)) == 0, "window must be a power of two");
+
+    // 读取 samples（浮点）或 compressed（压缩）其中之一；两者都为空时没有可读的样本
+    void setSource(const juce::AudioBuffer<float>* samples, const CompressedSample* compressed);
+
+    bool hasSource() const { return numFrames > 0; }
+    int getNumChannels() const { return numChannels; }
+    int getNumFrames() const { return numFrames; }
+
+    // 使 [firstFrame, lastFrame] 尽量可读（压缩样本受窗口容量限制），返回可读的最后一帧（不小于 firstFrame + 1，
+    // 样本结尾除外）。读取位置只能前进
+    int prepare(int firstFrame, int lastFrame);
+
+    // 读取已 prepare 的帧
+    float getSample(int channel, int frame) const { return channels[channel][frame & frameMask]; }
+
+private:
+    const CompressedSample* compressed = nullptr;
+    const float* channels[MAX_CHANNELS] = {};
+    int numChannels = 0;
+    int numFrames = 0;
+    int frameMask = -1;         // 浮点样本为全 1（帧号即下标），压缩样本为 WINDOW_FRAMES - 1
+    int decodedFirst = 0;       // 已解码的块范围 [decodedFirst, decodedEnd)
+    int decodedEnd = 0;
+
+    float window[MAX_CHANNELS][WINDOW_FRAMES] = {};
+};
@@ -0,0 +1,259 @@
+#include "SessionLog.h"
+
+SessionLog::SessionLog()
+    : juce::Thread("EarxSessionLog")
+{
+}
+
+SessionLog::~SessionLog()
+{
+    stopSession();
+}
+
+bool SessionLog::startSession(const juce::File& directory, uint64_t seed, double sampleRate)
+{
+    // 轮换：先结束上一个会话，写完残留记录
+    stopSession();
+
+    if (!directory.createDirectory())
+    {
+        DBG("SessionLog: could not create directory " + directory.getFullPathName());
+        return false;
+    }
+
+    auto now = juce::Time::getCurrentTime();
+    auto file = directory.getNonexistentChildFile("session_" + now.formatted("%Y%m%d_%H%M%S"), ".earxlog", false);
+
+    auto newStream = std::make_unique<juce::FileOutputStream>(file);
+    if (newStream->failedToOpen())
+    {
+        DBG("SessionLog: could not open " + file.getFullPathName());
+        return false;
+    }
+
+    FileHeader header {};
+    std::memcpy(header.magic, "EARXLOG", 8);
+    header.version = FORMAT_VERSION;
+    header.recordSize = (uint32_t) sizeof(Record);
+    header.seed = seed;
+    header.startTimeMs = now.toMilliseconds();
+    header.sampleRate = sampleRate;
+    newStream->write(&header, sizeof(header));
+
+    {
+        const juce::ScopedLock sl(fileLock);
+        stream = std::move(newStream);
+        currentFile = file;
+    }
+
+    resetStatistics();
+    {
+        const juce::SpinLock::ScopedLockType pl(pushLock);
+        fifo.reset();
+    }
+    recordsWritten = 0;
+    recordsDropped = 0;
+    active = true;
+
+    Record record {};
+    record.type = sessionStart;
+    record.semitone = -1;
+    record.answer = -1;
+    record.midiNote = -1;
+    record.timeMs = juce::Time::getMillisecondCounterHiRes();
+    record.audioSample = -1;
+    push(record);
+
+    startThread();
+    DBG("SessionLog: started " + file.getFullPathName());
+    return true;
+}
+
+void SessionLog::stopSession()
+{
+    if (!active.exchange(false))
+        return;
+
+    signalThreadShouldExit();
+    notify();
+    stopThread(2000);
+
+    // 写线程已退出，在此写完剩余记录
+    drainFifo();
+
+    const juce::ScopedLock sl(fileLock);
+    if (stream != nullptr)
+        stream->flush();
+    stream.reset();
+
+    DBG("SessionLog: stopped after " + juce::String(recordsWritten.load()) + " records ("
+        + juce::String(recordsDropped.load()) + " dropped)");
+}
+
+juce::File SessionLog::getCurrentFile() const
+{
+    const juce::ScopedLock sl(fileLock);
+    return currentFile;
+}
+
+void SessionLog::logNoteOn(int midiNote, int semitone, double bpm, double timeMs, juce::int64 onsetSample)
+{
+    if (!active.load())
+        return;
+
+    Record record {};
+    record.type = noteOn;
+    record.semitone = (int8_t) semitone;
+    record.answer = -1;
+    record.midiNote = (int16_t) midiNote;
+    record.bpm = (int16_t) juce::roundToInt(bpm);
+    record.timeMs = timeMs;
+    record.audioSample = onsetSample;
+    push(record);
+}
+
+void SessionLog::logParameterChange(ParameterId parameter, float value, double bpm, double timeMs)
+{
+    if (!active.load())
+        return;
+
+    Record record {};
+    record.type = parameterChange;
+    record.semitone = -1;
+    record.answer = (int8_t) parameter;
+    record.midiNote = -1;
+    record.bpm = (int16_t) juce::roundToInt(bpm);
+    record.timeMs = timeMs;
+    record.audioSample = -1;
+    record.value = value;
+    push(record);
+}
+
+void SessionLog::logAnswer(int midiNote, int expectedSemitone, int answeredSemitone, bool correct,
+                           float reactionMs, double bpm, double timeMs)
+{
+    if (!active.load())
+        return;
+
+    Record record {};
+    record.type = answer;
+    record.semitone = (int8_t) expectedSemitone;
+    record.answer = (int8_t) answeredSemitone;
+    record.flags = correct ? 1 : 0;
+    record.midiNote = (int16_t) midiNote;
+    record.bpm = (int16_t) juce::roundToInt(bpm);
+    record.timeMs = timeMs;
+    record.audioSample = -1;
+    record.value = reactionMs;
+    push(record);
+
+    if (expectedSemitone < 0 || expectedSemitone >= 12 || answeredSemitone < 0 || answeredSemitone >= 12)
+        return;
+
+    const juce::ScopedLock sl(statsLock);
+
+    auto& semitone = semitonePerformance[expectedSemitone];
+    semitone.attempts++;
+    semitone.correct += correct ? 1 : 0;
+    semitone.totalReactionMs += reactionMs;
+
+    confusion[expectedSemitone][answeredSemitone]++;
+
+    auto& tempo = bpmPerformance[getBpmBucket(bpm)];
+    tempo.attempts++;
+    tempo.correct += correct ? 1 : 0;
+    tempo.totalReactionMs += reactionMs;
+}
+
+SessionLog::Performance SessionLog::getSemitonePerformance(int semitone) const
+{
+    if (semitone < 0 || semitone >= 12)
+        return {};
+
+    const juce::ScopedLock sl(statsLock);
+    return semitonePerformance[semitone];
+}
+
+int SessionLog::getConfusionCount(int expectedSemitone, int answeredSemitone) const
+{
+    if (expectedSemitone < 0 || expectedSemitone >= 12 || answeredSemitone < 0 || answeredSemitone >= 12)
+        return 0;
+
+    const juce::ScopedLock sl(statsLock);
+    return confusion[expectedSemitone][answeredSemitone];
+}
+
+SessionLog::Performance SessionLog::getBpmPerformance(double bpm) const
+{
+    const juce::ScopedLock sl(statsLock);
+    return bpmPerformance[getBpmBucket(bpm)];
+}
+
+void SessionLog::push(const Record& record)
+{
+    const juce::SpinLock::ScopedLockType sl(pushLock);
+
+    const auto scope = fifo.write(1);
+    if (scope.blockSize1 + scope.blockSize2 == 0)
+    {
+        recordsDropped++;
+        return;
+    }
+
+    fifoBuffer[scope.blockSize1 > 0 ? scope.startIndex1 : scope.startIndex2] = record;
+}
+
+void SessionLog::run()
+{
+    while (!threadShouldExit())
+    {
+        wait(100);
+        drainFifo();
+    }
+}
+
+void SessionLog::drainFifo()
+{
+    const juce::ScopedLock sl(fileLock);
+    if (stream == nullptr)
+        return;
+
+    bool wroteAny = false;
+    for (;;)
+    {
+        const int numReady = juce::jmin(fifo.getNumReady(), (int) std::size(writeBuffer));
+        if (numReady == 0)
+            break;
+
+        const auto scope = fifo.read(numReady);
+        if (scope.blockSize1 > 0)
+            std::copy(fifoBuffer + scope.startIndex1, fifoBuffer + scope.startIndex1 + scope.blockSize1, writeBuffer);
+        if (scope.blockSize2 > 0)
+            std::copy(fifoBuffer + scope.startIndex2, fifoBuffer + scope.startIndex2 + scope.blockSize2,
+                      writeBuffer + scope.blockSize1);
+
+        stream->write(writeBuffer, (size_t) numReady * sizeof(Record));
+        recordsWritten += numReady;
+        wroteAny = true;
+    }
+
+    if (wroteAny)
+        stream->flush();
+}
+
+void SessionLog::resetStatistics()
+{
+    const juce::ScopedLock sl(statsLock);
+    for (auto& p : semitonePerformance)
+        p = Performance();
+    for (auto& row : confusion)
+        for (auto& count : row)
+            count = 0;
+    for (auto& p : bpmPerformance)
+        p = Performance();
+}
+
+int SessionLog::getBpmBucket(double bpm)
+{
+    return juce::jlimit(0, NUM_BPM_BUCKETS - 1, (int) ((bpm - MIN_BPM) / BPM_BUCKET_SIZE));
+}
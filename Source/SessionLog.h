@@ -0,0 +1,142 @@
+#pragma once
+#include <juce_core/juce_core.h>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+/**
+ * 训练会话日志 - 紧凑的二进制追加日志 + 增量统计
+ * 职责：
+ * - 记录会话中的每个出题音符、作答、反应时间与参数变化
+ * - 定长记录写入环形 FIFO，由后台线程追加到文件，音频线程不做文件 I/O
+ * - 每个会话一个文件（startSession 时轮换），文件布局为 64 字节文件头 + N 条 32 字节记录，可直接内存映射
+ * - 作答时增量维护统计（每个半音的正确率、混淆矩阵、各 BPM 的表现），查询为 O(1)
+ *
+ * 文件格式（小端）：
+ *   FileHeader  magic "EARXLOG", version, recordSize, seed, 开始时间（Unix 毫秒）, 采样率
+ *   Record[]    记录数 = (文件大小 - sizeof(FileHeader)) / sizeof(Record)
+ */
+class SessionLog : private juce::Thread
+{
+public:
+    enum RecordType : uint8_t
+    {
+        sessionStart = 0,
+        noteOn = 1,
+        answer = 2,
+        parameterChange = 3
+    };
+
+    enum ParameterId : int8_t
+    {
+        parameterBpm = 0,
+        parameterNoteDuration = 1,
+        parameterMasterVolume = 2,
+        parameterTimbre = 3,        // AppState::Timbre（0=正弦波, 1=钢琴, 2-5=波表）
+        parameterSemitoneMask = 4,  // bit i 对应半音 i
+        parameterCenterTone = 5,    // -1 表示无中心音
+        parameterAutoPlay = 6,
+        parameterExerciseMode = 7,  // 0=单音, 1=音程, 2=三和弦, 3=七和弦
+        parameterExerciseStyle = 8  // 0=和声, 1=旋律上行, 2=旋律下行
+    };
+
+    struct FileHeader
+    {
+        char magic[8];
+        uint32_t version;
+        uint32_t recordSize;
+        uint64_t seed;
+        int64_t startTimeMs;
+        double sampleRate;
+        uint8_t reserved[24];
+    };
+
+    struct Record
+    {
+        uint8_t type;
+        int8_t semitone;        // 出题 / 期望的半音
+        int8_t answer;          // 作答的半音；参数变化时为 ParameterId
+        uint8_t flags;          // bit0: 作答正确
+        int16_t midiNote;
+        int16_t bpm;            // 记录时的 BPM
+        double timeMs;          // 引擎时钟（juce::Time::getMillisecondCounterHiRes）
+        int64_t audioSample;    // 音符在音频时钟上的起始样本
+        float value;            // 反应时间（毫秒）或参数值
+        uint32_t reserved;
+    };
+
+    static_assert(sizeof(FileHeader) == 64, "FileHeader must stay 64 bytes");
+    static_assert(sizeof(Record) == 32, "Record must stay 32 bytes");
+
+    static constexpr uint32_t FORMAT_VERSION = 1;
+    static constexpr int FIFO_CAPACITY = 4096;
+
+    // BPM 统计分桶：20-200 BPM，每 10 BPM 一档
+    static constexpr int MIN_BPM = 20;
+    static constexpr int BPM_BUCKET_SIZE = 10;
+    static constexpr int NUM_BPM_BUCKETS = (200 - MIN_BPM) / BPM_BUCKET_SIZE + 1;
+
+    struct Performance
+    {
+        int attempts = 0;
+        int correct = 0;
+        double totalReactionMs = 0.0;
+
+        double getAccuracy() const { return attempts > 0 ? (double) correct / attempts : 0.0; }
+        double getMeanReactionMs() const { return attempts > 0 ? totalReactionMs / attempts : 0.0; }
+    };
+
+    SessionLog();
+    ~SessionLog() override;
+
+    // 会话管理（不在音频线程调用）：开始新会话会关闭上一个文件并清空统计
+    bool startSession(const juce::File& directory, uint64_t seed, double sampleRate);
+    void stopSession();
+    bool isActive() const { return active.load(); }
+    juce::File getCurrentFile() const;
+
+    // 记录（音频线程安全：只写入 FIFO，FIFO 满时丢弃并计数）
+    void logNoteOn(int midiNote, int semitone, double bpm, double timeMs, juce::int64 onsetSample);
+    void logParameterChange(ParameterId parameter, float value, double bpm, double timeMs);
+
+    // 作答记录，同时增量更新统计（不在音频线程调用）
+    void logAnswer(int midiNote, int expectedSemitone, int answeredSemitone, bool correct,
+                   float reactionMs, double bpm, double timeMs);
+
+    // O(1) 统计查询
+    Performance getSemitonePerformance(int semitone) const;
+    int getConfusionCount(int expectedSemitone, int answeredSemitone) const;
+    Performance getBpmPerformance(double bpm) const;
+    juce::int64 getNumRecordsWritten() const { return recordsWritten.load(); }
+    juce::int64 getNumRecordsDropped() const { return recordsDropped.load(); }
+
+private:
+    void run() override;
+    void push(const Record& record);
+    void drainFifo();
+    void resetStatistics();
+    static int getBpmBucket(double bpm);
+
+    std::atomic<bool> active { false };
+
+    // 多个线程写入 FIFO，以 SpinLock 串行化（临界区仅为一次 32 字节拷贝）
+    juce::AbstractFifo fifo { FIFO_CAPACITY };
+    Record fifoBuffer[FIFO_CAPACITY];
+    juce::SpinLock pushLock;
+
+    // 文件与写线程
+    juce::CriticalSection fileLock;
+    std::unique_ptr<juce::FileOutputStream> stream;
+    juce::File currentFile;
+    Record writeBuffer[256];
+    std::atomic<juce::int64> recordsWritten { 0 };
+    std::atomic<juce::int64> recordsDropped { 0 };
+
+    // 增量统计
+    mutable juce::CriticalSection statsLock;
+    Performance semitonePerformance[12];
+    int confusion[12][12] = {};
+    Performance bpmPerformance[NUM_BPM_BUCKETS];
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SessionLog)
+};
@@ -0,0 +1,74 @@
+#include "SessionRandom.h"
+#include <juce_core/juce_core.h>
+
+namespace
+{
+    inline uint64_t rotl(uint64_t x, int k)
+    {
+        return (x << k) | (x >> (64 - k));
+    }
+    
+    // splitmix64：将任意种子（包括 0）扩展为 xoshiro 的 256 位状态
+    inline uint64_t splitMix64(uint64_t& x)
+    {
+        uint64_t z = (x += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+}
+
+SessionRandom::SessionRandom(uint64_t initialSeed)
+{
+    setSeed(initialSeed);
+}
+
+void SessionRandom::setSeed(uint64_t newSeed)
+{
+    seed = newSeed;
+    uint64_t x = newSeed;
+    for (auto& s : state)
+        s = splitMix64(x);
+}
+
+uint64_t SessionRandom::nextUInt64()
+{
+    const uint64_t result = rotl(state[1] * 5, 7) * 9;
+    const uint64_t t = state[1] << 17;
+    
+    state[2] ^= state[0];
+    state[3] ^= state[1];
+    state[1] ^= state[2];
+    state[0] ^= state[3];
+    state[2] ^= t;
+    state[3] = rotl(state[3], 45);
+    
+    return result;
+}
+
+int SessionRandom::nextInt(int maxExclusive)
+{
+    if (maxExclusive <= 0)
+        return 0;
+    
+    // 乘法映射（Lemire）：取高 32 位，对于出题所需的小范围偏差可忽略
+    const uint64_t r = nextUInt64() >> 32;
+    return (int) ((r * (uint64_t) maxExclusive) >> 32);
+}
+
+float SessionRandom::nextFloat()
+{
+    return (float) (nextUInt64() >> 40) * (1.0f / 16777216.0f);
+}
+
+double SessionRandom::nextDouble()
+{
+    return (double) (nextUInt64() >> 11) * (1.0 / 9007199254740992.0);
+}
+
+uint64_t SessionRandom::createSeedFromTime()
+{
+    uint64_t x = (uint64_t) juce::Time::getHighResolutionTicks()
+               ^ ((uint64_t) juce::Time::currentTimeMillis() << 20);
+    return splitMix64(x);
+}
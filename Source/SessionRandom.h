@@ -0,0 +1,36 @@
+#pragma once
+#include <cstdint>
+
+/**
+ * 会话随机数发生器（xoshiro256**）
+ * 职责：
+ * - 为出题提供可复现的随机序列（同一种子 => 同一组练习）
+ * - 不分配内存、不加锁，可在音频线程中使用
+ * - 整数取值为 O(1)，不使用拒绝采样
+ */
+class SessionRandom
+{
+public:
+    explicit SessionRandom(uint64_t seed = 0x9E3779B97F4A7C15ull);
+    
+    // 重新设置种子，序列从头开始
+    void setSeed(uint64_t newSeed);
+    uint64_t getSeed() const { return seed; }
+    
+    // 64 位原始输出
+    uint64_t nextUInt64();
+    
+    // [0, maxExclusive) 内的整数，maxExclusive <= 0 时返回 0
+    int nextInt(int maxExclusive);
+    
+    // [0, 1) 内的浮点数
+    float nextFloat();
+    double nextDouble();
+    
+    // 基于当前时间生成一个新的种子（未指定种子时使用）
+    static uint64_t createSeedFromTime();
+    
+private:
+    uint64_t seed = 0;
+    uint64_t state[4] = {};
+};
@@ -0,0 +1,27 @@
+#include "StringModelSound.h"
+
+StringModelSound::StringModelSound()
+{
+    // 参数随音高平滑变化：低音弦衰减长，高音弦衰减短、击弦点相对更靠近端点
+    for (int note = 0; note < 128; ++note)
+    {
+        const float t = juce::jlimit(0.0f, 1.0f, (float) (note - 21) / 87.0f);   // A0 = 0, C8 = 1
+        auto& p = parameters[note];
+        p.decaySeconds = 16.0f * std::pow(2.0f, -3.5f * t);                     // 16 s → 1.4 s
+        p.releaseSeconds = 0.3f - 0.2f * t;                                      // 0.3 s → 0.1 s
+        // 环路低通每个周期都作用一次，高音每秒经过的次数多，系数需按指数减小（0.5 → 0.03）
+        p.damping = 0.5f * std::pow(0.06f, t);
+        p.strikePosition = 0.125f - 0.06f * t;
+        p.brightness = 0.45f + 0.45f * t;
+    }
+}
+
+bool StringModelSound::appliesToNote(int)
+{
+    return enabled.load();
+}
+
+bool StringModelSound::appliesToChannel(int)
+{
+    return enabled.load();
+}
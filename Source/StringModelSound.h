@@ -0,0 +1,37 @@
+#pragma once
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_core/juce_core.h>
+
+/**
+ * 弦物理模型音色类（Karplus-Strong 波导）
+ * 职责：
+ * - 保存每个 MIDI 音符的弦参数表（衰减时间、止音时间、损耗滤波、击弦位置、激励亮度），构造时一次性生成
+ * - 不需要任何样本数据，作为低内存设备上采样钢琴的替代音色
+ */
+class StringModelSound : public juce::SynthesiserSound
+{
+public:
+    struct NoteParameters
+    {
+        float decaySeconds = 4.0f;      // 按住时衰减 60 dB 的时间
+        float releaseSeconds = 0.2f;    // 松开（制音器落下）后衰减 60 dB 的时间
+        float damping = 0.5f;           // 环路两点低通的系数（0 - 0.5，越大高频损耗越快）
+        float strikePosition = 0.125f;  // 击弦位置占弦长的比例（决定被抑制的谐波）
+        float brightness = 0.6f;        // 满力度时激励噪声低通的系数（0 - 1）
+    };
+
+    StringModelSound();
+
+    bool appliesToNote(int midiNoteNumber) override;
+    bool appliesToChannel(int midiChannelNumber) override;
+    void setEnabled(bool e) { enabled = e; }
+    bool isEnabled() const { return enabled; }
+
+    const NoteParameters& getParameters(int midiNote) const { return parameters[juce::jlimit(0, 127, midiNote)]; }
+
+private:
+    NoteParameters parameters[128];
+    std::atomic<bool> enabled { true };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(StringModelSound)
+};
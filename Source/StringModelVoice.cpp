@@ -0,0 +1,177 @@
+#include "StringModelVoice.h"
+
+namespace
+{
+    constexpr float kSilenceThreshold = 1.0e-4f;   // 连续一个周期低于此值（约 -80 dB）时音符结束
+}
+
+bool StringModelVoice::canPlaySound(juce::SynthesiserSound* sound)
+{
+    return dynamic_cast<StringModelSound*>(sound) != nullptr;
+}
+
+void StringModelVoice::setCurrentPlaybackSampleRate(double newRate)
+{
+    EarxVoice::setCurrentPlaybackSampleRate(newRate);
+    if (newRate <= 0.0)
+        return;
+
+    const int size = juce::nextPowerOfTwo((int) std::ceil(newRate / LOWEST_FREQUENCY) + 4);
+    for (auto* waveguide : { &active, &released })
+    {
+        waveguide->line.assign((size_t) size, 0.0f);
+        waveguide->mask = size - 1;
+        waveguide->writeIndex = 0;
+    }
+    releaseGain = 0.0f;
+}
+
+float StringModelVoice::Waveguide::tick()
+{
+    // 两点低通（线性相位，延迟 damping 个样本）+ 一阶全通（小数延迟）+ 环路增益
+    const float x0 = line[(size_t) ((writeIndex - delaySamples) & mask)];
+    const float x1 = line[(size_t) ((writeIndex - delaySamples - 1) & mask)];
+    const float filtered = x0 + damping * (x1 - x0);
+    const float y = allpassCoef * (filtered - allpassOut) + allpassIn;
+    allpassIn = filtered;
+    allpassOut = y;
+
+    const float out = y * loopGain;
+    line[(size_t) writeIndex] = out;
+    writeIndex = (writeIndex + 1) & mask;
+    return out;
+}
+
+void StringModelVoice::startNote(int midiNoteNumber, float velocity, juce::SynthesiserSound* sound, int)
+{
+    auto* stringSound = dynamic_cast<StringModelSound*>(sound);
+    if (stringSound == nullptr || active.line.empty())
+    {
+        DBG("Error: Sound is not StringModelSound type");
+        return;
+    }
+
+    const auto& params = stringSound->getParameters(midiNoteNumber);
+    const double sampleRate = getSampleRate();
+    const double frequency = juce::jmax(LOWEST_FREQUENCY, juce::MidiMessage::getMidiNoteInHertz(midiNoteNumber));
+
+    // 环路总延迟 = 一个周期：整数延迟 + 两点低通的 damping + 全通的小数延迟（保持在 0.1 - 1.1 之间调音最准）
+    const double period = sampleRate / frequency;
+    const double fractional = period - params.damping;
+    active.delaySamples = juce::jlimit(1, active.mask - 2, (int) std::floor(fractional - 0.1));
+    const double allpassDelay = fractional - active.delaySamples;
+    active.allpassCoef = (float) ((1.0 - allpassDelay) / (1.0 + allpassDelay));
+    active.allpassIn = active.allpassOut = 0.0f;
+    active.damping = params.damping;
+    active.loopGain = (float) std::pow(0.001, 1.0 / (params.decaySeconds * frequency));
+    releaseLoopGain = (float) std::pow(0.001, 1.0 / (params.releaseSeconds * frequency));
+
+    // 激励：一个周期的噪声脉冲（按音符固定种子，可复现），力度越大越亮，
+    // 再按击弦位置做梳状滤波，去掉直流并把峰值归一化到 1
+    std::fill(active.line.begin(), active.line.end(), 0.0f);
+    const int length = active.delaySamples;
+    float* excitation = active.line.data();
+
+    juce::Random random(midiNoteNumber);
+    const float lowpass = juce::jlimit(0.05f, 1.0f, params.brightness * (0.4f + 0.6f * velocity));
+    float state = 0.0f;
+    for (int i = 0; i < length; ++i)
+    {
+        state += lowpass * (random.nextFloat() * 2.0f - 1.0f - state);
+        excitation[i] = state;
+    }
+
+    const int strikeDelay = juce::jmax(1, juce::roundToInt(length * params.strikePosition));
+    for (int i = length - 1; i >= strikeDelay; --i)
+        excitation[i] -= excitation[i - strikeDelay];
+
+    float mean = 0.0f;
+    for (int i = 0; i < length; ++i)
+        mean += excitation[i];
+    mean /= (float) length;
+
+    float peak = 0.0f;
+    for (int i = 0; i < length; ++i)
+    {
+        excitation[i] -= mean;
+        peak = juce::jmax(peak, std::abs(excitation[i]));
+    }
+    if (peak > 0.0f)
+        juce::FloatVectorOperations::multiply(excitation, 1.0f / peak, length);
+
+    active.writeIndex = length & active.mask;
+    level = velocity * getLoudnessGain(midiNoteNumber);
+    silentSamples = 0;
+
+    // 激励峰值已归一化到 1：刚起音的 Voice 按目标电平报告，同一块内的后续音符不会把它当作最安静的抢走
+    currentLevel = level * volume;
+}
+
+void StringModelVoice::stopNote(float, bool allowTailOff)
+{
+    if (allowTailOff)
+    {
+        // 制音器落下：环路增益降到止音衰减，弦自然停振
+        active.loopGain = juce::jmin(active.loopGain, releaseLoopGain);
+    }
+    else
+    {
+        // 硬停止：整条波导交给淡出槽（只交换缓冲区，不复制），Voice 立即空出
+        if (isVoiceActive())
+        {
+            std::swap(active, released);
+            releaseGain = level * volume;
+            releaseStep = releaseGain / (float) getFastReleaseSamples();
+        }
+        clearCurrentNote();
+        currentLevel = releaseGain;
+    }
+}
+
+void StringModelVoice::renderNextBlock(juce::AudioBuffer<float>& outputBuffer, int startSample, int numSamples)
+{
+    const int outChans = outputBuffer.getNumChannels();
+
+    if (releaseGain > 0.0f)
+    {
+        for (int i = 0; i < numSamples && releaseGain > 0.0f; ++i)
+        {
+            const float sample = released.tick() * releaseGain;
+            for (int ch = 0; ch < outChans; ++ch)
+                outputBuffer.addSample(ch, startSample + i, sample);
+            releaseGain -= releaseStep;
+        }
+        releaseGain = juce::jmax(0.0f, releaseGain);
+    }
+
+    if (!isVoiceActive() || active.line.empty())
+    {
+        currentLevel = releaseGain;
+        return;
+    }
+
+    const float gain = level * volume;
+    float blockPeak = 0.0f;
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const float out = active.tick();
+        const float magnitude = std::abs(out);
+        blockPeak = juce::jmax(blockPeak, magnitude);
+        silentSamples = magnitude < kSilenceThreshold ? silentSamples + 1 : 0;
+
+        const float sample = out * gain;
+        for (int ch = 0; ch < outChans; ++ch)
+            outputBuffer.addSample(ch, startSample + i, sample);
+
+        // 整整一个周期都低于阈值：弦振动已衰减到听不到，结束音符
+        if (silentSamples > active.delaySamples)
+        {
+            clearCurrentNote();
+            currentLevel = releaseGain;
+            return;
+        }
+    }
+
+    currentLevel = blockPeak * gain;
+}
@@ -0,0 +1,64 @@
+#pragma once
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_core/juce_core.h>
+#include "StringModelSound.h"
+#include "EarxVoice.h"
+
+/**
+ * 弦物理模型 Voice：一条带损耗的数字波导（Karplus-Strong）
+ * - 起音时把按击弦位置梳状滤波的噪声脉冲写入延迟线，之后每样本只做一次读写、两点低通与一阶全通（调音）
+ * - 每 Voice 的开销固定（与音高无关），内存只有两条按最低音长度预分配的延迟线
+ */
+class StringModelVoice : public EarxVoice
+{
+public:
+    StringModelVoice() = default;
+
+    bool canPlaySound(juce::SynthesiserSound* sound) override;
+    void startNote(int midiNoteNumber, float velocity, juce::SynthesiserSound* sound, int currentPitchWheelPosition) override;
+    void stopNote(float velocity, bool allowTailOff) override;
+    void renderNextBlock(juce::AudioBuffer<float>& outputBuffer, int startSample, int numSamples) override;
+    void pitchWheelMoved(int) override {}
+    void controllerMoved(int, int) override {}
+
+    // 按采样率分配延迟线（addVoice 时调用，不在音频线程）
+    void setCurrentPlaybackSampleRate(double newRate) override;
+
+    void setVolume(float newVolume) override { volume = newVolume; }
+    float getCurrentLevel() const override { return currentLevel; }
+
+    // 每个 Voice 占用的延迟线内存（字节）
+    size_t getMemoryBytes() const { return (active.line.size() + released.line.size()) * sizeof(float); }
+
+private:
+    struct Waveguide
+    {
+        std::vector<float> line;    // 长度为 2 的幂，按 mask 回绕
+        int mask = 0;
+        int writeIndex = 0;
+        int delaySamples = 0;       // 环路延迟的整数部分
+        float damping = 0.5f;
+        float loopGain = 1.0f;
+        float allpassCoef = 0.0f;   // 一阶全通补足小数延迟
+        float allpassIn = 0.0f;
+        float allpassOut = 0.0f;
+
+        float tick();
+    };
+
+    // 延迟线能容纳的最低基频
+    static constexpr double LOWEST_FREQUENCY = 20.0;
+
+    Waveguide active;
+    Waveguide released;             // 被硬停止 / 抢占的旧音符，线性淡出 FAST_RELEASE_MS
+    float releaseGain = 0.0f;
+    float releaseStep = 0.0f;
+
+    float level = 0.0f;
+    float volume = 0.2f;
+    float releaseLoopGain = 1.0f;   // 松开后的环路增益
+    int silentSamples = 0;
+    float currentLevel = 0.0f;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(StringModelVoice)
+};
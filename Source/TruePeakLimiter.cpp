@@ -0,0 +1,213 @@
+#include "TruePeakLimiter.h"
+
+namespace
+{
+    constexpr int kHalfTaps = TruePeakLimiter::TAPS_PER_PHASE / 2;
+    constexpr int kDetectorDelay = kHalfTaps;          // 插值需要之后 kHalfTaps 个样本，检测比输入晚这么多
+    constexpr float kSilenceThreshold = 1.0e-7f;
+    constexpr float kUnityThreshold = 0.99999f;
+
+    // Kaiser 窗参数：每相 12 抽头时 Blackman 窗的通带高端下垂，高次谐波丰富的音色（锯齿波和弦）插值峰值
+    // 会被低估约 0.2 dB；beta = 3 的通带更平，代价是插值放大上界略增
+    constexpr double kKaiserBeta = 3.0;
+
+    double besselI0(double x)
+    {
+        // 零阶修正贝塞尔函数（级数展开，窗函数参数范围内收敛很快）
+        double sum = 1.0, term = 1.0;
+        for (int k = 1; k < 32 && term > 1.0e-12 * sum; ++k)
+        {
+            term *= (x * 0.5 / k) * (x * 0.5 / k);
+            sum += term;
+        }
+        return sum;
+    }
+}
+
+TruePeakLimiter::TruePeakLimiter()
+{
+    // 第 p 相插值位置 m + p / OVERSAMPLING：加 Kaiser 窗的 sinc，抽头 k = -(kHalfTaps - 1) .. kHalfTaps，
+    // 每相归一化到直流增益 1；第 0 相即原样本
+    for (int p = 0; p < OVERSAMPLING; ++p)
+    {
+        const double fraction = (double) p / OVERSAMPLING;
+        double sum = 0.0;
+        for (int i = 0; i < TAPS_PER_PHASE; ++i)
+        {
+            const double u = (double) (i - (kHalfTaps - 1)) - fraction;
+            const double sinc = u == 0.0 ? 1.0 : std::sin(juce::MathConstants<double>::pi * u) / (juce::MathConstants<double>::pi * u);
+            const double r = u / kHalfTaps;
+            const double w = r * r < 1.0 ? besselI0(kKaiserBeta * std::sqrt(1.0 - r * r)) / besselI0(kKaiserBeta) : 0.0;
+            phases[p][i] = (float) (sinc * w);
+            sum += sinc * w;
+        }
+        float absSum = 0.0f;
+        for (auto& c : phases[p])
+        {
+            c = (float) (c / sum);
+            absSum += std::abs(c);
+        }
+        interpolationBound = juce::jmax(interpolationBound, absSum);
+    }
+
+    ceiling = juce::Decibels::decibelsToGain(CEILING_DB);
+}
+
+void TruePeakLimiter::prepare(double sampleRate)
+{
+    currentSampleRate = sampleRate;
+    delayCapacity = (int) std::ceil(MAX_LOOKAHEAD_MS * 0.001 * sampleRate) + 1;
+    delayLine.setSize(MAX_CHANNELS, delayCapacity);
+    delayLine.clear();
+    minValues.assign((size_t) delayCapacity + 1, 1.0f);
+    minTimes.assign((size_t) delayCapacity + 1, 0);
+    averageRing.assign((size_t) delayCapacity, 1.0f);
+
+    for (auto& channel : history)
+        std::fill(std::begin(channel), std::end(channel), 0.0f);
+    historyIndex = 0;
+    delayWrite = 0;
+    sampleTime = 0;
+    releaseCoef = (float) (1.0 - std::exp(-1.0 / (RELEASE_SECONDS * sampleRate)));
+    silentSamples = 0;
+
+    applyLookahead(juce::roundToInt(lookaheadMs.load() * 0.001 * sampleRate));
+}
+
+void TruePeakLimiter::setLookahead(float milliseconds)
+{
+    lookaheadMs.store(juce::jlimit(MIN_LOOKAHEAD_MS, MAX_LOOKAHEAD_MS, milliseconds));
+}
+
+void TruePeakLimiter::applyLookahead(int samples)
+{
+    // 调用时延迟线已静音：重置增益流水线，窗口 = 延迟 - 检测延迟，峰值样本离开延迟线前增益已降到位
+    delaySamples = juce::jlimit(kDetectorDelay + 1, delayCapacity - 1, samples);
+    window = delaySamples - kDetectorDelay;
+    minHead = minCount = 0;
+    std::fill(averageRing.begin(), averageRing.end(), 1.0f);
+    averageIndex = 0;
+    averageSum = (double) window;
+    releaseGain = 1.0f;
+    latencySamples.store(delaySamples, std::memory_order_relaxed);
+}
+
+float TruePeakLimiter::detectPeak(int channel) const
+{
+    // history[channel] + historyIndex 起依次为最近 TAPS_PER_PHASE 个输入（旧 → 新），检测位置为第 kHalfTaps - 1 个
+    const float* x = history[channel] + historyIndex;
+    float peak = std::abs(x[kHalfTaps - 1]);
+    for (int p = 1; p < OVERSAMPLING; ++p)
+    {
+        float interpolated = 0.0f;
+        for (int i = 0; i < TAPS_PER_PHASE; ++i)
+            interpolated += phases[p][i] * x[i];
+        peak = juce::jmax(peak, std::abs(interpolated));
+    }
+    return peak;
+}
+
+float TruePeakLimiter::pushSlidingMin(float value)
+{
+    // 单调队列：队列中的值自前向后递增，队首即窗口（window + 1 个样本）内的最小值
+    const int capacity = (int) minValues.size();
+    while (minCount > 0 && minValues[(size_t) ((minHead + minCount - 1) % capacity)] >= value)
+        --minCount;
+
+    const int back = (minHead + minCount) % capacity;
+    minValues[(size_t) back] = value;
+    minTimes[(size_t) back] = sampleTime;
+    ++minCount;
+
+    while (minTimes[(size_t) minHead] < sampleTime - window)
+    {
+        minHead = (minHead + 1) % capacity;
+        --minCount;
+    }
+    return minValues[(size_t) minHead];
+}
+
+void TruePeakLimiter::process(juce::AudioBuffer<float>& buffer, int startSample, int numSamples)
+{
+    if (delayCapacity == 0)
+        return;
+
+    if (resetRequested.exchange(false))
+    {
+        maxReductionDb.store(0.0f, std::memory_order_relaxed);
+        limitedSamples.store(0, std::memory_order_relaxed);
+    }
+
+    const int numChannels = juce::jmin((int) MAX_CHANNELS, buffer.getNumChannels());
+
+    // 新的预读时长只在延迟线已静音时生效
+    const int requested = juce::jlimit(kDetectorDelay + 1, delayCapacity - 1,
+                                       juce::roundToInt(lookaheadMs.load(std::memory_order_relaxed) * 0.001 * currentSampleRate));
+    if (requested != delaySamples && silentSamples >= delayCapacity)
+        applyLookahead(requested);
+
+    float* channels[MAX_CHANNELS] = {};
+    for (int ch = 0; ch < numChannels; ++ch)
+        channels[ch] = buffer.getWritePointer(ch, startSample);
+
+    // 本块与上一块（插值历史）的采样峰值乘以插值的最大放大倍数仍低于上限时，本块不可能超限，跳过真峰值插值
+    float blockPeak = 0.0f;
+    for (int ch = 0; ch < numChannels; ++ch)
+        blockPeak = juce::jmax(blockPeak, buffer.getMagnitude(ch, startSample, numSamples));
+    const bool belowCeiling = juce::jmax(blockPeak, previousBlockPeak) * interpolationBound < ceiling;
+    previousBlockPeak = blockPeak;
+
+    float minGain = 1.0f;
+    int limited = 0;
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        float inputPeak = 0.0f;
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            const float x = channels[ch][i];
+            history[ch][historyIndex] = history[ch][historyIndex + TAPS_PER_PHASE] = x;
+            inputPeak = juce::jmax(inputPeak, std::abs(x));
+        }
+        historyIndex = (historyIndex + 1) % TAPS_PER_PHASE;
+        silentSamples = inputPeak < kSilenceThreshold ? juce::jmin(silentSamples + 1, delayCapacity) : 0;
+
+        float peak = 0.0f;
+        if (!belowCeiling)
+            for (int ch = 0; ch < numChannels; ++ch)
+                peak = juce::jmax(peak, detectPeak(ch));
+
+        // 所需增益 → 滑动最小（瞬时起控）→ 指数释放 → 滑动平均（平滑起控斜坡）
+        const float required = peak > ceiling ? ceiling / peak : 1.0f;
+        const float held = pushSlidingMin(required);
+        releaseGain = juce::jmin(held, releaseGain + (1.0f - releaseGain) * releaseCoef);
+        averageSum += (double) releaseGain - (double) averageRing[(size_t) averageIndex];
+        averageRing[(size_t) averageIndex] = releaseGain;
+        averageIndex = (averageIndex + 1) % window;
+        const float gain = (float) (averageSum / window);
+        ++sampleTime;
+
+        const int readIndex = (delayWrite - delaySamples + delayCapacity) % delayCapacity;
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            float* line = delayLine.getWritePointer(ch);
+            line[delayWrite] = channels[ch][i];
+            channels[ch][i] = line[readIndex] * gain;
+        }
+        delayWrite = (delayWrite + 1) % delayCapacity;
+
+        minGain = juce::jmin(minGain, gain);
+        limited += gain < kUnityThreshold ? 1 : 0;
+    }
+
+    const float reductionDb = minGain < kUnityThreshold ? -juce::Decibels::gainToDecibels(minGain, -100.0f) : 0.0f;
+    currentReductionDb.store(reductionDb, std::memory_order_relaxed);
+    if (reductionDb > maxReductionDb.load(std::memory_order_relaxed))
+        maxReductionDb.store(reductionDb, std::memory_order_relaxed);
+    limitedSamples.fetch_add(limited, std::memory_order_relaxed);
+}
+
+TruePeakLimiter::Stats TruePeakLimiter::getStats() const
+{
+    return { currentReductionDb.load(), maxReductionDb.load(), limitedSamples.load() };
+}
@@ -0,0 +1,97 @@
+#pragma once
+#include <juce_audio_basics/juce_audio_basics.h>
+
+/**
+ * 预读真峰值限幅器 - 主总线最后一级，防止多复音叠加与高音量时削波
+ * 职责：
+ * - 真峰值估计：4 倍过采样的多相 FIR 插值（Kaiser 窗 sinc，每相 TAPS_PER_PHASE 抽头），取采样点与插值点的最大绝对值，
+ *   左右声道联动
+ * - 增益计算：所需增益在预读窗口内取滑动最小值（瞬时起控），指数释放，再做窗口长度的滑动平均，
+ *   保证峰值样本离开延迟线时增益已降到位且增益曲线平滑
+ * - 输出延迟 = 预读时长（0.25 - MAX_LOOKAHEAD_MS 毫秒），新的预读时长在延迟线静音时生效，不会产生不连续
+ * - 统计增益衰减（当前、最大、累计限幅时长），供界面与调试查询
+ *
+ * 所有缓冲区在 prepare 中按最大预读时长分配，process 中不分配内存。
+ * process 与 prepare 需与渲染串行调用；参数设置与统计查询可在任意线程调用。
+ */
+class TruePeakLimiter
+{
+public:
+    static constexpr int MAX_CHANNELS = 2;
+    static constexpr int OVERSAMPLING = 4;
+    static constexpr int TAPS_PER_PHASE = 12;
+    static constexpr float MIN_LOOKAHEAD_MS = 0.25f;
+    static constexpr float MAX_LOOKAHEAD_MS = 2.0f;
+    static constexpr float DEFAULT_LOOKAHEAD_MS = 1.0f;
+    static constexpr float CEILING_DB = -1.0f;          // 真峰值上限（dBTP）
+    static constexpr double RELEASE_SECONDS = 0.05;
+
+    struct Stats
+    {
+        float currentReductionDb = 0.0f;    // 最近一个块的最大增益衰减（正数，dB）
+        float maxReductionDb = 0.0f;        // 上次重置以来的最大增益衰减
+        juce::int64 limitedSamples = 0;     // 上次重置以来增益低于 1 的样本数
+    };
+
+    TruePeakLimiter();
+
+    // 按采样率分配缓冲区并设计插值滤波器（不在音频线程调用）
+    void prepare(double sampleRate);
+
+    void setLookahead(float milliseconds);
+    float getLookahead() const { return lookaheadMs.load(); }
+
+    // 当前输出延迟（样本）
+    int getLatencySamples() const { return latencySamples.load(std::memory_order_relaxed); }
+
+    // 原地限幅前 MAX_CHANNELS 个声道
+    void process(juce::AudioBuffer<float>& buffer, int startSample, int numSamples);
+
+    Stats getStats() const;
+    void resetStats() { resetRequested.store(true); }
+
+private:
+    void applyLookahead(int samples);
+    float detectPeak(int channel) const;
+    float pushSlidingMin(float value);
+
+    // 插值滤波器：phases[p] 为第 p 个插值点（p = 1 .. OVERSAMPLING - 1）的抽头，第 0 相即原样本
+    float phases[OVERSAMPLING][TAPS_PER_PHASE] = {};
+    float interpolationBound = 1.0f;    // 各相抽头绝对值之和的最大值：插值点不会超过采样峰值的这么多倍
+    float previousBlockPeak = 0.0f;
+
+    // 每声道最近 TAPS_PER_PHASE 个输入，存两遍避免取模（history[i] == history[i + TAPS_PER_PHASE]）
+    float history[MAX_CHANNELS][TAPS_PER_PHASE * 2] = {};
+    int historyIndex = 0;
+
+    // 预读延迟线（容量按 MAX_LOOKAHEAD_MS 分配）
+    juce::AudioBuffer<float> delayLine;
+    int delayCapacity = 0;
+    int delayWrite = 0;
+    int delaySamples = 0;
+
+    // 滑动最小值（单调队列）与滑动平均，容量同延迟线
+    std::vector<float> minValues;
+    std::vector<juce::int64> minTimes;
+    int minHead = 0, minCount = 0;
+    std::vector<float> averageRing;
+    int averageIndex = 0;
+    double averageSum = 0.0;
+    int window = 1;
+    juce::int64 sampleTime = 0;
+
+    float releaseGain = 1.0f;
+    float releaseCoef = 0.0f;
+    float ceiling = 1.0f;
+    int silentSamples = 0;
+    double currentSampleRate = 0.0;
+
+    std::atomic<float> lookaheadMs { DEFAULT_LOOKAHEAD_MS };
+    std::atomic<int> latencySamples { 0 };
+    std::atomic<float> currentReductionDb { 0.0f };
+    std::atomic<float> maxReductionDb { 0.0f };
+    std::atomic<juce::int64> limitedSamples { 0 };
+    std::atomic<bool> resetRequested { false };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(TruePeakLimiter)
+};
@@ -0,0 +1,95 @@
+#include "Wavetable.h"
+#include <juce_dsp/juce_dsp.h>
+
+std::shared_ptr<const Wavetable> Wavetable::createFromHarmonics(const std::vector<float>& amplitudes)
+{
+    std::vector<std::complex<float>> bins(TABLE_SIZE / 2 + 1);
+    const int numHarmonics = juce::jmin((int) amplitudes.size(), TABLE_SIZE / 2 - 1);
+
+    // 正弦相位：sin 分量对应频点的负虚部
+    for (int h = 1; h <= numHarmonics; ++h)
+        bins[(size_t) h] = { 0.0f, -amplitudes[(size_t) h - 1] };
+
+    return createFromSpectrum(bins);
+}
+
+std::shared_ptr<const Wavetable> Wavetable::createFromSingleCycle(const float* samples, int numSamples)
+{
+    if (samples == nullptr || numSamples < 4)
+        return nullptr;
+
+    // 线性插值重采样到一个周期 TABLE_SIZE 个样本（按周期回绕）
+    std::vector<float> fftData(TABLE_SIZE * 2, 0.0f);
+    for (int i = 0; i < TABLE_SIZE; ++i)
+    {
+        const double position = (double) i * numSamples / TABLE_SIZE;
+        const int index = (int) position;
+        const float frac = (float) (position - index);
+        const float a = samples[index % numSamples];
+        const float b = samples[(index + 1) % numSamples];
+        fftData[(size_t) i] = a + frac * (b - a);
+    }
+
+    juce::dsp::FFT fft(TABLE_ORDER);
+    fft.performRealOnlyForwardTransform(fftData.data(), true);
+
+    std::vector<std::complex<float>> bins(TABLE_SIZE / 2 + 1);
+    for (size_t h = 0; h < bins.size(); ++h)
+        bins[h] = { fftData[h * 2], fftData[h * 2 + 1] };
+
+    return createFromSpectrum(bins);
+}
+
+std::shared_ptr<const Wavetable> Wavetable::createFromSpectrum(const std::vector<std::complex<float>>& bins)
+{
+    std::shared_ptr<Wavetable> table(new Wavetable());
+    table->data.resize((size_t) NUM_LEVELS * (TABLE_SIZE + 1));
+
+    juce::dsp::FFT fft(TABLE_ORDER);
+    std::vector<float> fftData(TABLE_SIZE * 2);
+
+    for (int level = 0; level < NUM_LEVELS; ++level)
+    {
+        // 只保留本级允许的谐波，直流分量去掉
+        std::fill(fftData.begin(), fftData.end(), 0.0f);
+        const int highest = getHighestHarmonic(level);
+        for (int h = 1; h <= highest; ++h)
+        {
+            fftData[(size_t) h * 2] = bins[(size_t) h].real();
+            fftData[(size_t) h * 2 + 1] = bins[(size_t) h].imag();
+        }
+
+        fft.performRealOnlyInverseTransform(fftData.data());
+
+        float* dest = table->data.data() + (size_t) level * (TABLE_SIZE + 1);
+        std::copy(fftData.begin(), fftData.begin() + TABLE_SIZE, dest);
+        dest[TABLE_SIZE] = dest[0];
+    }
+
+    // 以最丰富的一级为准统一缩放到单位正弦波的 RMS（1/√2），各级间保持相对电平
+    double sumSquares = 0.0;
+    for (int i = 0; i < TABLE_SIZE; ++i)
+        sumSquares += (double) table->data[(size_t) i] * table->data[(size_t) i];
+
+    const double rms = std::sqrt(sumSquares / TABLE_SIZE);
+    if (rms < 1.0e-9)
+        return nullptr;
+
+    juce::FloatVectorOperations::multiply(table->data.data(), (float) (juce::MathConstants<double>::sqrt2 * 0.5 / rms),
+                                          (int) table->data.size());
+    return table;
+}
+
+int Wavetable::getHighestHarmonic(int level)
+{
+    return level == 0 ? TABLE_SIZE / 2 - 1 : (TABLE_SIZE / 2) >> level;
+}
+
+int Wavetable::getLevelForFrequency(double fundamentalHz, double sampleRate) const
+{
+    const double maxHarmonics = 0.5 * sampleRate / juce::jmax(1.0, fundamentalHz);
+    for (int level = 0; level < NUM_LEVELS - 1; ++level)
+        if (getHighestHarmonic(level) <= maxHarmonics)
+            return level;
+    return NUM_LEVELS - 1;
+}
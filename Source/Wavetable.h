@@ -0,0 +1,45 @@
+#pragma once
+#include <juce_core/juce_core.h>
+#include <complex>
+#include <memory>
+#include <vector>
+
+/**
+ * 带限多级波表（mip-map）
+ * 职责：
+ * - 由谐波振幅或单周期波形生成一组按八度递减谐波数的波表，每一级只保留不会超过奈奎斯特频率的谐波
+ * - 生成只在加载时进行一次（juce::dsp::FFT 逆变换），之后只读，供所有 Voice 共享
+ * - 统一归一化到与单位正弦波相同的 RMS，使各波形与正弦音色响度接近
+ *
+ * 第 level 级保留的最高谐波：level 0 为 TABLE_SIZE / 2 - 1，之后每级减半（每高一个八度用下一级）。
+ * 每张表末尾多存一个样本（等于第一个样本），线性插值无需取模。
+ */
+class Wavetable
+{
+public:
+    static constexpr int TABLE_ORDER = 11;
+    static constexpr int TABLE_SIZE = 1 << TABLE_ORDER;
+    static constexpr int NUM_LEVELS = TABLE_ORDER;
+
+    // amplitudes[i] 为第 i + 1 次谐波的振幅（正弦相位）
+    static std::shared_ptr<const Wavetable> createFromHarmonics(const std::vector<float>& amplitudes);
+
+    // 单周期波形（任意长度），重采样到 TABLE_SIZE 后做频谱分析；全零或过短时返回 nullptr
+    static std::shared_ptr<const Wavetable> createFromSingleCycle(const float* samples, int numSamples);
+
+    // 基频 fundamentalHz 在 sampleRate 下不产生混叠的最丰富一级
+    int getLevelForFrequency(double fundamentalHz, double sampleRate) const;
+
+    // 第 level 级的 TABLE_SIZE + 1 个样本
+    const float* getLevel(int level) const { return data.data() + (size_t) level * (TABLE_SIZE + 1); }
+
+    static int getHighestHarmonic(int level);
+
+private:
+    Wavetable() = default;
+
+    // bins[h] 为第 h 个频点（0 = 直流，共 TABLE_SIZE / 2 + 1 个）
+    static std::shared_ptr<const Wavetable> createFromSpectrum(const std::vector<std::complex<float>>& bins);
+
+    std::vector<float> data;
+};
@@ -0,0 +1,88 @@
+#include "WavetableSound.h"
+#include <juce_audio_formats/juce_audio_formats.h>
+
+namespace
+{
+    std::vector<float> sawHarmonics()
+    {
+        std::vector<float> amplitudes(Wavetable::TABLE_SIZE / 2 - 1);
+        for (size_t i = 0; i < amplitudes.size(); ++i)
+            amplitudes[i] = 1.0f / (float) (i + 1);
+        return amplitudes;
+    }
+
+    std::vector<float> squareHarmonics()
+    {
+        std::vector<float> amplitudes(Wavetable::TABLE_SIZE / 2 - 1);
+        for (size_t i = 0; i < amplitudes.size(); i += 2)
+            amplitudes[i] = 1.0f / (float) (i + 1);
+        return amplitudes;
+    }
+
+    std::vector<float> organHarmonics()
+    {
+        // 拉杆风琴 8' 4' 2 2/3' 2' 1 3/5' 1 1/3' 1'（第 1、2、3、4、5、6、8 次谐波）
+        return { 1.0f, 0.7f, 0.5f, 0.5f, 0.3f, 0.3f, 0.0f, 0.25f };
+    }
+
+    // 单周期文件上限：更长的文件多半不是单周期波形
+    constexpr int kMaxSingleCycleSamples = 8192;
+}
+
+WavetableSound::WavetableSound()
+{
+    builtInTables[saw] = Wavetable::createFromHarmonics(sawHarmonics());
+    builtInTables[square] = Wavetable::createFromHarmonics(squareHarmonics());
+    builtInTables[organ] = Wavetable::createFromHarmonics(organHarmonics());
+}
+
+bool WavetableSound::appliesToNote(int)
+{
+    return enabled.load();
+}
+
+bool WavetableSound::appliesToChannel(int)
+{
+    return enabled.load();
+}
+
+const Wavetable* WavetableSound::getWavetable(Waveform which) const
+{
+    if (which == user)
+    {
+        if (auto* table = userTable.load())
+            return table;
+        return builtInTables[saw].get();
+    }
+    return builtInTables[which].get();
+}
+
+bool WavetableSound::loadUserWavetable(const juce::File& file)
+{
+    juce::AudioFormatManager formatManager;
+    formatManager.registerBasicFormats();
+
+    std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(file));
+    if (reader == nullptr)
+    {
+        DBG("WavetableSound: could not read " + file.getFullPathName());
+        return false;
+    }
+
+    const int numSamples = (int) juce::jmin(reader->lengthInSamples, (juce::int64) kMaxSingleCycleSamples);
+    juce::AudioBuffer<float> cycle(1, juce::jmax(1, numSamples));
+    reader->read(&cycle, 0, numSamples, 0, true, false);
+
+    auto table = Wavetable::createFromSingleCycle(cycle.getReadPointer(0), numSamples);
+    if (table == nullptr)
+    {
+        DBG("WavetableSound: " + file.getFileName() + " is not a usable single-cycle waveform");
+        return false;
+    }
+
+    const juce::ScopedLock sl(userTablesLock);
+    userTables.push_back(table);
+    userTable = table.get();
+    DBG("WavetableSound: loaded user wavetable " + file.getFileName() + " (" + juce::String(numSamples) + " samples)");
+    return true;
+}
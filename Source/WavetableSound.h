@@ -0,0 +1,52 @@
+#pragma once
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_core/juce_core.h>
+#include "Wavetable.h"
+
+// 波表音色类：内置锯齿波、方波、风琴三种带限波表，另可加载用户单周期 WAV
+class WavetableSound : public juce::SynthesiserSound
+{
+public:
+    enum Waveform
+    {
+        saw = 0,
+        square = 1,
+        organ = 2,
+        user = 3,       // 用户单周期波形（未加载时回退到锯齿波）
+        numWaveforms
+    };
+
+    // 构造时一次性生成内置波表（每种 11 级 × 2049 个样本，约 90 KB）
+    WavetableSound();
+
+    bool appliesToNote(int midiNoteNumber) override;
+    bool appliesToChannel(int midiChannelNumber) override;
+    void setEnabled(bool e) { enabled = e; }
+    bool isEnabled() const { return enabled; }
+
+    void setWaveform(Waveform newWaveform) { waveform = newWaveform; }
+    Waveform getWaveform() const { return waveform.load(); }
+
+    // 当前波形的波表（音频线程在 startNote 时读取，始终非空）
+    const Wavetable* getCurrentWavetable() const { return getWavetable(waveform.load()); }
+
+    // 指定波形的波表（用户波表未加载时回退到锯齿波，始终非空）
+    const Wavetable* getWavetable(Waveform which) const;
+
+    // 从单周期音频文件生成用户波表（不在音频线程调用）
+    bool loadUserWavetable(const juce::File& file);
+    bool hasUserWavetable() const { return userTable.load() != nullptr; }
+
+private:
+    std::shared_ptr<const Wavetable> builtInTables[user];
+
+    // 加载过的用户波表全部保留：正在发声的 Voice 可能仍引用旧表，替换时不能在音频线程释放
+    juce::CriticalSection userTablesLock;
+    std::vector<std::shared_ptr<const Wavetable>> userTables;
+    std::atomic<const Wavetable*> userTable { nullptr };
+
+    std::atomic<Waveform> waveform { saw };
+    std::atomic<bool> enabled { true };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(WavetableSound)
+};
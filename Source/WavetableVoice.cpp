@@ -0,0 +1,128 @@
+#include "WavetableVoice.h"
+
+namespace
+{
+    constexpr int kFractionBits = 32 - Wavetable::TABLE_ORDER;
+    constexpr uint32_t kFractionMask = (1u << kFractionBits) - 1u;
+    constexpr float kFractionScale = 1.0f / (float) (1u << kFractionBits);
+}
+
+bool WavetableVoice::canPlaySound(juce::SynthesiserSound* sound)
+{
+    return dynamic_cast<WavetableSound*>(sound) != nullptr;
+}
+
+void WavetableVoice::startNote(int midiNoteNumber, float velocity, juce::SynthesiserSound* sound, int)
+{
+    auto* wavetableSound = dynamic_cast<WavetableSound*>(sound);
+    if (wavetableSound == nullptr)
+    {
+        DBG("Error: Sound is not WavetableSound type");
+        return;
+    }
+
+    // 按音高一次性选定波表级别：该级的最高谐波不超过奈奎斯特频率
+    const auto* wavetable = wavetableOverride != nullptr ? wavetableOverride : wavetableSound->getCurrentWavetable();
+    const double frequency = juce::MidiMessage::getMidiNoteInHertz(midiNoteNumber);
+    table = wavetable->getLevel(wavetable->getLevelForFrequency(frequency, getSampleRate()));
+
+    phase = 0;
+    phaseIncrement = (uint32_t) std::llround(juce::jlimit(0.0, 0.5, frequency / getSampleRate()) * 4294967296.0);
+    level = velocity * getLoudnessGain(midiNoteNumber);
+    tailOff = 0.0f;
+    attack = 0.0f;
+    attackStep = 1.0f / (float) juce::jmax(1.0, getSampleRate() * 0.01);
+
+    // 刚起音的 Voice 按目标电平报告，同一块内的后续音符不会把它当作最安静的抢走
+    currentLevel = level * volume;
+}
+
+void WavetableVoice::stopNote(float, bool allowTailOff)
+{
+    if (allowTailOff)
+    {
+        if (tailOff == 0.0f)
+            tailOff = 1.0f;
+    }
+    else
+    {
+        // 硬停止：接管当前波表与相位做快速释放，Voice 立即空出
+        if (isVoiceActive() && table != nullptr)
+        {
+            releaseTable = table;
+            releasePhase = phase;
+            releasePhaseIncrement = phaseIncrement;
+            releaseGain = level * volume * getEnvelopeGain();
+            releaseStep = releaseGain / (float) getFastReleaseSamples();
+        }
+        clearCurrentNote();
+        table = nullptr;
+        currentLevel = releaseGain;
+    }
+}
+
+float WavetableVoice::getEnvelopeGain() const
+{
+    return attack * (tailOff > 0.0f ? tailOff : 1.0f);
+}
+
+float WavetableVoice::lookup(const float* t, uint32_t p)
+{
+    const uint32_t index = p >> kFractionBits;
+    const float frac = (float) (p & kFractionMask) * kFractionScale;
+    return t[index] + frac * (t[index + 1] - t[index]);
+}
+
+void WavetableVoice::renderNextBlock(juce::AudioBuffer<float>& outputBuffer, int startSample, int numSamples)
+{
+    const int outChans = outputBuffer.getNumChannels();
+
+    if (releaseGain > 0.0f)
+    {
+        for (int i = 0; i < numSamples && releaseGain > 0.0f; ++i)
+        {
+            const float sample = lookup(releaseTable, releasePhase) * releaseGain;
+            for (int ch = 0; ch < outChans; ++ch)
+                outputBuffer.addSample(ch, startSample + i, sample);
+            releasePhase += releasePhaseIncrement;
+            releaseGain -= releaseStep;
+        }
+        releaseGain = juce::jmax(0.0f, releaseGain);
+    }
+
+    if (!isVoiceActive() || table == nullptr)
+    {
+        currentLevel = releaseGain;
+        return;
+    }
+
+    const float localLevel = level * volume;
+
+    while (--numSamples >= 0)
+    {
+        if (attack < 1.0f)
+            attack = juce::jmin(1.0f, attack + attackStep);
+
+        if (tailOff > 0.0f)
+        {
+            tailOff *= 0.995f;
+
+            if (tailOff < 0.01f)
+            {
+                clearCurrentNote();
+                table = nullptr;
+                break;
+            }
+        }
+
+        const float sample = lookup(table, phase) * localLevel * getEnvelopeGain();
+        for (int ch = 0; ch < outChans; ++ch)
+            outputBuffer.addSample(ch, startSample, sample);
+
+        phase += phaseIncrement;
+        ++startSample;
+    }
+
+    // 波表已归一化到单位正弦 RMS，峰值按包络估计即可（不计起音渐入，起音中的音符按目标电平报告）
+    currentLevel = table != nullptr ? localLevel * (tailOff > 0.0f ? tailOff : 1.0f) : 0.0f;
+}
@@ -0,0 +1,49 @@
+#pragma once
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_core/juce_core.h>
+#include "WavetableSound.h"
+#include "EarxVoice.h"
+
+class WavetableVoice : public EarxVoice
+{
+public:
+    WavetableVoice() = default;
+    
+    bool canPlaySound(juce::SynthesiserSound* sound) override;
+    void startNote(int midiNoteNumber, float velocity, juce::SynthesiserSound* sound, int currentPitchWheelPosition) override;
+    void stopNote(float velocity, bool allowTailOff) override;
+    void renderNextBlock(juce::AudioBuffer<float>& outputBuffer, int startSample, int numSamples) override;
+    void pitchWheelMoved(int) override {}
+    void controllerMoved(int, int) override {}
+
+    void setVolume(float newVolume) override { volume = newVolume; }
+    float getCurrentLevel() const override { return currentLevel; }
+
+    // 固定使用的波表（测量各波形的响度时使用，不改动共享 Sound 的当前波形）；为空时使用 Sound 的当前波形
+    void setWavetableOverride(const Wavetable* wavetable) { wavetableOverride = wavetable; }
+
+private:
+    float getEnvelopeGain() const;
+    static float lookup(const float* table, uint32_t phase);
+
+    // 按音高选定的一级波表，相位为 32 位定点数（2^32 为一周）
+    const float* table = nullptr;
+    const Wavetable* wavetableOverride = nullptr;
+    uint32_t phase = 0;
+    uint32_t phaseIncrement = 0;
+    float level = 0.0f;
+    float attack = 0.0f;
+    float attackStep = 0.0f;
+    float tailOff = 0.0f;
+    float volume = 0.2f;
+    float currentLevel = 0.0f;
+
+    // 硬停止 / 被抢占时保留的旧音符状态，线性淡出 FAST_RELEASE_MS
+    const float* releaseTable = nullptr;
+    uint32_t releasePhase = 0;
+    uint32_t releasePhaseIncrement = 0;
+    float releaseGain = 0.0f;
+    float releaseStep = 0.0f;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(WavetableVoice)
+};
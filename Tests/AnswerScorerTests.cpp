@@ -0,0 +1,84 @@
+#include "GoldenRender.h"
+#include "AnswerScorer.h"
+
+/**
+ * 作答评分测试
+ *
+ * 在离线会话的音频时钟上于已知样本出题，按已知的主机时刻作答：被听到的时刻与反应时间应计入输出延迟，
+ * 每题只计一次，结果环形缓冲区写满后覆盖最旧的结果。
+ */
+class AnswerScorerTests : public juce::UnitTest
+{
+public:
+    AnswerScorerTests() : juce::UnitTest("Answer scoring", "Engine") {}
+
+    void runTest() override
+    {
+        using GoldenRender::OfflineSession;
+
+        beginTest("Reaction time is measured from the heard onset");
+        {
+            OfflineSession session(AppState::timbreSine, 1);
+            session.audio->setOutputLatencySamples(480);
+            session.render(0.05);
+
+            const juce::int64 onset = session.audio->playNote(64, 0.8f);
+            expect(onset > 0, "note did not start on the audio clock");
+            session.playback->getAnswerScorer().noteStarted(64, onset);
+            session.render(0.1);
+
+            const int latency = session.audio->getOutputLatencySamples();
+            expect(latency >= 480, "output latency does not include the device latency");
+
+            const double reaction = 250.0;
+            const double latencyMs = latency * 1000.0 / session.audio->getSampleRate();
+            const double answerHostMs = session.audio->audioClockToHostTimeMs(onset) + latencyMs + reaction;
+
+            AnswerScorer::Result result;
+            expect(session.playback->submitAnswer(4, answerHostMs, result));
+            expectEquals(result.midiNote, 64);
+            expectEquals(result.expectedSemitone, 4);
+            expect(result.correct);
+            expectWithinAbsoluteError(result.onsetMs, (double) (onset + latency) * 1000.0 / session.audio->getSampleRate(), 1.0e-6);
+            expectWithinAbsoluteError(result.reactionMs, reaction, 1.0e-3);
+
+            // 每道题只计一次
+            expect(!session.playback->submitAnswer(4, answerHostMs + 100.0, result), "a question was scored twice");
+            expectEquals(session.playback->getAnswerScorer().getNumResults(), 1);
+        }
+
+        beginTest("Wrong answers and result ring wraparound");
+        {
+            OfflineSession session(AppState::timbreSine, 2);
+            AnswerScorer scorer;
+            AnswerScorer::Result result;
+            expect(!scorer.submitAnswer(0, 0.0, *session.audio, result), "answered without a question");
+
+            const int total = AnswerScorer::RESULT_CAPACITY + 5;
+            for (int i = 0; i < total; ++i)
+            {
+                // 偶数题答对，奇数题答成高一个半音
+                const int note = 48 + i % 36;
+                scorer.noteStarted(note, 1000 + i);
+                expect(scorer.submitAnswer((note + i % 2) % 12, 0.0, *session.audio, result));
+            }
+
+            expectEquals(scorer.getNumResults(), (int) AnswerScorer::RESULT_CAPACITY);
+            expect(!scorer.getResult(AnswerScorer::RESULT_CAPACITY, result));
+
+            // index 0 为最近一次，最旧的 5 个结果已被覆盖
+            for (int index : { 0, 1, AnswerScorer::RESULT_CAPACITY - 1 })
+            {
+                const int i = total - 1 - index;
+                expect(scorer.getResult(index, result));
+                expectEquals(result.midiNote, 48 + i % 36);
+                expect(result.correct == (i % 2 == 0));
+            }
+
+            scorer.clearResults();
+            expectEquals(scorer.getNumResults(), 0);
+        }
+    }
+};
+
+static AnswerScorerTests answerScorerTests;
@@ -0,0 +1,156 @@
+#include <juce_audio_basics/juce_audio_basics.h>
+#include "CompressedSample.h"
+#include "SampleReader.h"
+
+/**
+ * 压缩样本测试
+ *
+ * 用合成信号（静音、低电平衰减、满幅瞬态，长度都不是块长的整数倍）编码后解码：残差在 8 位以内的块无损，
+ * 其余块的误差不超过 2^(移位-1) 个 16 位单位；块之间互不依赖；SampleReader 逐窗口读出的帧与整体 decode() 一致。
+ */
+class CompressedSampleTests : public juce::UnitTest
+{
+public:
+    CompressedSampleTests() : juce::UnitTest("Compressed samples", "Engine") {}
+
+    void runTest() override
+    {
+        constexpr int blockFrames = CompressedSample::BLOCK_FRAMES;
+
+        beginTest("Silence");
+        {
+            juce::AudioBuffer<float> silence(2, 3 * blockFrames + 100);
+            silence.clear();
+            checkCodec(silence, true);
+        }
+
+        beginTest("Low-level decay");
+        {
+            checkCodec(makeDecay(0.01f, 440.0, 48000 + 77), true);
+        }
+
+        beginTest("Full-scale transient");
+        {
+            auto transient = makeDecay(0.9f, 3000.0, 20 * blockFrames + 33);
+            juce::Random random(7);
+            for (int ch = 0; ch < transient.getNumChannels(); ++ch)
+                for (int i = 0; i < 2 * blockFrames; ++i)
+                    transient.setSample(ch, i, random.nextFloat() * 1.8f - 0.9f);
+            checkCodec(transient, false);
+        }
+
+        beginTest("Blocks are independent");
+        {
+            const auto original = makeDecay(0.5f, 1000.0, 8 * blockFrames + 10);
+            auto modified = original;
+            juce::Random random(3);
+            for (int i = 3 * blockFrames; i < 4 * blockFrames; ++i)
+                modified.setSample(0, i, random.nextFloat() * 2.0f - 1.0f);
+
+            const auto a = CompressedSample::encode(original);
+            const auto b = CompressedSample::encode(modified);
+            float decodedA[blockFrames], decodedB[blockFrames];
+            for (int block = 0; block < a->getNumBlocks(); ++block)
+            {
+                a->decodeBlock(0, block, decodedA);
+                b->decodeBlock(0, block, decodedB);
+                const bool same = std::memcmp(decodedA, decodedB, sizeof(decodedA)) == 0;
+                expect(block == 3 ? !same : same, "block " + juce::String(block) + " depends on its neighbours");
+            }
+        }
+    }
+
+private:
+    static juce::AudioBuffer<float> makeDecay(float amplitude, double frequency, int numFrames)
+    {
+        // 两个声道相位不同的指数衰减正弦
+        juce::AudioBuffer<float> buffer(2, numFrames);
+        for (int ch = 0; ch < 2; ++ch)
+            for (int i = 0; i < numFrames; ++i)
+                buffer.setSample(ch, i, amplitude * (float) (std::exp(-i / 24000.0)
+                                                     * std::sin(juce::MathConstants<double>::twoPi * frequency * i / 48000.0 + ch)));
+        return buffer;
+    }
+
+    static int toFixed(float x) { return juce::jlimit(-32768, 32767, juce::roundToInt(x * 32768.0f)); }
+
+    void checkCodec(const juce::AudioBuffer<float>& source, bool expectLossless)
+    {
+        constexpr int blockFrames = CompressedSample::BLOCK_FRAMES;
+        const auto compressed = CompressedSample::encode(source);
+        const auto decoded = compressed->decode();
+
+        expectEquals(decoded->getNumChannels(), source.getNumChannels());
+        expectEquals(decoded->getNumSamples(), source.getNumSamples());
+        expectEquals(compressed->getNumBlocks(), (source.getNumSamples() + blockFrames - 1) / blockFrames);
+
+        int lossyBlocks = 0;
+        for (int ch = 0; ch < source.getNumChannels(); ++ch)
+        {
+            for (int block = 0; block < compressed->getNumBlocks(); ++block)
+            {
+                const int start = block * blockFrames;
+                const int count = juce::jmin(blockFrames, source.getNumSamples() - start);
+                const int shift = compressed->getBlockShift(ch, block);
+                const int bound = (1 << shift) >> 1;
+
+                // 开环一阶残差都在 8 位以内时必须无损
+                int maxResidual = 0;
+                for (int i = 1; i < count; ++i)
+                    maxResidual = juce::jmax(maxResidual, std::abs(toFixed(source.getSample(ch, start + i))
+                                                                   - toFixed(source.getSample(ch, start + i - 1))));
+                if (maxResidual <= 127)
+                    expectEquals(shift, 0, "block " + juce::String(block) + " fits in 8 bits but is lossy");
+                if (shift > 0)
+                    ++lossyBlocks;
+
+                int maxError = 0;
+                for (int i = 0; i < count; ++i)
+                    maxError = juce::jmax(maxError, std::abs(juce::roundToInt(decoded->getSample(ch, start + i) * 32768.0f)
+                                                             - toFixed(source.getSample(ch, start + i))));
+                expect(maxError <= bound, "block " + juce::String(block) + " error " + juce::String(maxError)
+                                              + " exceeds 2^(" + juce::String(shift) + "-1)");
+
+                // 末块不足的部分重复最后一个样本
+                if (count < blockFrames)
+                {
+                    float padded[blockFrames];
+                    compressed->decodeBlock(ch, block, padded);
+                    for (int i = count; i < blockFrames; ++i)
+                        expectEquals(padded[i], padded[count - 1]);
+                }
+            }
+        }
+
+        if (expectLossless)
+            expectEquals(lossyBlocks, 0);
+        else
+            expect(lossyBlocks > 0, "transient did not exercise the lossy path");
+
+        checkReader(*compressed, *decoded);
+    }
+
+    void checkReader(const CompressedSample& compressed, const juce::AudioBuffer<float>& decoded)
+    {
+        // 以不同的跨度推进读取位置，窗口内可读的每一帧都应与整体解码逐位相同
+        SampleReader reader;
+        reader.setSource(nullptr, &compressed);
+        expectEquals(reader.getNumFrames(), decoded.getNumSamples());
+
+        int mismatches = 0;
+        int frame = 0, step = 0;
+        while (frame < decoded.getNumSamples())
+        {
+            const int last = reader.prepare(frame, frame + 100 + 97 * (step++ % 7));
+            expect(last >= frame, "prepare made no progress");
+            for (int f = frame; f <= last; ++f)
+                for (int ch = 0; ch < reader.getNumChannels(); ++ch)
+                    if (reader.getSample(ch, f) != decoded.getSample(ch, f))
+                        ++mismatches;
+            frame = juce::jmax(frame + 1, last + 1 - 37);     // 与上一窗口部分重叠
+        }
+        expectEquals(mismatches, 0);
+    }
+};
+
+static CompressedSampleTests compressedSampleTests;
@@ -0,0 +1,81 @@
+#include "GoldenRender.h"
+#include "ExerciseEngine.h"
+
+/**
+ * 音程 / 和弦练习测试
+ *
+ * 和声方式的各音以同一个时钟读数一次排队；定时事件队列放不下整个练习时一个音也不排，不会只响半个和弦。
+ */
+class ExerciseEngineTests : public juce::UnitTest
+{
+public:
+    ExerciseEngineTests() : juce::UnitTest("Exercise engine", "Engine") {}
+
+    void runTest() override
+    {
+        // 一次排队的结果应与在两次渲染之间逐个排队（各音同一个时钟读数）完全相同
+        checkMatchesSingleNotes("A harmonic chord starts in one block", ExerciseEngine::harmonic);
+        checkMatchesSingleNotes("Melodic notes are spaced from one clock reading", ExerciseEngine::melodicDescending);
+
+        beginTest("A full queue drops the whole exercise");
+        {
+            GoldenRender::OfflineSession session(AppState::timbreSine, 2);
+            auto& audio = *session.audio;
+
+            // 留出两个事件的空位：放得下一个单音，放不下三音和弦
+            const int delay = (int) GoldenRender::kSampleRate * 10;
+            for (int i = 0; i < AudioController::MAX_SCHEDULED_EVENTS / 2 - 1; ++i)
+                expect(audio.scheduleNote(40 + i % 40, 0.5f, delay, 100) >= 0);
+
+            auto& exercises = session.playback->getExerciseEngine();
+            const auto chord = exercises.createChord(60, 0, 0, ExerciseEngine::closeVoicing, ExerciseEngine::harmonic);
+            expectEquals((int) exercises.play(chord, 200.0, 500.0, 0.8f), -1);
+
+            // 和弦没有占用任何空位
+            expect(audio.scheduleNote(72, 0.5f, 0, 100) >= 0, "a partial chord consumed the free slots");
+            expectEquals((int) audio.scheduleNote(74, 0.5f, 0, 100), -1);
+        }
+    }
+
+private:
+    static constexpr double kSpacingMs = 50.0;
+    static constexpr double kLengthMs = 120.0;
+
+    void checkMatchesSingleNotes(const juce::String& name, ExerciseEngine::Style style)
+    {
+        beginTest(name);
+
+        GoldenRender::OfflineSession batch(AppState::timbreSine, 1);
+        GoldenRender::OfflineSession single(AppState::timbreSine, 1);
+        batch.render(0.05);
+        single.render(0.05);
+
+        auto& exercises = batch.playback->getExerciseEngine();
+        const auto chord = exercises.createChord(60, 0, 0, ExerciseEngine::closeVoicing, style);
+        const auto onset = exercises.play(chord, kSpacingMs, kLengthMs, 0.8f);
+        expect(onset >= 0, "exercise was not scheduled");
+
+        const double samplesPerMs = single.audio->getSampleRate() / 1000.0;
+        const int spacing = style == ExerciseEngine::harmonic ? 0 : juce::roundToInt(kSpacingMs * samplesPerMs);
+        const int length = juce::roundToInt(kLengthMs * samplesPerMs);
+        for (int i = 0; i < chord.numNotes; ++i)
+        {
+            const int note = chord.notes[style == ExerciseEngine::melodicDescending ? chord.numNotes - 1 - i : i];
+            const auto noteOnset = single.audio->scheduleNote(note, 0.8f, i * spacing, length);
+            expect(noteOnset == onset + i * spacing, "note " + juce::String(i) + " onset differs");
+        }
+
+        const auto batchOutput = batch.render(0.4);
+        const auto singleOutput = single.render(0.4);
+        expect(batchOutput.getMagnitude(0, batchOutput.getNumSamples()) > 0.0f, "exercise rendered silence");
+
+        int mismatches = 0;
+        for (int ch = 0; ch < batchOutput.getNumChannels(); ++ch)
+            for (int i = 0; i < batchOutput.getNumSamples(); ++i)
+                if (batchOutput.getSample(ch, i) != singleOutput.getSample(ch, i))
+                    ++mismatches;
+        expectEquals(mismatches, 0);
+    }
+};
+
+static ExerciseEngineTests exerciseEngineTests;
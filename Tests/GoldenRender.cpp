@@ -0,0 +1,245 @@
+#include "GoldenRender.h"
+#include <juce_audio_formats/juce_audio_formats.h>
+#include <algorithm>
+#include <chrono>
+
+namespace GoldenRender
+{
+    bool updateGoldenFiles = false;
+
+    static double nowSeconds()
+    {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    //==============================================================================
+    OfflineSession::OfflineSession(AppState::Timbre timbre, juce::int64 seed, double deviceRate,
+                                   AppState::PianoSampleStorage pianoStorage)
+        : deviceSampleRate(deviceRate)
+    {
+        state.audio.timbre = timbre;
+        state.audio.pianoSampleStorage = pianoStorage;
+        audio = std::make_unique<AudioController>(&state);
+        playback = std::make_unique<PlaybackEngine>(&state, audio.get());
+        audio->initialize(deviceSampleRate);
+        waitForLoudnessTables();
+
+        // 固定会话种子即可复现音符序列
+        playback->setRandomSeed((uint64_t) seed);
+    }
+
+    OfflineSession::~OfflineSession()
+    {
+        playback.reset();
+        audio.reset();
+    }
+
+    bool OfflineSession::waitForPianoSamples(int timeoutMs)
+    {
+        auto deadline = juce::Time::getMillisecondCounter() + (juce::uint32) timeoutMs;
+        while (!audio->arePianoSamplesLoaded())
+        {
+            if (juce::Time::getMillisecondCounter() > deadline)
+                return false;
+            juce::Thread::sleep(10);
+        }
+        return true;
+    }
+
+    bool OfflineSession::waitForLoudnessTables(int timeoutMs)
+    {
+        auto deadline = juce::Time::getMillisecondCounter() + (juce::uint32) timeoutMs;
+        while (audio->isLoudnessMeasurementPending())
+        {
+            if (juce::Time::getMillisecondCounter() > deadline)
+                return false;
+            juce::Thread::sleep(1);
+        }
+        return true;
+    }
+
+    void OfflineSession::at(double timeMs, std::function<void(OfflineSession&)> action)
+    {
+        script.add({ timeMs, std::move(action) });
+        std::stable_sort(script.begin(), script.end(),
+                         [](const ScriptStep& a, const ScriptStep& b) { return a.timeMs < b.timeMs; });
+    }
+
+    void OfflineSession::playNextNote()
+    {
+        const int before = state.playback.activeNotes.size();
+        playback->playNextNote();
+
+        // playNextNote 以真实时钟计算结束时间，这里改写为虚拟时钟，保证停音时刻可复现
+        const double durationMs = (60000.0 / state.playback.bpm) * (state.playback.noteDuration / 100.0);
+        for (int i = before; i < state.playback.activeNotes.size(); ++i)
+            state.playback.activeNotes.getReference(i).endTime = nowMs() + durationMs;
+    }
+
+    void OfflineSession::startAutoPlay()
+    {
+        state.playback.autoPlayEnabled = true;
+        state.playback.lastAutoPlayTime = nowMs();
+    }
+
+    void OfflineSession::processBlock(juce::AudioBuffer<float>& block)
+    {
+        const double currentTime = nowMs();
+
+        while (nextStep < script.size() && script.getReference(nextStep).timeMs <= currentTime)
+            script.getReference(nextStep++).action(*this);
+
+        auto start = nowSeconds();
+
+        // 与 AudioEngineCallback 相同的驱动顺序：先到时停音，再处理自动播放
+        playback->updateActiveNotes(currentTime);
+
+        if (state.playback.autoPlayEnabled)
+        {
+            const double beatInterval = 60000.0 / state.playback.bpm;
+            if (currentTime - state.playback.lastAutoPlayTime >= beatInterval)
+            {
+                playNextNote();
+                state.playback.lastAutoPlayTime = currentTime;
+            }
+        }
+
+        block.clear();
+        juce::MidiBuffer midiBuffer;
+        audio->renderNextBlock(block, midiBuffer, 0, block.getNumSamples());
+
+        engineSeconds += nowSeconds() - start;
+        samplesRendered += block.getNumSamples();
+    }
+
+    juce::AudioBuffer<float> OfflineSession::render(double seconds)
+    {
+        const int totalSamples = (int) (seconds * deviceSampleRate);
+        juce::AudioBuffer<float> output(2, totalSamples);
+        juce::AudioBuffer<float> block(2, kBlockSize);
+
+        for (int pos = 0; pos < totalSamples; pos += kBlockSize)
+        {
+            const int numSamples = juce::jmin(kBlockSize, totalSamples - pos);
+            juce::AudioBuffer<float> view(block.getArrayOfWritePointers(), 2, numSamples);
+            processBlock(view);
+
+            for (int ch = 0; ch < 2; ++ch)
+                output.copyFrom(ch, pos, block, ch, 0, numSamples);
+        }
+
+        return output;
+    }
+
+    //==============================================================================
+    juce::File getGoldenDirectory()
+    {
+       #ifdef EARX_SOURCE_DIR
+        return juce::File(EARX_SOURCE_DIR).getChildFile("Tests").getChildFile("golden");
+       #else
+        return juce::File::getCurrentWorkingDirectory().getChildFile("Tests").getChildFile("golden");
+       #endif
+    }
+
+    juce::File getBundledSFZFile()
+    {
+        return getGoldenDirectory().getParentDirectory().getParentDirectory()
+                   .getChildFile("Source")
+                   .getChildFile("AccurateSalamanderGrandPianoV6.0_48khz16bit")
+                   .getChildFile("sfz")
+                   .getChildFile("Accurate-SalamanderGrandPiano_flat.Recommended_vel9_dry_flac_48_84.sfz");
+    }
+
+    static bool writeWav(const juce::File& file, const juce::AudioBuffer<float>& buffer, double sampleRate)
+    {
+        file.deleteFile();
+        std::unique_ptr<juce::OutputStream> stream(file.createOutputStream());
+        if (stream == nullptr)
+            return false;
+
+        juce::WavAudioFormat wav;
+        std::unique_ptr<juce::AudioFormatWriter> writer(wav.createWriterFor(stream.get(), sampleRate,
+                                                                            (unsigned int) buffer.getNumChannels(),
+                                                                            16, {}, 0));
+        if (writer == nullptr)
+            return false;
+
+        stream.release(); // writer 接管输出流
+        return writer->writeFromAudioSampleBuffer(buffer, 0, buffer.getNumSamples());
+    }
+
+    static bool readWav(const juce::File& file, juce::AudioBuffer<float>& buffer)
+    {
+        juce::WavAudioFormat wav;
+        std::unique_ptr<juce::AudioFormatReader> reader(wav.createReaderFor(file.createInputStream().release(), true));
+        if (reader == nullptr)
+            return false;
+
+        buffer.setSize((int) reader->numChannels, (int) reader->lengthInSamples);
+        return reader->read(&buffer, 0, (int) reader->lengthInSamples, 0, true, true);
+    }
+
+    Comparison compareWithGolden(const juce::AudioBuffer<float>& rendered, const juce::String& name, float tolerance,
+                                 double sampleRate)
+    {
+        Comparison result;
+        auto goldenFile = getGoldenDirectory().getChildFile(name + ".wav");
+
+        if (updateGoldenFiles)
+        {
+            goldenFile.getParentDirectory().createDirectory();
+            result.passed = writeWav(goldenFile, rendered, sampleRate);
+            result.updated = true;
+            result.message = result.passed ? "updated " + goldenFile.getFileName()
+                                           : "could not write " + goldenFile.getFullPathName();
+            return result;
+        }
+
+        juce::AudioBuffer<float> golden;
+        if (!goldenFile.existsAsFile() || !readWav(goldenFile, golden))
+        {
+            result.message = "missing golden file " + goldenFile.getFullPathName() + " (run with --update-golden)";
+            return result;
+        }
+
+        if (golden.getNumChannels() != rendered.getNumChannels() || golden.getNumSamples() != rendered.getNumSamples())
+        {
+            result.message = "shape mismatch: golden " + juce::String(golden.getNumChannels()) + "x" + juce::String(golden.getNumSamples())
+                           + ", rendered " + juce::String(rendered.getNumChannels()) + "x" + juce::String(rendered.getNumSamples());
+            return result;
+        }
+
+        double sumSquares = 0.0;
+        for (int ch = 0; ch < rendered.getNumChannels(); ++ch)
+        {
+            const float* a = rendered.getReadPointer(ch);
+            const float* b = golden.getReadPointer(ch);
+            for (int i = 0; i < rendered.getNumSamples(); ++i)
+            {
+                const float diff = std::abs(a[i] - b[i]);
+                result.maxAbsError = juce::jmax(result.maxAbsError, diff);
+                sumSquares += (double) diff * diff;
+            }
+        }
+
+        result.rmsError = (float) std::sqrt(sumSquares / ((double) rendered.getNumChannels() * rendered.getNumSamples()));
+        result.passed = result.maxAbsError <= tolerance;
+        result.message = name + ": max abs error " + juce::String(result.maxAbsError, 6)
+                       + ", rms error " + juce::String(result.rmsError, 7)
+                       + " (tolerance " + juce::String(tolerance, 6) + ")";
+        return result;
+    }
+
+    double getBudgetScale()
+    {
+        auto env = juce::SystemStats::getEnvironmentVariable("EARX_PERF_BUDGET_SCALE", {});
+        if (env.isNotEmpty() && env.getDoubleValue() > 0.0)
+            return env.getDoubleValue();
+
+       #if JUCE_DEBUG
+        return 20.0;
+       #else
+        return 1.0;
+       #endif
+    }
+}
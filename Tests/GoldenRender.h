@@ -0,0 +1,96 @@
+#pragma once
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_core/juce_core.h>
+#include "AppState.h"
+#include "AudioController.h"
+#include "PlaybackEngine.h"
+#include <functional>
+#include <memory>
+
+/**
+ * 黄金参考渲染（golden render）测试支持
+ *
+ * 离线会话直接复用 AudioController 与 PlaybackEngine，不改动引擎代码：
+ * - 虚拟时钟：以已渲染样本数换算毫秒，替代 getMillisecondCounterHiRes()
+ * - 确定性随机：每个会话使用固定的会话种子（PlaybackEngine::setRandomSeed）
+ * - 驱动逻辑与 EarxAudioEngineFFI 中的音频回调保持一致（到时停音 + 按 BPM 自动播放）
+ */
+namespace GoldenRender
+{
+    constexpr double kSampleRate = 48000.0;
+    constexpr int kBlockSize = 256;
+
+    // 为 true 时用当前渲染结果覆盖参考文件（--update-golden）
+    extern bool updateGoldenFiles;
+
+    class OfflineSession
+    {
+    public:
+        // deviceSampleRate 为模拟的设备采样率（引擎内部采样率固定，不同时经输出采样率转换）；
+        // 钢琴样本存储方式默认固定为浮点，参考输出不随运行机器的内存大小变化
+        OfflineSession(AppState::Timbre timbre, juce::int64 seed, double deviceSampleRate = kSampleRate,
+                       AppState::PianoSampleStorage pianoStorage = AppState::pianoStorageFloat);
+        ~OfflineSession();
+
+        // 等待异步加载的钢琴采样就绪
+        bool waitForPianoSamples(int timeoutMs = 30000);
+
+        // 等待后台测量的响度补偿表就绪（构造时已等待一次；更换分音表或用户波表后需再次等待）
+        bool waitForLoudnessTables(int timeoutMs = 30000);
+
+        // 在虚拟时间 timeMs 执行脚本动作（在该时刻所在块开始前执行）
+        void at(double timeMs, std::function<void(OfflineSession&)> action);
+
+        // 渲染指定时长，返回立体声输出
+        juce::AudioBuffer<float> render(double seconds);
+
+        // 与音频回调一致的播放入口：音符结束时间改用虚拟时钟
+        void playNextNote();
+        void startAutoPlay();
+
+        double nowMs() const { return (double) samplesRendered * 1000.0 / deviceSampleRate; }
+        double getEngineSeconds() const { return engineSeconds; }
+
+        AppState state;
+        std::unique_ptr<AudioController> audio;
+        std::unique_ptr<PlaybackEngine> playback;
+
+    private:
+        struct ScriptStep
+        {
+            double timeMs;
+            std::function<void(OfflineSession&)> action;
+        };
+
+        juce::Array<ScriptStep> script;
+        int nextStep = 0;
+        const double deviceSampleRate;
+        juce::int64 samplesRendered = 0;
+        double engineSeconds = 0.0;
+
+        void processBlock(juce::AudioBuffer<float>& block);
+
+        JUCE_DECLARE_NON_COPYABLE(OfflineSession)
+    };
+
+    struct Comparison
+    {
+        bool passed = false;
+        bool updated = false;
+        float maxAbsError = 0.0f;
+        float rmsError = 0.0f;
+        juce::String message;
+    };
+
+    juce::File getGoldenDirectory();
+
+    // 随仓库提供的钢琴 SFZ（Source/AccurateSalamanderGrandPianoV6.0_48khz16bit）
+    juce::File getBundledSFZFile();
+
+    // 与 Tests/golden/<name>.wav 比较；updateGoldenFiles 时改为写入
+    Comparison compareWithGolden(const juce::AudioBuffer<float>& rendered, const juce::String& name, float tolerance,
+                                 double sampleRate = kSampleRate);
+
+    // 性能预算缩放：Debug 构建放宽，亦可通过 EARX_PERF_BUDGET_SCALE 覆盖
+    double getBudgetScale();
+}
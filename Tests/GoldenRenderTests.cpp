@@ -0,0 +1,247 @@
+#include "GoldenRender.h"
+
+/**
+ * 黄金参考渲染回归测试
+ *
+ * 每个场景以脚本驱动离线会话，输出与 Tests/golden/<场景>.wav 比较（容差内视为一致），
+ * 同时检查引擎处理耗时是否超出该场景的 CPU 预算（按实时时长的百分比给出）。
+ * 修改 voice 内核等只影响性能的重构应保持全部通过；有意改变声音时需重新生成参考文件。
+ */
+class GoldenRenderTests : public juce::UnitTest
+{
+public:
+    GoldenRenderTests() : juce::UnitTest("Golden render", "Golden") {}
+
+    void runTest() override
+    {
+        using GoldenRender::OfflineSession;
+
+        runScenario("sine_autoplay", AppState::timbreSine, 1, 1.5, 2.0, [](OfflineSession& s)
+        {
+            s.state.playback.bpm = 120.0;
+            s.state.playback.noteDuration = 60.0f;
+            s.at(0.0, [](OfflineSession& x) { x.startAutoPlay(); x.playNextNote(); });
+        });
+
+        runScenario("piano_autoplay", AppState::timbrePiano, 2, 1.5, 4.0, [](OfflineSession& s)
+        {
+            s.state.playback.bpm = 120.0;
+            s.state.playback.noteDuration = 80.0f;
+            s.at(0.0, [](OfflineSession& x) { x.startAutoPlay(); x.playNextNote(); });
+        });
+
+        runScenario("center_tone", AppState::timbreSine, 3, 1.5, 2.0, [](OfflineSession& s)
+        {
+            // 只激活 C、E、G，并以 C 为中心音：中心音与随机音交替出现
+            for (int i = 0; i < 12; ++i)
+                s.state.interaction.customSemitones.set(i, i == 0 || i == 4 || i == 7);
+            s.state.interaction.longPressedButtonIndex = 0;
+            s.state.interaction.shouldPlayCenterNote = true;
+            s.state.playback.bpm = 180.0;
+            s.state.playback.noteDuration = 70.0f;
+            s.at(0.0, [](OfflineSession& x) { x.startAutoPlay(); x.playNextNote(); });
+        });
+
+        runScenario("timbre_switch_mid_note", AppState::timbrePiano, 4, 1.25, 4.0, [](OfflineSession& s)
+        {
+            s.state.playback.bpm = 60.0;
+            s.state.playback.noteDuration = 100.0f;
+            s.at(0.0,   [](OfflineSession& x) { x.playNextNote(); });
+            s.at(300.0, [](OfflineSession& x) { x.audio->switchTimbre(AppState::timbreSine); });
+            s.at(800.0, [](OfflineSession& x) { x.playNextNote(); });
+        });
+
+        runScenario("chord_exercise", AppState::timbreSine, 6, 1.5, 4.0, [](OfflineSession& s)
+        {
+            // 七和弦练习：和声与旋律方式交替，音符按样本偏移在块内开始
+            s.playback->setExerciseMode(3);
+            s.state.playback.bpm = 120.0;
+            s.state.playback.noteDuration = 90.0f;
+            s.at(0.0,   [](OfflineSession& x) { x.startAutoPlay(); x.playNextNote(); });
+            s.at(700.0, [](OfflineSession& x) { x.playback->setExerciseStyle(1); });
+        });
+
+        runScenario("voice_stealing", AppState::timbrePiano, 7, 1.5, 4.0, [](OfflineSession& s)
+        {
+            // 三和弦 + 释音尾巴在 4 个 Voice 上持续抢占：被抢占的音符快速释放，不应出现爆音
+            s.playback->setExerciseMode(2);
+            s.audio->setPolyphony(4);
+            s.state.playback.bpm = 200.0;
+            s.state.playback.noteDuration = 100.0f;
+            s.at(0.0, [](OfflineSession& x) { x.startAutoPlay(); x.playNextNote(); });
+        });
+
+        runScenario("wavetable_timbres", AppState::timbreSaw, 8, 1.5, 4.0, [](OfflineSession& s)
+        {
+            // 锯齿波自动播放（含高音区，检验带限波表级别选择），中途切换到风琴波表
+            s.state.playback.bpm = 160.0;
+            s.state.playback.noteDuration = 80.0f;
+            s.at(0.0,   [](OfflineSession& x) { x.startAutoPlay(); x.playNextNote(); });
+            s.at(700.0, [](OfflineSession& x) { x.audio->switchTimbre(AppState::timbreOrgan); });
+        });
+
+        runScenario("additive_partials", AppState::timbreAdditive, 9, 1.5, 4.0, [](OfflineSession& s)
+        {
+            // 默认分音表下自动播放，中途换成突出第 5 次谐波且不衰减的分音表（从下一个音符起生效）
+            s.state.playback.bpm = 120.0;
+            s.state.playback.noteDuration = 80.0f;
+            s.at(0.0, [](OfflineSession& x) { x.startAutoPlay(); x.playNextNote(); });
+            s.at(600.0, [](OfflineSession& x)
+            {
+                AdditiveSound::Profile profile;
+                profile.numPartials = 8;
+                for (int i = 0; i < profile.numPartials; ++i)
+                    profile.amplitude[i] = i == 4 ? 1.0f : 0.25f / (float) (i + 1);
+                x.audio->setPartialProfile(profile);
+                x.waitForLoudnessTables();
+            });
+        });
+
+        runScenario("string_model", AppState::timbreString, 10, 1.0, 4.0, [](OfflineSession& s)
+        {
+            // 弦模型自动播放，音符时值 80% 触发止音衰减
+            s.state.playback.bpm = 120.0;
+            s.state.playback.noteDuration = 80.0f;
+            s.at(0.0, [](OfflineSession& x) { x.startAutoPlay(); x.playNextNote(); });
+        });
+
+        runScenario("fdn_reverb", AppState::timbreSine, 11, 2.0, 4.0, [](OfflineSession& s)
+        {
+            // 两个短音后停止，FDN 混响尾音衰减到 -90 dB 以下后自动静音；中途调整房间大小与阻尼
+            s.audio->setReverbMix(0.6f);
+            s.audio->setReverbRoomSize(0.4f);
+            s.audio->setReverbDamping(0.3f);
+            s.state.playback.bpm = 120.0;
+            s.state.playback.noteDuration = 40.0f;
+            s.at(0.0,   [](OfflineSession& x) { x.playNextNote(); });
+            s.at(500.0, [](OfflineSession& x)
+            {
+                x.audio->setReverbRoomSize(0.7f);
+                x.audio->setReverbDamping(0.7f);
+                x.playNextNote();
+            });
+        });
+
+        runScenario("volume_ramp", AppState::timbreSine, 5, 1.0, 2.0, [](OfflineSession& s)
+        {
+            // 单音持续发声，音量先升后降
+            for (int i = 0; i < 12; ++i)
+                s.state.interaction.customSemitones.set(i, i == 9);
+            s.state.playback.bpm = 60.0;
+            s.state.playback.noteDuration = 100.0f;
+            s.at(0.0, [](OfflineSession& x) { x.playNextNote(); });
+
+            const float levels[] = { 0.4f, 0.6f, 0.8f, 1.0f, 0.7f, 0.4f, 0.1f, 0.3f };
+            for (int i = 0; i < (int) std::size(levels); ++i)
+            {
+                const float level = levels[i];
+                s.at(100.0 * (i + 1), [level](OfflineSession& x) { x.audio->setMasterVolume(level); });
+            }
+        });
+
+        runScenario("device_44k", AppState::timbrePiano, 13, 1.5, 4.0, [](OfflineSession& s)
+        {
+            // 44.1 kHz 设备：引擎仍以 48 kHz 渲染，主总线最后一级转换；音高与音色应与 48 kHz 设备一致
+            const int notes[] = { 48, 60, 64, 67, 72, 84 };
+            for (int i = 0; i < (int) std::size(notes); ++i)
+            {
+                const int note = notes[i];
+                s.at(200.0 * i, [note](OfflineSession& x) { x.audio->playNote(note, 0.8f); });
+                s.at(200.0 * i + 600.0, [note](OfflineSession& x) { x.audio->stopNote(note); });
+            }
+        }, 44100.0);
+
+        runScenario("limiter_chords", AppState::timbreSaw, 12, 1.5, 4.0, [](OfflineSession& s)
+        {
+            // 满音量、满力度的锯齿波音簇叠加满湿声混响：总线峰值超过 0 dBFS，输出真峰值应被压到 -1 dBTP 以下
+            s.audio->setMasterVolume(1.0f);
+            s.audio->setReverbMix(1.0f);
+            s.audio->ensurePolyphony(12);
+            const int cluster[] = { 48, 52, 55, 58, 60, 62, 64, 67, 70, 72 };
+            for (int i = 0; i < (int) std::size(cluster); ++i)
+            {
+                const int note = cluster[i];
+                s.at(40.0 * i, [note](OfflineSession& x) { x.audio->playNote(note, 1.0f); });
+                s.at(700.0 + 40.0 * i, [note](OfflineSession& x) { x.audio->stopNote(note); });
+            }
+        }, GoldenRender::kSampleRate, AppState::pianoStorageFloat, [this](OfflineSession& s, const juce::AudioBuffer<float>& output)
+        {
+            // 独立的 4 倍过采样测量（与限幅器内部的插值滤波器不同），留少量容差
+            const float truePeakDb = measureTruePeakDb(output);
+            logMessage("limiter_chords: true peak " + juce::String(truePeakDb, 2) + " dBTP, max reduction "
+                       + juce::String(s.audio->getLimiterStats().maxReductionDb, 2) + " dB");
+            expect(truePeakDb <= TruePeakLimiter::CEILING_DB + kTruePeakToleranceDb,
+                   "true peak " + juce::String(truePeakDb, 2) + " dBTP exceeds the limiter ceiling");
+            expect(s.audio->getLimiterStats().maxReductionDb > 0.0f, "limiter did not engage on the cluster");
+        });
+
+        runScenario("piano_compressed", AppState::timbrePiano, 13, 1.5, 4.0, [](OfflineSession& s)
+        {
+            // 压缩存储的样本按块解码播放；和弦在 4 个 Voice 上抢占，快速释放接管读取窗口，新音符换用另一个读取器
+            s.playback->setExerciseMode(2);
+            s.audio->setPolyphony(4);
+            s.state.playback.bpm = 200.0;
+            s.state.playback.noteDuration = 100.0f;
+            s.at(0.0, [](OfflineSession& x) { x.startAutoPlay(); x.playNextNote(); });
+        }, GoldenRender::kSampleRate, AppState::pianoStorageCompressed);
+    }
+
+private:
+    static constexpr float kTolerance = 1.0e-3f; // 参考文件为 16 位，量化误差约 1.5e-5
+    static constexpr float kTruePeakToleranceDb = 0.1f;
+
+    using Check = std::function<void(GoldenRender::OfflineSession&, const juce::AudioBuffer<float>&)>;
+
+    // 4 倍过采样（两级半带 FIR）后取各声道的最大绝对值，单位 dBTP
+    static float measureTruePeakDb(const juce::AudioBuffer<float>& buffer)
+    {
+        juce::dsp::Oversampling<float> oversampling((size_t) buffer.getNumChannels(), 2,
+                                                    juce::dsp::Oversampling<float>::filterHalfBandFIREquiripple, true);
+        oversampling.initProcessing((size_t) buffer.getNumSamples());
+
+        juce::AudioBuffer<float> copy(buffer);
+        juce::dsp::AudioBlock<float> block(copy);
+        const auto upsampled = oversampling.processSamplesUp(block);
+
+        float peak = 0.0f;
+        for (size_t ch = 0; ch < upsampled.getNumChannels(); ++ch)
+            for (size_t i = 0; i < upsampled.getNumSamples(); ++i)
+                peak = juce::jmax(peak, std::abs(upsampled.getSample((int) ch, (int) i)));
+        return juce::Decibels::gainToDecibels(peak, -100.0f);
+    }
+
+    void runScenario(const juce::String& name, AppState::Timbre timbre, juce::int64 seed, double seconds,
+                     double cpuBudgetPercent, std::function<void(GoldenRender::OfflineSession&)> setup,
+                     double deviceSampleRate = GoldenRender::kSampleRate,
+                     AppState::PianoSampleStorage pianoStorage = AppState::pianoStorageFloat,
+                     Check check = {})
+    {
+        beginTest(name);
+
+        GoldenRender::OfflineSession session(timbre, seed, deviceSampleRate, pianoStorage);
+
+        // 无论何种音色都等待后台加载结束，避免加载线程干扰 CPU 计时
+        expect(session.waitForPianoSamples(), "piano samples did not load");
+
+        setup(session);
+        auto rendered = session.render(seconds);
+
+        expect(rendered.getMagnitude(0, rendered.getNumSamples()) > 0.0f, name + " rendered silence");
+
+        auto comparison = GoldenRender::compareWithGolden(rendered, name, kTolerance, deviceSampleRate);
+        logMessage(comparison.message);
+        expect(comparison.passed, comparison.message);
+
+        if (check)
+            check(session, rendered);
+
+        const double budgetSeconds = seconds * cpuBudgetPercent / 100.0 * GoldenRender::getBudgetScale();
+        logMessage(name + ": engine time " + juce::String(session.getEngineSeconds() * 1000.0, 2) + " ms, budget "
+                   + juce::String(budgetSeconds * 1000.0, 2) + " ms");
+        expect(session.getEngineSeconds() <= budgetSeconds,
+               name + " exceeded CPU budget: " + juce::String(session.getEngineSeconds() * 1000.0, 2) + " ms > "
+               + juce::String(budgetSeconds * 1000.0, 2) + " ms");
+    }
+};
+
+static GoldenRenderTests goldenRenderTests;
@@ -0,0 +1,47 @@
+#include "GoldenRender.h"
+
+/**
+ * 空闲快速路径测试
+ *
+ * 引擎进入空闲后，随渲染块传入的外部 MIDI 音符必须照常发声并使引擎退出空闲，不能被快速路径丢弃。
+ */
+class IdleRenderTests : public juce::UnitTest
+{
+public:
+    IdleRenderTests() : juce::UnitTest("Idle rendering", "Engine") {}
+
+    void runTest() override
+    {
+        checkMidiWakesIdleEngine("Sine", AppState::timbreSine);
+        checkMidiWakesIdleEngine("Wavetable", AppState::timbreSaw);
+    }
+
+private:
+    static constexpr int kEventOffset = 100;
+
+    void checkMidiWakesIdleEngine(const juce::String& name, AppState::Timbre timbre)
+    {
+        beginTest(name + ": MIDI in a block wakes the idle engine");
+
+        GoldenRender::OfflineSession session(timbre, 1);
+        session.render(0.2);
+        expect(session.audio->getIdleStats().idle, "engine did not become idle");
+
+        juce::AudioBuffer<float> block(2, GoldenRender::kBlockSize);
+        juce::MidiBuffer midi;
+        midi.addEvent(juce::MidiMessage::noteOn(1, 69, 0.8f), kEventOffset);
+        block.clear();
+        session.audio->renderNextBlock(block, midi, 0, block.getNumSamples());
+
+        // 事件之前静音，事件之后有输出
+        expectEquals(block.getMagnitude(0, 0, kEventOffset), 0.0f);
+        expect(block.getMagnitude(0, kEventOffset, block.getNumSamples() - kEventOffset) > 0.0f, "MIDI note was dropped");
+        expect(!session.audio->getIdleStats().idle, "engine stayed idle with a sounding note");
+
+        // 后续块（无 MIDI）继续发声
+        const auto tail = session.render(0.05);
+        expect(tail.getMagnitude(0, 0, tail.getNumSamples()) > 0.01f, "note was cut off after the first block");
+    }
+};
+
+static IdleRenderTests idleRenderTests;
@@ -0,0 +1,147 @@
+#include "GoldenRender.h"
+#include "InstrumentPack.h"
+
+/**
+ * 打包乐器文件测试
+ *
+ * 把自带的 SFZ 分别以两种载荷编码打包后打开：region 表与每个 region 的样本应与直接解析 SFZ、
+ * 解码样本文件的结果逐位一致；文件头损坏或载荷越界的打包文件必须打开失败。
+ */
+class InstrumentPackTests : public juce::UnitTest
+{
+public:
+    InstrumentPackTests() : juce::UnitTest("Instrument pack", "Engine") {}
+
+    void runTest() override
+    {
+        const auto sfzFile = GoldenRender::getBundledSFZFile();
+        if (!sfzFile.existsAsFile())
+        {
+            beginTest("Round trip");
+            logMessage("bundled SFZ not found, skipping instrument pack tests");
+            return;
+        }
+
+        const auto sfzRegions = PianoSound::parseSFZRegions(sfzFile);
+
+        checkRoundTrip(sfzFile, sfzRegions, InstrumentPack::encodingFloat32, "float32");
+        checkRoundTrip(sfzFile, sfzRegions, InstrumentPack::encodingFile, "file");
+        checkRejectsCorruptPacks(sfzFile);
+    }
+
+private:
+    // 文件头与 region 表项中各字段的字节偏移（见 InstrumentPack 的格式说明）
+    static constexpr int kMagicOffset = 0;
+    static constexpr int kDeclaredSizeOffset = 32;
+    static constexpr int kEntryPayloadOffset = 40;
+    static constexpr int kEntryPayloadBytes = 48;
+
+    void checkRoundTrip(const juce::File& sfzFile, const juce::Array<PianoSound::Region>& sfzRegions,
+                        InstrumentPack::Encoding encoding, const juce::String& name)
+    {
+        beginTest("Round trip (" + name + " payloads)");
+
+        juce::TemporaryFile packFile(InstrumentPack::FILE_EXTENSION);
+        juce::String error;
+        expect(InstrumentPack::write(sfzFile, packFile.getFile(), encoding, error), error);
+
+        auto pack = InstrumentPack::open(packFile.getFile());
+        expect(pack != nullptr, "could not open the written pack");
+        if (pack == nullptr)
+            return;
+
+        const auto& regions = pack->getRegions();
+        expectEquals(regions.size(), sfzRegions.size());
+        for (int i = 0; i < juce::jmin(regions.size(), sfzRegions.size()); ++i)
+        {
+            const auto& packed = regions.getReference(i);
+            const auto& original = sfzRegions.getReference(i);
+            expectEquals(packed.loKey, original.loKey);
+            expectEquals(packed.hiKey, original.hiKey);
+            expectEquals(packed.rootNote, original.rootNote);
+            expectEquals(packed.offset, original.offset);
+            expect(packed.sampleFile == packFile.getFile(), "region does not reference the pack");
+
+            double packedRate = 0.0, originalRate = 0.0;
+            const auto packedSamples = pack->loadRegionSamples(i, packedRate);
+            const auto originalSamples = PianoSound::loadSampleFile(original.sampleFile, originalRate);
+            expect(packedSamples != nullptr && originalSamples != nullptr, "region " + juce::String(i) + " did not load");
+            if (packedSamples == nullptr || originalSamples == nullptr)
+                continue;
+
+            expectEquals(packedRate, originalRate);
+            expect(isBitIdentical(*packedSamples, *originalSamples),
+                   "region " + juce::String(i) + " samples differ from " + original.sampleFile.getFileName());
+        }
+
+        double unusedRate = 0.0;
+        expect(pack->loadRegionSamples(regions.size(), unusedRate) == nullptr, "out-of-range region index returned samples");
+    }
+
+    void checkRejectsCorruptPacks(const juce::File& sfzFile)
+    {
+        beginTest("Corrupt packs are rejected");
+
+        juce::TemporaryFile packFile(InstrumentPack::FILE_EXTENSION);
+        juce::String error;
+        expect(InstrumentPack::write(sfzFile, packFile.getFile(), InstrumentPack::encodingFile, error), error);
+
+        juce::MemoryBlock original;
+        expect(packFile.getFile().loadFileAsData(original));
+        const auto fileSize = (juce::int64) original.getSize();
+
+        expectRejected(original, "bad magic", [](juce::MemoryBlock& data)
+        {
+            static_cast<char*>(data.getData())[kMagicOffset] = 'X';
+        });
+        expectRejected(original, "declared size mismatch", [fileSize](juce::MemoryBlock& data)
+        {
+            writeInt64(data, kDeclaredSizeOffset, fileSize + 1);
+        });
+        expectRejected(original, "truncated file", [](juce::MemoryBlock& data)
+        {
+            data.setSize((size_t) InstrumentPack::HEADER_SIZE - 1);
+        });
+        expectRejected(original, "payload past the end of the file", [fileSize](juce::MemoryBlock& data)
+        {
+            writeInt64(data, InstrumentPack::HEADER_SIZE + kEntryPayloadOffset, fileSize);
+        });
+        expectRejected(original, "payload length out of range", [fileSize](juce::MemoryBlock& data)
+        {
+            writeInt64(data, InstrumentPack::HEADER_SIZE + kEntryPayloadBytes, fileSize);
+        });
+        expectRejected(original, "payload inside the header", [](juce::MemoryBlock& data)
+        {
+            writeInt64(data, InstrumentPack::HEADER_SIZE + kEntryPayloadOffset, 0);
+        });
+    }
+
+    void expectRejected(const juce::MemoryBlock& original, const juce::String& name,
+                        const std::function<void(juce::MemoryBlock&)>& corrupt)
+    {
+        juce::MemoryBlock data(original);
+        corrupt(data);
+
+        juce::TemporaryFile corruptFile(InstrumentPack::FILE_EXTENSION);
+        expect(corruptFile.getFile().replaceWithData(data.getData(), data.getSize()));
+        expect(InstrumentPack::open(corruptFile.getFile()) == nullptr, name + ": corrupt pack was opened");
+    }
+
+    static void writeInt64(juce::MemoryBlock& data, int offset, juce::int64 value)
+    {
+        const auto littleEndian = juce::ByteOrder::swapIfBigEndian((juce::uint64) value);
+        data.copyFrom(&littleEndian, offset, sizeof(littleEndian));
+    }
+
+    static bool isBitIdentical(const juce::AudioBuffer<float>& a, const juce::AudioBuffer<float>& b)
+    {
+        if (a.getNumChannels() != b.getNumChannels() || a.getNumSamples() != b.getNumSamples())
+            return false;
+        for (int ch = 0; ch < a.getNumChannels(); ++ch)
+            if (std::memcmp(a.getReadPointer(ch), b.getReadPointer(ch), (size_t) a.getNumSamples() * sizeof(float)) != 0)
+                return false;
+        return true;
+    }
+};
+
+static InstrumentPackTests instrumentPackTests;
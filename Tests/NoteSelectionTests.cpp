@@ -0,0 +1,90 @@
+#include "GoldenRender.h"
+#include "AdaptiveNoteSelector.h"
+
+/**
+ * 自适应出题测试
+ *
+ * 上报的答题结果应改变对应格的统计与权重；别名表采样的经验频率应与权重成正比（固定种子，容差内）。
+ */
+class NoteSelectionTests : public juce::UnitTest
+{
+public:
+    NoteSelectionTests() : juce::UnitTest("Adaptive note selection", "Engine") {}
+
+    void runTest() override
+    {
+        beginTest("reportAnswerResult updates the selector");
+        {
+            GoldenRender::OfflineSession session(AppState::timbreSine, 1);
+            const auto& selector = session.playback->getNoteSelector();
+            const float uniform = selector.getWeight(0, 0);
+
+            // MIDI 61 = 半音 1（#C），第二个八度（PlaybackEngine::MIN_OCTAVE + 1）
+            for (int i = 0; i < 10; ++i)
+                expect(session.playback->reportAnswerResult(61, false));
+            expect(!session.playback->reportAnswerResult(30, false), "notes outside the practice range are rejected");
+
+            const auto stats = selector.getStats(1, 1);
+            expectEquals(stats.attempts, 10);
+            expectEquals(stats.misses, 10);
+            expect(selector.getWeight(1, 1) > uniform + 0.4f, "missed cell weight did not grow");
+            expectWithinAbsoluteError(selector.getWeight(1, 0), uniform, 1.0e-6f);
+
+            session.playback->resetNoteStatistics();
+            expectWithinAbsoluteError(selector.getWeight(1, 1), uniform, 1.0e-6f);
+        }
+
+        beginTest("Alias-table draws follow the weights");
+        {
+            AdaptiveNoteSelector selector;
+            for (int i = 0; i < 8; ++i)
+                selector.recordResult(1, 1, false);
+            selector.recordResult(7, 2, true);
+
+            checkDrawFrequencies(selector, -1);
+            checkDrawFrequencies(selector, 1);     // 排除被加权的半音：其余格按原权重重新归一化
+        }
+    }
+
+private:
+    static constexpr int kNumDraws = 200000;
+    static constexpr double kTolerance = 0.004;
+
+    void checkDrawFrequencies(AdaptiveNoteSelector& selector, int excludeSemitone)
+    {
+        constexpr int numCells = AdaptiveNoteSelector::NUM_CELLS;
+        const uint16_t mask = (uint16_t) ((1 << AdaptiveNoteSelector::NUM_SEMITONES) - 1);
+
+        double expected[numCells] = {};
+        double total = 0.0;
+        for (int s = 0; s < AdaptiveNoteSelector::NUM_SEMITONES; ++s)
+            for (int o = 0; o < AdaptiveNoteSelector::NUM_OCTAVES; ++o)
+                if (s != excludeSemitone)
+                    total += expected[s * AdaptiveNoteSelector::NUM_OCTAVES + o] = selector.getWeight(s, o);
+
+        int counts[numCells] = {};
+        SessionRandom random(12345);
+        for (int i = 0; i < kNumDraws; ++i)
+        {
+            int semitone = -1, octaveIndex = -1;
+            if (!selector.selectCell(mask, excludeSemitone, random, semitone, octaveIndex))
+            {
+                expect(false, "selectCell returned no table");
+                return;
+            }
+            ++counts[semitone * AdaptiveNoteSelector::NUM_OCTAVES + octaveIndex];
+        }
+
+        double maxDeviation = 0.0;
+        for (int cell = 0; cell < numCells; ++cell)
+            maxDeviation = juce::jmax(maxDeviation, std::abs((double) counts[cell] / kNumDraws - expected[cell] / total));
+        logMessage("exclude " + juce::String(excludeSemitone) + ": max frequency deviation " + juce::String(maxDeviation, 5));
+        expect(maxDeviation < kTolerance, "draw frequencies deviate from the weights by " + juce::String(maxDeviation, 5));
+
+        if (excludeSemitone >= 0)
+            for (int o = 0; o < AdaptiveNoteSelector::NUM_OCTAVES; ++o)
+                expectEquals(counts[excludeSemitone * AdaptiveNoteSelector::NUM_OCTAVES + o], 0);
+    }
+};
+
+static NoteSelectionTests noteSelectionTests;
@@ -0,0 +1,86 @@
+#include "OscillatorBank.h"
+
+/**
+ * 正弦 Voice 组渲染测试
+ *
+ * Voice 组按发声情况在两种渲染方式间切换（满组整组并行、其余逐个 Voice 按时间展开），
+ * 两种方式的输出都应与逐样本的解析模型一致：定点相位的正弦 × 力度 × 音量 × 起音包络 × 释音包络。
+ * 块长不是 SIMD 步长的整数倍，覆盖按时间展开时的末尾填充与片段切分。
+ */
+class OscillatorBankTests : public juce::UnitTest
+{
+public:
+    OscillatorBankTests() : juce::UnitTest("Oscillator bank", "Engine") {}
+
+    void runTest() override
+    {
+        checkMatchesModel("One voice (time-unrolled)", { 57 });
+        checkMatchesModel("Three voices in one group", { 57, 61, 64 });
+        checkMatchesModel("A full group", { 57, 61, 64, 69 });
+        checkMatchesModel("A full group and a partial group", { 45, 57, 61, 64, 69, 76 });
+    }
+
+private:
+    static constexpr double kSampleRate = 48000.0;
+    static constexpr int kBlockSize = 300;
+    static constexpr int kReleaseBlock = 12;        // 在该块开始时松开所有音符
+    static constexpr int kNumBlocks = 40;
+    static constexpr float kVelocity = 0.8f;
+    static constexpr float kVolume = 0.2f;
+
+    void checkMatchesModel(const juce::String& name, std::initializer_list<int> notes)
+    {
+        beginTest(name);
+
+        OscillatorBank bank;
+        bank.prepare(kSampleRate);
+        bank.setPolyphony(OscillatorBank::MAX_VOICES);
+        bank.setVolume(kVolume);
+        for (int note : notes)
+            bank.noteOn(note, kVelocity);
+
+        juce::AudioBuffer<float> buffer(2, kBlockSize);
+        juce::MidiBuffer midi;
+        const int releaseSample = kReleaseBlock * kBlockSize;
+        float maxError = 0.0f;
+
+        for (int b = 0; b < kNumBlocks; ++b)
+        {
+            if (b == kReleaseBlock)
+                bank.allNotesOff(true);
+
+            buffer.clear();
+            bank.renderNextBlock(buffer, midi, 0, kBlockSize);
+
+            for (int i = 0; i < kBlockSize; ++i)
+            {
+                const int n = b * kBlockSize + i;
+                double expected = 0.0;
+                for (int note : notes)
+                    expected += modelSample(note, n, releaseSample);
+
+                maxError = juce::jmax(maxError, std::abs(buffer.getSample(0, i) - (float) expected));
+                expectEquals(buffer.getSample(1, i), buffer.getSample(0, i));
+            }
+        }
+
+        expect(maxError < 2.0e-5f, "max deviation from the model " + juce::String(maxError, 7));
+        expectEquals(bank.getNumActiveVoices(), 0);
+    }
+
+    // 与 OscillatorBank 相同的定点相位、线性起音与每样本指数释音
+    static double modelSample(int note, int n, int releaseSample)
+    {
+        const double cycles = juce::MidiMessage::getMidiNoteInHertz(note) / kSampleRate;
+        const auto increment = (uint64_t) std::llround(cycles * 4294967296.0);
+        const auto phase = (uint32_t) (increment * (uint64_t) n);
+        const double attack = juce::jmin(1.0, n / (double) (int) (0.01 * kSampleRate));
+        const double release = n < releaseSample ? 1.0 : std::pow(0.995, n - releaseSample + 1);
+        if (release < 0.01)
+            return 0.0;
+
+        return std::sin(phase * juce::MathConstants<double>::twoPi / 4294967296.0) * kVelocity * kVolume * attack * release;
+    }
+};
+
+static OscillatorBankTests oscillatorBankTests;
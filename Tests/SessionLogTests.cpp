@@ -0,0 +1,123 @@
+#include <juce_core/juce_core.h>
+#include "SessionLog.h"
+
+/**
+ * 会话日志测试
+ *
+ * 在临时目录中记录一个会话后读回文件：文件头、记录数与各字段应与写入一致；
+ * 作答的增量统计（半音正确率、混淆矩阵、BPM 分档）与写入的作答一致；再次开始会话时轮换到新文件。
+ */
+class SessionLogTests : public juce::UnitTest
+{
+public:
+    SessionLogTests() : juce::UnitTest("Session log", "Engine") {}
+
+    void runTest() override
+    {
+        beginTest("Records round-trip through the log file");
+
+        const auto directory = juce::File::getSpecialLocation(juce::File::tempDirectory)
+                                   .getNonexistentChildFile("earx_session_log_test", {}, false);
+
+        SessionLog log;
+        expect(log.startSession(directory, 0x1234abcdull, 48000.0));
+        expect(log.isActive());
+        const auto firstFile = log.getCurrentFile();
+
+        log.logNoteOn(60, 0, 120.0, 1000.0, 48000);
+        log.logAnswer(60, 0, 0, true, 350.0f, 120.0, 1400.0);
+        log.logParameterChange(SessionLog::parameterBpm, 90.0f, 90.0, 1500.0);
+        log.logNoteOn(64, 4, 90.0, 2000.0, 96000);
+        log.logAnswer(64, 4, 5, false, 500.0f, 90.0, 2600.0);
+        log.logAnswer(62, 2, 2, true, 250.0f, 95.0, 3000.0);
+        log.stopSession();
+        expect(!log.isActive());
+
+        juce::MemoryBlock data;
+        expect(firstFile.loadFileAsData(data), "log file was not written");
+        expect(data.getSize() >= sizeof(SessionLog::FileHeader));
+
+        SessionLog::FileHeader header;
+        std::memcpy(&header, data.getData(), sizeof(header));
+        expect(std::memcmp(header.magic, "EARXLOG", 8) == 0, "bad magic");
+        expectEquals((int) header.version, (int) SessionLog::FORMAT_VERSION);
+        expectEquals((int) header.recordSize, (int) sizeof(SessionLog::Record));
+        expect(header.seed == 0x1234abcdull, "seed mismatch");
+        expectEquals(header.sampleRate, 48000.0);
+
+        // 会话开始记录 + 2 个出题 + 3 个作答 + 1 个参数变化
+        expectEquals((int) ((data.getSize() - sizeof(header)) % sizeof(SessionLog::Record)), 0);
+        const int numRecords = (int) ((data.getSize() - sizeof(header)) / sizeof(SessionLog::Record));
+        expectEquals(numRecords, 7);
+        expectEquals((int) log.getNumRecordsWritten(), 7);
+
+        auto record = [&data](int index)
+        {
+            SessionLog::Record r;
+            std::memcpy(&r, static_cast<const char*>(data.getData()) + sizeof(SessionLog::FileHeader)
+                                + (size_t) index * sizeof(SessionLog::Record), sizeof(r));
+            return r;
+        };
+
+        expectEquals((int) record(0).type, (int) SessionLog::sessionStart);
+
+        const auto note = record(1);
+        expectEquals((int) note.type, (int) SessionLog::noteOn);
+        expectEquals((int) note.midiNote, 60);
+        expectEquals((int) note.semitone, 0);
+        expectEquals((int) note.bpm, 120);
+        expectEquals(note.timeMs, 1000.0);
+        expect(note.audioSample == 48000, "onset sample mismatch");
+
+        const auto answer = record(2);
+        expectEquals((int) answer.type, (int) SessionLog::answer);
+        expectEquals((int) answer.answer, 0);
+        expectEquals((int) (answer.flags & 1), 1);
+        expectEquals(answer.value, 350.0f);
+
+        const auto parameter = record(3);
+        expectEquals((int) parameter.type, (int) SessionLog::parameterChange);
+        expectEquals((int) parameter.answer, (int) SessionLog::parameterBpm);
+        expectEquals(parameter.value, 90.0f);
+
+        const auto wrong = record(5);
+        expectEquals((int) wrong.type, (int) SessionLog::answer);
+        expectEquals((int) wrong.semitone, 4);
+        expectEquals((int) wrong.answer, 5);
+        expectEquals((int) (wrong.flags & 1), 0);
+        expectEquals(wrong.value, 500.0f);
+
+        beginTest("Incremental statistics");
+
+        expectEquals(log.getSemitonePerformance(0).attempts, 1);
+        expectEquals(log.getSemitonePerformance(0).correct, 1);
+        expectEquals(log.getSemitonePerformance(4).attempts, 1);
+        expectEquals(log.getSemitonePerformance(4).correct, 0);
+        expectWithinAbsoluteError(log.getSemitonePerformance(4).getMeanReactionMs(), 500.0, 1.0e-6);
+        expectEquals(log.getConfusionCount(4, 5), 1);
+        expectEquals(log.getConfusionCount(4, 4), 0);
+        expectEquals(log.getConfusionCount(2, 2), 1);
+
+        // 90 与 95 BPM 同在一档，120 BPM 在另一档
+        const auto slow = log.getBpmPerformance(90.0);
+        expectEquals(slow.attempts, 2);
+        expectEquals(slow.correct, 1);
+        expectWithinAbsoluteError(slow.getMeanReactionMs(), 375.0, 1.0e-6);
+        expectEquals(log.getBpmPerformance(120.0).attempts, 1);
+        expectEquals(log.getBpmPerformance(150.0).attempts, 0);
+
+        beginTest("Starting a new session rotates the file");
+
+        expect(log.startSession(directory, 7, 44100.0));
+        const auto secondFile = log.getCurrentFile();
+        log.stopSession();
+        expect(secondFile != firstFile, "second session reused the first file");
+        expect(firstFile.existsAsFile() && secondFile.existsAsFile());
+        expectEquals(log.getSemitonePerformance(0).attempts, 0);
+        expectEquals((int) ((secondFile.getSize() - (juce::int64) sizeof(SessionLog::FileHeader)) / (juce::int64) sizeof(SessionLog::Record)), 1);
+
+        directory.deleteRecursively();
+    }
+};
+
+static SessionLogTests sessionLogTests;
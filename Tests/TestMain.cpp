@@ -0,0 +1,35 @@
+#include <juce_core/juce_core.h>
+#include "GoldenRender.h"
+
+/**
+ * earx_tests - 引擎回归测试入口
+ *
+ * 用法：
+ *   earx_tests [--update-golden] [--category=<分类>]
+ *
+ * --update-golden 会用当前渲染结果覆盖 Tests/golden 下的参考文件，
+ * 仅在有意改变音频输出（并已人工试听确认）时使用。
+ */
+int main(int argc, char* argv[])
+{
+    juce::ArgumentList args(argc, argv);
+
+    GoldenRender::updateGoldenFiles = args.containsOption("--update-golden")
+                                   || juce::SystemStats::getEnvironmentVariable("EARX_UPDATE_GOLDEN", {}).getIntValue() != 0;
+
+    juce::UnitTestRunner runner;
+    runner.setAssertOnFailure(false);
+
+    auto category = args.getValueForOption("--category");
+    if (category.isNotEmpty())
+        runner.runTestsInCategory(category);
+    else
+        runner.runAllTests();
+
+    int failures = 0;
+    for (int i = 0; i < runner.getNumResults(); ++i)
+        if (auto* result = runner.getResult(i))
+            failures += result->failures;
+
+    return failures > 0 ? 1 : 0;
+}
@@ -0,0 +1,127 @@
+#include "GoldenRender.h"
+#include "EarxSynthesiser.h"
+#include "OscillatorBank.h"
+#include "AdditiveSound.h"
+#include "AdditiveVoice.h"
+#include "PianoSound.h"
+#include "PianoVoice.h"
+#include "StringModelSound.h"
+#include "StringModelVoice.h"
+#include "WavetableSound.h"
+#include "WavetableVoice.h"
+
+/**
+ * Voice 抢占测试
+ *
+ * 满员（或只剩一个空闲 Voice）时在同一块内连续触发一组和弦：被抢占的应是之前按住的音，
+ * 和弦的每个音都必须保留下来，不能因为刚起音的 Voice 电平尚未更新而互相抢占。
+ */
+class VoiceStealingTests : public juce::UnitTest
+{
+public:
+    VoiceStealingTests() : juce::UnitTest("Voice stealing", "Engine") {}
+
+    void runTest() override
+    {
+        juce::SynthesiserSound::Ptr wavetable(new WavetableSound());
+        juce::SynthesiserSound::Ptr additive(new AdditiveSound());
+        juce::SynthesiserSound::Ptr string(new StringModelSound());
+        auto* pianoSound = new PianoSound();
+        juce::SynthesiserSound::Ptr piano(pianoSound);
+        pianoSound->loadSFZ(GoldenRender::getBundledSFZFile());
+
+        checkChordSurvives<WavetableVoice>("Wavetable", wavetable.get());
+        checkChordSurvives<AdditiveVoice>("Additive", additive.get());
+        checkChordSurvives<StringModelVoice>("String model", string.get());
+        if (pianoSound->isLoaded())
+            checkChordSurvives<PianoVoice>("Piano", piano.get());
+        else
+            logMessage("piano samples not found, skipping piano voices");
+
+        checkOscillatorBankChord();
+    }
+
+private:
+    static constexpr int kNumVoices = 4;
+    static constexpr int kBlockSize = 256;
+
+    template <typename VoiceType>
+    void checkChordSurvives(const juce::String& name, juce::SynthesiserSound* sound)
+    {
+        const int held[] = { 60, 62, 64 };
+        const int chord[] = { 70, 74, 77 };
+
+        // 三个按住的音 + 一个空闲 Voice；以及四个按住的音（满员）
+        for (int numHeld : { 3, 4 })
+        {
+            beginTest(name + ": chord into " + juce::String(numHeld) + " held notes");
+
+            EarxSynthesiser synth;
+            synth.setCurrentPlaybackSampleRate(GoldenRender::kSampleRate);
+            synth.addSound(sound);
+            for (int i = 0; i < kNumVoices; ++i)
+                synth.addVoice(new VoiceType());
+
+            juce::AudioBuffer<float> buffer(2, kBlockSize);
+            juce::MidiBuffer midi;
+            for (int i = 0; i < numHeld; ++i)
+                synth.noteOn(1, i < 3 ? held[i] : 65, 0.8f);
+            for (int b = 0; b < 8; ++b)
+            {
+                buffer.clear();
+                synth.renderNextBlock(buffer, midi, 0, kBlockSize);
+            }
+
+            // 和弦的三个音在同一块内触发，之间没有渲染
+            for (int note : chord)
+                synth.noteOn(1, note, 0.8f);
+
+            juce::StringArray sounding;
+            for (int i = 0; i < synth.getNumVoices(); ++i)
+                if (synth.getVoice(i)->isVoiceActive())
+                    sounding.add(juce::String(synth.getVoice(i)->getCurrentlyPlayingNote()));
+            logMessage("sounding: " + sounding.joinIntoString(" "));
+
+            for (int note : chord)
+                expect(sounding.contains(juce::String(note)), "chord note " + juce::String(note) + " was stolen");
+            expectEquals((int) synth.getNumVoicesStolen(), numHeld - 1);
+
+            synth.clearSounds();
+        }
+    }
+
+    void checkOscillatorBankChord()
+    {
+        beginTest("Oscillator bank: chord burst into a full pool");
+
+        OscillatorBank bank;
+        bank.prepare(GoldenRender::kSampleRate);
+        bank.setPolyphony(kNumVoices);
+
+        juce::AudioBuffer<float> buffer(2, kBlockSize);
+        juce::MidiBuffer midi;
+        for (int note : { 60, 62, 64, 65 })
+            midi.addEvent(juce::MidiMessage::noteOn(1, note, 0.8f), 0);
+        for (int b = 0; b < 8; ++b)
+        {
+            buffer.clear();
+            bank.renderNextBlock(buffer, midi, 0, kBlockSize);
+            midi.clear();
+        }
+
+        // 和弦的三个音在同一样本偏移触发
+        const int chord[] = { 70, 74, 77 };
+        for (int note : chord)
+            midi.addEvent(juce::MidiMessage::noteOn(1, note, 0.8f), 0);
+        buffer.clear();
+        bank.renderNextBlock(buffer, midi, 0, kBlockSize);
+
+        for (int note : chord)
+            expect(bank.isNoteActive(note), "chord note " + juce::String(note) + " was stolen");
+        expect(bank.isNoteActive(65), "the newest held note should survive");
+        expectEquals((int) bank.getNumVoicesStolen(), 3);
+        expectEquals(bank.getNumActiveVoices(), kNumVoices);
+    }
+};
+
+static VoiceStealingTests voiceStealingTests;
@@ -35,6 +35,9 @@ typedef _StopAllNotesDart = int Function();
 typedef _SetPianoModeC = Int32 Function(Int32 isPianoMode);
 typedef _SetPianoModeDart = int Function(int isPianoMode);
 
+typedef _SetTimbreC = Int32 Function(Int32 timbre);
+typedef _SetTimbreDart = int Function(int timbre);
+
 typedef _GetCurrentTimbreC = Int32 Function();
 typedef _GetCurrentTimbreDart = int Function();
 
@@ -125,6 +128,18 @@ typedef _GetSemitoneNoteNameDart = int Function(int semitone, int noteNameIndex)
 
 /// EarX音频引擎的Dart FFI封装
 /// 提供对JUCE音频引擎的高级接口
+/// 音色，顺序与 C 接口的 EarxTimbre 一致
+enum EarxTimbre {
+  sine,
+  piano,
+  saw,
+  square,
+  organ,
+  userWavetable,
+  additive,
+  string,
+}
+
 class AudioEngine {
   // UI notifier: reflects current timbre (true=piano, false=sine)
   static final ValueNotifier<bool> timbreIsPianoNotifier = ValueNotifier<bool>(false);
@@ -135,6 +150,7 @@ class AudioEngine {
   static final _stopNote = _dylib.lookupFunction<_StopNoteC, _StopNoteDart>('earx_stop_note');
   static final _stopAllNotes = _dylib.lookupFunction<_StopAllNotesC, _StopAllNotesDart>('earx_stop_all_notes');
   static final _setPianoMode = _dylib.lookupFunction<_SetPianoModeC, _SetPianoModeDart>('earx_set_piano_mode');
+  static final _setTimbre = _dylib.lookupFunction<_SetTimbreC, _SetTimbreDart>('earx_set_timbre');
   static final _getCurrentTimbre = _dylib.lookupFunction<_GetCurrentTimbreC, _GetCurrentTimbreDart>('earx_get_current_timbre');
   static final _setMasterVolume = _dylib.lookupFunction<_SetMasterVolumeC, _SetMasterVolumeDart>('earx_set_master_volume');
   static final _getMasterVolume = _dylib.lookupFunction<_GetMasterVolumeC, _GetMasterVolumeDart>('earx_get_master_volume');
@@ -267,6 +283,24 @@ class AudioEngine {
     return ok;
   }
 
+  /// 设置音色（切换时旧音色淡出，不会爆音）
+  static Future<bool> setTimbre(EarxTimbre timbre) async {
+    if (!isInitialized) return false;
+
+    final ok = _setTimbre(timbre.index) == 0;
+    if (ok) {
+      timbreIsPianoNotifier.value = timbre == EarxTimbre.piano;
+    }
+    return ok;
+  }
+
+  /// 获取当前音色，未初始化时为正弦
+  static EarxTimbre get currentTimbre {
+    if (!isInitialized) return EarxTimbre.sine;
+    final index = _getCurrentTimbre();
+    return index >= 0 && index < EarxTimbre.values.length ? EarxTimbre.values[index] : EarxTimbre.sine;
+  }
+
   /// 获取当前音色
   /// 返回 true=钢琴音色, false=正弦波音色
   static bool get isPianoMode {